@@ -31,352 +31,247 @@
 #include <string.h>
 #include <windows.h>   // For console specific functions
 
-#define ERR        -1
-#define TRUE        1
-#define FALSE       0
-#define LENGTH     50
-
-#define ESC     0x1B
-#define SPACE   ' '
-
-#define ROMSIZE  32*1024
+#include "equate.h"
+#include "extern.h"
+#include "dasmisa.h"
 
 // Global variables
 char* signon  = "M68HC05 Disassembler, V2.0\n";
 
-char argv_name[LENGTH+5];
-char inbuf[ROMSIZE+1];
-
-int fh,i,j,k,l;
-int bytesrd;
+OUTBUF outbuf;
 
 // Forward declaration of functions included in this code module:
 void DebugPrintBuffer(char *, int);
 void DebugStop(char*, int);
 
-typedef struct tag_68HC05INS {
-  char*  mneStr;
-} _6805MNEMONIC, *LP_6805MNEMONIC;
-
-// --------------------------------------------
-// Motorola M68HC05 Family Instruction mnemonic
-// --------------------------------------------
-// IMM Immediate addressing mode 
-//     ii = Immediate 8bit operand (# Immediate value)
-// INH Inherent addressing mode
-//     no operand
-// DIR Direct addressing mode
-//     dd = Direct 8bit address of operand
-// REL Relative addressing mode
-//     rr = relative 8bit offset of branch instruction 
-// EXT Extended addressing mode
-//     hh ll = High and low bytes of 16bit operand address 
-// IX  Indexed, no offset addressing mode
-//     no operand
-// IX1 Indexed, 8-bit offset addressing mode
-//     ff = byte offset in indexed, 8-bit offset addressing
-// IX2 Indexed, 16-bit offset addressing mode
-//     ee ff High and low bytes of offset in indexed, 16-bit offset addressing 
-// 
-_6805MNEMONIC mnemonic6805[] = {
-  // DIR-Addr-Mode: 3-Byte-Instr., op1={0..7}, op2={dd}, op3={rr}
-  {"\t\t 5~\tbrset\t0,$"}, // 00  {6,"BRSET",8,0x00},
-  {"\t\t 5~\tbrclr\t0,$"}, // 01  {6,"BRCLR",8,0x01},
-  {"\t\t 5~\tbrset\t1,$"}, // 02  {6,"BRSET",8,0x02},
-  {"\t\t 5~\tbrclr\t1,$"}, // 03  {6,"BRCLR",8,0x03},
-  {"\t\t 5~\tbrset\t2,$"}, // 04  {6,"BRSET",8,0x04},
-  {"\t\t 5~\tbrclr\t2,$"}, // 05  {6,"BRCLR",8,0x05},
-  {"\t\t 5~\tbrset\t3,$"}, // 06  {6,"BRSET",8,0x06},
-  {"\t\t 5~\tbrclr\t3,$"}, // 07  {6,"BRCLR",8,0x07},
-  {"\t\t 5~\tbrset\t4,$"}, // 08  {6,"BRSET",8,0x08},
-  {"\t\t 5~\tbrclr\t4,$"}, // 09  {6,"BRCLR",8,0x09},
-  {"\t\t 5~\tbrset\t5,$"}, // 0A  {6,"BRSET",8,0x0A},
-  {"\t\t 5~\tbrclr\t5,$"}, // 08  {6,"BRCLR",8,0x08},
-  {"\t\t 5~\tbrset\t6,$"}, // 0C  {6,"BRSET",8,0x0C},
-  {"\t\t 5~\tbrclr\t6,$"}, // 0D  {6,"BRCLR",8,0x0D},
-  {"\t\t 5~\tbrset\t7,$"}, // 0E  {6,"BRSET",8,0x0E},
-  {"\t\t 5~\tbrclr\t7,$"}, // 0F  {6,"BRCLR",8,0x0F},
-             
-  // DIR-Addr-Mode: 2-Byte-Instr., op1={0..7}, op2={dd}
-  {"\t 5~\tbset\t0,$"},    // 10  {5,"BSET",7,0x10},
-  {"\t 5~\tbclr\t0,$"},    // 11  {5,"BCLR",7,0x11},
-  {"\t 5~\tbset\t1,$"},    // 12  {5,"BSET",7,0x12},
-  {"\t 5~\tbclr\t1,$"},    // 13  {5,"BCLR",7,0x13},
-  {"\t 5~\tbset\t2,$"},    // 14  {5,"BSET",7,0x14},
-  {"\t 5~\tbclr\t2,$"},    // 15  {5,"BCLR",7,0x15},
-  {"\t 5~\tbset\t3,$"},    // 16  {5,"BSET",7,0x16},
-  {"\t 5~\tbclr\t3,$"},    // 17  {5,"BCLR",7,0x17},
-  {"\t 5~\tbset\t4,$"},    // 18  {5,"BSET",7,0x18},
-  {"\t 5~\tbclr\t4,$"},    // 19  {5,"BCLR",7,0x19},
-  {"\t 5~\tbset\t5,$"},    // 1A  {5,"BSET",7,0x1A},
-  {"\t 5~\tbclr\t5,$"},    // 18  {5,"BCLR",7,0x18},
-  {"\t 5~\tbset\t6,$"},    // 1C  {5,"BSET",7,0x1C},
-  {"\t 5~\tbclr\t6,$"},    // 1D  {5,"BCLR",7,0x1D},
-  {"\t 5~\tbset\t7,$"},    // 1E  {5,"BSET",7,0x1E},
-  {"\t 5~\tbclr\t7,$"},    // 1F  {5,"BCLR",7,0x1F},
-
-  // REL-Addr-Mode: 2-Byte-Instr., op1={rr}
-  {"\t 3~\tbra\t$"},       // 20  {4,"BRA", 3,0x20},
-  {"\t 3~\tbrn\t$"},       // 21  {4,"BRN", 3,0x21},
-  {"\t 3~\tbhi\t$"},       // 22  {4,"BHI", 3,0x22},
-  {"\t 3~\tbls\t$"},       // 23  {4,"BLS", 3,0x23},
-  {"\t 3~\tbcc\t$"},       // 24  {4,"BCC", 3,0x24},  {4,"BHS"}, 3,0x24}, // same as BCC
-  {"\t 3~\tbcs\t$"},       // 25  {4,"BCS", 3,0x25},  {4,"BLO"}, 3,0x25}, // same as BCS
-  {"\t 3~\tbne\t$"},       // 26  {4,"BNE", 3,0x26},
-  {"\t 3~\tbeq\t$"},       // 27  {4,"BEQ", 3,0x27},
-  {"\t 3~\tbhcc\t$"},      // 28  {5,"BHCC",3,0x28},
-  {"\t 3~\tbhcs\t$"},      // 29  {5,"BHCS",3,0x29},
-  {"\t 3~\tbpl\t$"},       // 2A  {4,"BPL", 3,0x2A},
-  {"\t 3~\tbmi\t$"},       // 2B  {4,"BMI", 3,0x2B},
-  {"\t 3~\tbmc\t$"},       // 2C  {4,"BMC", 3,0x2C},
-  {"\t 3~\tbms\t$"},       // 2D  {4,"BMS", 3,0x2D},
-  {"\t 3~\tbil\t$"},       // 2E  {4,"BIL", 3,0x2E},
-  {"\t 3~\tbih\t$"},       // 2F  {4,"BIH", 3,0x2F},
-
-  // DIR-Addr-Mode: 2-Byte-Instr., op1={dd}
-  {"\t 5~\tneg\t$"},       // 30  {4,"NEG",4,0x30},
-  {" \t---"},              // 31
-  {" \t---"},              // 32
-  {"\t 5~\tcom\t$"},       // 33  {4,"COM",4,0x33},
-  {"\t 5~\tlsr\t$"},       // 34  {4,"LSR",4,0x34},
-  {" \t---"},              // 35
-  {"\t 5~\tror\t$"},       // 36  {4,"ROR",4,0x36},
-  {"\t 5~\tasr\t$"},       // 37  {4,"ASR",4,0x37},
-  {"\t 5~\tlsl\t$"},       // 38  {4,"LSL",4,0x38},   {4,"ASL",4,0x38}, // same as LSL
-  {"\t 5~\trol\t$"},       // 39  {4,"ROL",4,0x39},
-  {"\t 5~\tdec\t$"},       // 3A  {4,"DEC",4,0x3A},
-  {" \t---"},              // 3B
-  {"\t 5~\tinc\t$"},       // 3C  {4,"INC",4,0x3C},
-  {"\t 4~\ttst\t$"},       // 3D  {4,"TST",4,0x3D},
-  {" \t---"},              // 3E
-  {"\t 5~\tclr\t$"},       // 3F  {4,"CLR",4,0x3F},
-
-  // INH-Addr-Mode: 1-Byte-Instr., no operands
-  {" 3~\tnega"},           // 40  {5,"NEGA",2,0x40},
-  {" \t---"},              // 41
-  {"11~\tmul"},            // 42  {4,"MUL"},2,0x42},
-  {" 3~\tcoma"},           // 43  {5,"COMA",2,0x43},
-  {" 3~\tlsra"},           // 44  {5,"LSRA",2,0x44},
-  {" \t---"},              // 45
-  {" 3~\trora"},           // 46  {5,"RORA",2,0x46},  
-  {" 3~\tasra"},           // 47  {5,"ASRA",2,0x47},
-  {" 3~\tlsla"},           // 48  {5,"LSLA",2,0x48},  {5,"ASLA",2,0x48},  // same as LSLA
-  {" 3~\trola"},           // 49  {5,"ROLA",2,0x49},
-  {" 3~\tdeca"},           // 4A  {5,"DECA",2,0x4A},
-  {" \t---"},              // 4B  
-  {" 3~\tinca"},           // 4C  {5,"INCA",2,0x4C},
-  {" 3~\ttsta"},           // 4D  {5,"TSTA",2,0x4D},
-  {" \t---"},              // 4E  
-  {" 3~\tclra"},           // 4F  {5,"CLRA",2,0x4F},
-
-  // INH-Addr-Mode: 1-Byte-Inst., no operands
-  {" 3~\tnegx"},           // 50  {5,"NEGX",2,0x50},
-  {" \t---"},              // 51
-  {" \t---"},              // 52  
-  {" 3~\tcomx"},           // 53  {5,"COMX",2,0x53},
-  {" 3~\tlsrx"},           // 54  {5,"LSRX",2,0x54},
-  {" \t---"},              // 55
-  {" 3~\trorx"},           // 56  {5,"RORX",2,0x56},                          
-  {" 3~\tasrx"},           // 57  {5,"ASRX",2,0x57},
-  {" 3~\tlslx"},           // 58  {5,"LSLX",2,0x58},  {5,"ASLX",2,0x58},  // same as LSLX
-  {" 3~\trolx"},           // 59  {5,"ROLX",2,0x59},
-  {" 3~\tdecx"},           // 5A  {5,"DECX",2,0x5A},
-  {" \t---"},              // 5B  
-  {" 3~\tincx"},           // 5C  {5,"INCX",2,0x5C},
-  {" 3~\ttstx"},           // 5D  {5,"TSTX",2,0x5D},
-  {" \t---"},              // 5E  
-  {" 3~\tclrx"},           // 5F  {5,"CLRX",2,0x5F},
-  
-  // IX1-Addr-Mode: 2-Byte-Instr., op1={ff}, op2={X}
-  {"\t 6~\tneg\t$"},       // 60  {4,"NEG",4,0x60},
-  {" \t---"},              // 61
-  {" \t---"},              // 62
-  {"\t 6~\tcom\t$"},       // 63  {4,"COM",4,0x62},
-  {"\t 6~\tlsr\t$"},       // 64  {4,"LSR",4,0x64},
-  {" \t---"},              // 65
-  {"\t 6~\tror\t$"},       // 66  {4,"ROR",4,0x66},
-  {"\t 6~\tasr\t$"},       // 67  {4,"ASR",4,0x67},
-  {"\t 6~\tlsl\t$"},       // 68  {4,"LSL",4,0x68},   {4,"ASL",4,0x68}, // same as LSL
-  {"\t 6~\trol\t$"},       // 69  {4,"ROL",4,0x69},
-  {"\t 6~\tdec\t$"},       // 6A  {4,"DEC",4,0x6A},
-  {" \t---"},              // 6B
-  {"\t 6~\tinc\t$"},       // 6C  {4,"INC",4,0x6C},
-  {"\t 5~\ttst\t$"},       // 6D  {4,"TST",4,0x6D},
-  {" \t---"},              // 6E
-  {"\t 6~\tclr\t$"},       // 6F  {4,"CLR",4,0x6F},
-
-  // IX-Addr-Mode: 1-Byte-Instr., no operands
-  {" 5~\tneg\t,x"},       // 70 {4,"NEG",4,0x70},
-  {" \t---"},             // 71
-  {" \t---"},             // 72
-  {" 5~\tcom\t,x"},       // 73 {4,"COM",4,0x73},
-  {" 5~\tlsr\t,x"},       // 74 {4,"LSR",4,0x74},
-  {" \t---"},             // 75
-  {" 5~\tror\t,x"},       // 76 {4,"ROR",4,0x76},
-  {" 5~\tasr\t,x"},       // 77 {4,"ASR",4,0x77},
-  {" 5~\tlsl\t,x"},       // 78 {4,"LSL",4,0x78},   {4,"ASL",4,0x78}, // same as LSL
-  {" 5~\trol\t,x"},       // 79 {4,"ROL",4,0x79},
-  {" 5~\tdec\t,x"},       // 7A {4,"DEC",4,0x7A},
-  {" \t---"},             // 7B
-  {" 5~\tinc\t,x"},       // 7C {4,"INC",4,0x7C},
-  {" 4~\ttst\t,x"},       // 7D {4,"TST",4,0x7D},
-  {" \t---"},             // 7E
-  {" 5~\tclr\t,x"},       // 7F {4,"CLR",4,0x7F},
-
-  // INH-Addr-Mode: 1-Byte-Inst., no operands
-  {" 9~\trti"},            // 80  {4,"RTI"}, 2,0x80},
-  {" 6~\trts"},            // 81  {4,"RTS"}, 2,0x81},
-  {" \t---"},              // 82
-  {"10~\tswi"},            // 83  {4,"SWI"}, 2,0x83},
-  {" \t---"},              // 84
-  {" \t---"},              // 85
-  {" \t---"},              // 86
-  {" \t---"},              // 87
-  {" \t---"},              // 88
-  {" \t---"},              // 89
-  {" \t---"},              // 8A
-  {" \t---"},              // 8B
-  {" \t---"},              // 8C
-  {" \t---"},              // 8D
-  {" 2~\tstop"},           // 8E  {5,"STOP",2,0x8E},
-  {" 2~\twait"},           // 8F  {5,"WAIT",2,0x8F},
-  
-  // INH-Addr-Mode: 1-Byte-Inst., no operands
-  {" \t---"},              // 90
-  {" \t---"},              // 91
-  {" \t---"},              // 92
-  {" \t---"},              // 93
-  {" \t---"},              // 94
-  {" \t---"},              // 95
-  {" \t---"},              // 96
-  {" 2~\ttax"},            // 97  {4,"TAX", 2,0x97},
-  {" 2~\tclc"},            // 98  {4,"CLC", 2,0x98},
-  {" 2~\tsec"},            // 99  {4,"SEC", 2,0x99},
-  {" 2~\tcli"},            // 9A  {4,"CLI", 2,0x9A},
-  {" 2~\tsei"},            // 9B  {4,"SEI", 2,0x9B},
-  {" 2~\trsp"},            // 9C  {4,"RSP", 2,0x9C},
-  {" 2~\tnop"},            // 9D  {4,"NOP", 2,0x9D},
-  {" \t---"},              // 9E  
-  {" 2~\ttxa"},            // 9F  {4,"TXA", 2,0x9F},
-             
-  // IMM-Addr-Mode: 2-Byte-Instr. op1={#ii}
-  {"\t 2~\tsub\t#$"},      // A0  {4,"SUB",6,0xA0},
-  {"\t 2~\tcmp\t#$"},      // A1  {4,"CMP",6,0xA1},
-  {"\t 2~\tcpx\t#$"},      // A2  {4,"CPX",6,0xA3},
-  {"\t 2~\tsbc\t#$"},      // A3  {4,"SBC",6,0xA2},
-  {"\t 2~\tand\t#$"},      // A4  {4,"AND",6,0xA4},
-  {"\t 2~\tbit\t#$"},      // A5  {4,"BIT",6,0xA5},
-  {"\t 2~\tlda\t#$"},      // A6  {4,"LDA",6,0xA6},
-  {" \t---"},              // A7  "STA" no #-mode 
-  {"\t 2~\teor\t#$"},      // A8  {4,"EOR",6,0xA8},
-  {"\t 2~\tadc\t#$"},      // A9  {4,"ADC",6,0xA9},
-  {"\t 2~\tora\t#$"},      // AA  {4,"ORA",6,0xAA},
-  {"\t 2~\tadd\t#$"},      // AB  {4,"ADD",6,0xAB},
-  {" \t---"},              // AC  "JSR" no #-mode
-  // REL-Addr-mode: 2-Byte-Instr., op1={rr}
-  {"\t 6~\tbsr\t$"},       // AD  {4,"BSR",3,0xAD},
-  // IMM-Addr-mode: 2-Byte-Instr. op1={#ii}
-  {"\t 2~\tldx\t#$"},      // AE  {4,"LDX",6,0xAE},
-  {" \t---"},              // AF  "STX" no #-mode
-  
-   // DIR-Addr-Mode: 2-Byte-Instr., op1={dd}, op2={rr}
-  {"\t 3~\tsub\t$"},       // B0  {4,"SUB",6,0xB0},
-  {"\t 3~\tcmp\t$"},       // B1  {4,"CMP",6,0xB1},
-  {"\t 3~\tsbc\t$"},       // B2  {4,"SBC",6,0xB2},
-  {"\t 3~\tcpx\t$"},       // B3  {4,"CPX",6,0xB3},
-  {"\t 3~\tand\t$"},       // B4  {4,"AND",6,0xB4},
-  {"\t 3~\tbit\t$"},       // B5  {4,"BIT",6,0xB5},
-  {"\t 3~\tlda\t$"},       // B6  {4,"LDA",6,0xB6},
-  {"\t 4~\tsta\t$"},       // B7  {4,"STA",5,0xB7}, 
-  {"\t 3~\teor\t$"},       // B8  {4,"EOR",6,0xB8},
-  {"\t 3~\tadc\t$"},       // B9  {4,"ADC",6,0xB9},
-  {"\t 3~\tora\t$"},       // BA  {4,"ORA",6,0xBA},
-  {"\t 3~\tadd\t$"},       // BB  {4,"ADD",6,0xBB},
-  {"\t 2~\tjmp\t$"},       // BC  {4,"JMP",5,0xBC}, 
-  {"\t 5~\tjsr\t$"},       // BE  {4,"JSR",5,0xBD},
-  {"\t 3~\tldx\t$"},       // BD  {4,"LDX",6,0xBE},
-  {"\t 4~\tstx\t$"},       // BF  {4,"STX",5,0xBF},
-  
-  // EXT-Addr-Mode: 3-Byte-Instr., op1={hh}, op2={ll}
-  {"\t\t 4~\tsub\t$"},     // C0  {4,"SUB",6,0xC0},
-  {"\t\t 4~\tcmp\t$"},     // C1  {4,"CMP",6,0xC1},
-  {"\t\t 4~\tsbc\t$"},     // C2  {4,"SBC",6,0xC2},
-  {"\t\t 4~\tcpx\t$"},     // C3  {4,"CPX",6,0xC3},
-  {"\t\t 4~\tand\t$"},     // C4  {4,"AND",6,0xC4},
-  {"\t\t 4~\tbit\t$"},     // C5  {4,"BIT",6,0xC5},
-  {"\t\t 4~\tlda\t$"},     // C6  {4,"LDA",6,0xC6},
-  {"\t\t 5~\tsta\t$"},     // C7  {4,"STA",5,0xC7}, 
-  {"\t\t 4~\teor\t$"},     // C8  {4,"EOR",6,0xC8},
-  {"\t\t 4~\tadc\t$"},     // C9  {4,"ADC",6,0xC9},
-  {"\t\t 4~\tora\t$"},     // CA  {4,"ORA",6,0xCA},
-  {"\t\t 4~\tadd\t$"},     // CB  {4,"ADD",6,0xCB},
-  {"\t\t 3~\tjmp\t$"},     // CC  {4,"JMP",5,0xCC}, 
-  {"\t\t 6~\tjsr\t$"},     // CE  {4,"JSR",6,0xCD},
-  {"\t\t 4~\tldx\t$"},     // CD  {4,"LDX",3,0xCE},
-  {"\t\t 5~\tstx\t$"},     // CF  {4,"STX",5,0xCF},
-  
-  // IX2-Addr-Mode: 3-Byte-Instr., op1={ee}, op2={ff}
-  {"\t\t 5~\tsub\t$"},     // D0  {4,"SUB",6,0xD0},
-  {"\t\t 5~\tcmp\t$"},     // D1  {4,"CMP",6,0xD1},
-  {"\t\t 5~\tsbc\t$"},     // D2  {4,"SBC",6,0xD2},
-  {"\t\t 5~\tcpx\t$"},     // D3  {4,"CPX",6,0xD3},
-  {"\t\t 5~\tand\t$"},     // D4  {4,"AND",6,0xD4},
-  {"\t\t 5~\tbit\t$"},     // D5  {4,"BIT",6,0xD5},
-  {"\t\t 5~\tlda\t$"},     // D6  {4,"LDA",6,0xD6},
-  {"\t\t 6~\tsta\t$"},     // D7  {4,"STA",5,0xD7}, 
-  {"\t\t 5~\teor\t$"},     // D8  {4,"EOR",6,0xD8},
-  {"\t\t 5~\tadc\t$"},     // D9  {4,"ADC",6,0xD9},
-  {"\t\t 5~\tora\t$"},     // DA  {4,"ORA",6,0xDA},
-  {"\t\t 5~\tadd\t$"},     // DB  {4,"ADD",6,0xDB},
-  {"\t\t 4~\tjmp\t$"},     // DC  {4,"JMP",5,0xDC}, 
-  {"\t\t 7~\tjsr\t$"},     // DE  {4,"JSR",6,0xDD},
-  {"\t\t 5~\tldx\t$"},     // DD  {4,"LDX",3,0xDE},
-  {"\t\t 6~\tstx\t$"},     // DF  {4,"STX",5,0xDF},
-  
-  // IX1-Addr-Mode: 2-Byte-Instr., op1={ff}, op2={X}
-  {"\t 4~\tsub\t$"},       // E0  {4,"SUB",6,0xE0},
-  {"\t 4~\tcmp\t$"},       // E1  {4,"CMP",6,0xE1},
-  {"\t 4~\tsbc\t$"},       // E2  {4,"SBC",6,0xE2},
-  {"\t 4~\tcpx\t$"},       // E3  {4,"CPX",6,0xE3},
-  {"\t 4~\tand\t$"},       // E4  {4,"AND",6,0xE4},
-  {"\t 4~\tbit\t$"},       // E5  {4,"BIT",6,0xE5},
-  {"\t 4~\tlda\t$"},       // E6  {4,"LDA",6,0xE6},
-  {"\t 5~\tsta\t$"},       // E7  {4,"STA",5,0xE7}, 
-  {"\t 4~\teor\t$"},       // E8  {4,"EOR",6,0xE8},
-  {"\t 4~\tadc\t$"},       // E9  {4,"ADC",6,0xE9},
-  {"\t 4~\tora\t$"},       // EA  {4,"ORA",6,0xEA},
-  {"\t 4~\tadd\t$"},       // EB  {4,"ADD",6,0xEB},
-  {"\t 3~\tjmp\t$"},       // EC  {4,"JMP",5,0xEC}, 
-  {"\t 6~\tjsr\t$"},       // EE  {4,"JSR",6,0xED},
-  {"\t 4~\tldx\t$"},       // ED  {4,"LDX",3,0xEE},
-  {"\t 5~\tstx\t$"},       // EF  {4,"STX",5,0xEF},
-  
-  // IX-Addr-Mode: 1-Byte-Instr., no operands
-  {" 3~\tsub\t,x"},        // F0  {4,"SUB",6,0xF0},
-  {" 3~\tcmp\t,x"},        // F1  {4,"CMP",6,0xF1},
-  {" 3~\tsbc\t,x"},        // F2  {4,"SBC",6,0xF2},
-  {" 3~\tcpx\t,x"},        // F3  {4,"CPX",6,0xF3},
-  {" 3~\tand\t,x"},        // F4  {4,"AND",6,0xF4},
-  {" 3~\tbit\t,x"},        // F5  {4,"BIT",6,0xF5},
-  {" 3~\tlda\t,x"},        // F6  {4,"LDA",6,0xF6},
-  {" 4~\tsta\t,x"},        // F7  {4,"STA",5,0xF7}, 
-  {" 3~\teor\t,x"},        // F8  {4,"EOR",6,0xF8},
-  {" 3~\tadc\t,x"},        // F9  {4,"ADC",6,0xF9},
-  {" 3~\tora\t,x"},        // FA  {4,"ORA",6,0xFA},
-  {" 3~\tadd\t,x"},        // FB  {4,"ADD",6,0xFB},
-  {" 2~\tjmp\t,x"},        // FC  {4,"JMP",5,0xFC}, 
-  {" 5~\tjsr\t,x"},        // FE  {4,"JSR",6,0xFD},
-  {" 3~\tldx\t,x"},        // FD  {4,"LDX",3,0xFE},
-  {" 4~\tstx\t,x"},        // FF  {4,"STX",5,0xFF},
-  }; // //  end-of-table _mnemonic68O5[]
+//-----------------------------------------------------------------------------
+//
+//                          DasmRange
+//
+// Linear sweep disassembly of the image 'im' into 'ob', from address
+// 'pc' up to the first instruction at or beyond 'stop'. The image is
+// accessed window by window. An instruction never straddles a window,
+// only the end of the image or the start of a fill run or string of
+// ob->run (see DasmLine), which is listed as a whole (see DasmRun).
+// The gaps of a hex file are skipped, with an origin line after them.
+// Each instruction set (im->cpu) has its own instance of the sweep.
+//
+// Returns the address of the instruction following the range and
+// adds the number of source lines produced to *lines.
+//
+template<class ISA>
+static DWORD DasmSweep(IMAGE* im, OUTBUF* ob, DWORD pc, DWORD stop, int* lines)
+  {
+  const RUNENT* r = NULL;
+  DWORD end, lim, k = 0;
+
+  if (ob->sym) ob->cur = SymSeek(ob->sym, pc);
+  if (ob->run) k = RunSeek(ob->run, pc);
+  while (pc < stop)
+    {
+    end = im->base + im->len;
+    if (end < im->lim)                          // Keep a whole instruction in the window
+      end = (end > ISA::maxlen-1) ? end - (ISA::maxlen-1) : 0;
+
+    if (pc < im->base || pc >= end)
+      {
+      if (!ImageWindow(im, pc))
+        {
+        OutNote(ob, "Read error\n");
+        return im->size;
+        }
+      if (im->base > pc)                        // A gap of a hex file
+        {
+        if (im->base >= stop) return im->base;
+        pc = im->base;
+        *lines += DasmOrg(ob, pc);
+        }
+      continue;
+      }
+
+    if (end > stop) end = stop;
+    while (pc < end)
+      {
+      lim = im->base + im->len;
+      if (ob->run)
+        {
+        while (k < ob->run->count && ob->run->run[k].addr + ob->run->run[k].len <= pc) k++;
+        r = k < ob->run->count ? &ob->run->run[k] : NULL;
+        if (r && r->addr > pc)
+          {
+          if (r->addr < lim) lim = r->addr;     // Instruction up to the region
+          r = NULL;
+          }
+        else if (r && r->kind == RUN_TEXT && r->addr + r->len > lim)
+          {
+          if (!ImageWindow(im, pc))             // The whole string in the window
+            {
+            OutNote(ob, "Read error\n");
+            return im->size;
+            }
+          break;
+          }
+        }
+
+      if (ob->sym) *lines += DasmLabel(ob, pc);
+      if (r)
+        {
+        *lines += DasmRun(ob, r, &im->data[pc - im->base], pc, r->addr + r->len - pc);
+        pc = r->addr + r->len;
+        }
+      else
+        {
+        pc += DasmLine<ISA>(ob, &im->data[pc - im->base], pc, lim - pc);
+        (*lines)++;
+        }
+      }
+    } // end while
+
+  return pc;
+  } // DasmSweep
+
+DWORD DasmRange(IMAGE* im, OUTBUF* ob, DWORD pc, DWORD stop, int* lines)
+  {
+  return ISACALL(im->cpu, DasmSweep, (im, ob, pc, stop, lines));
+  } // DasmRange
+
+//-----------------------------------------------------------------------------
+//
+//                          DasmFile
+//
+// Complete listing of the binary file 'fname' into 'ob':
+// heading, disassembly and the trailing statistics lines.
+// Large images are split up with option -p (see DasmImagePar),
+// option -r follows the flow of control (see DasmImageFlow).
+// With option -l the targets are collected first and shown as labels,
+// option -f collapses the fill runs and strings (see RunScan).
+// Option -a notes the direct page accesses on the lines and lists
+// them after the listing (see dasmxref.cpp). Option -n names the
+// known library functions (see dasmsig.cpp), option -i the I/O
+// registers of the derivative (see dasmreg.cpp). Option -u reports
+// the cycle budget of the routines after the listing (see dasmcyc.cpp).
+// With option -k unchanged parts are taken from the listing cache.
+// Option -m writes JSON lines or a record file (see dasmfmt.cpp) in
+// place of the listing text, with a serial sweep (no -p, -k).
+// S-record and Intel HEX files are listed range by range (no -p, -k).
+// The phases of the run are timed in ob->stats (--stats).
+//
+// Returns ERR if the file can't be opened.
+//
+int DasmFile(const char* fname, OUTBUF* ob, const DASMOPT* opt)
+  {
+  char name[MAX_PATH+1], line[MAX_PATH+64];
+  IMAGE image;
+  SYMTAB sym;
+  RUNTAB runs;
+  FMTOUT fmt;
+  XREF xref;
+  int n;
+
+  // get the file name and convert to upper case chars
+  for (n=0; n<MAX_PATH && fname[n]; n++) name[n] = toupper(fname[n]);
+  name[n] = 0;    // ensure NUL at string end
+
+  // check and open input file
+  StatPhase(ob, STAT_LOAD);
+  if (ImageOpen(&image, fname) == ERR)
+    {
+    StatPhase(ob, STAT_NONE);
+    sprintf(line, "Open failed on %s\n", name);
+    if (opt->format) fputs(line, stderr);
+    else OutStr(ob, line);
+    return ERR;
+    }
+  image.cpu = opt->cpu;
+  ob->reg = opt->reg;
+  StatPhase(ob, STAT_DECODE);
+
+  if (opt->format) FmtInit(ob, &fmt, opt->format, image.nseg ? image.seg[0].start : 0, opt->cpu);
+  else
+    {
+    sprintf(line, "Disassembly of %s\n\n", name);
+    OutStr(ob, line);
+    }
+  n = 0;
+  if (opt->fill)                                // Pre-pass: fill runs, strings
+    {
+    RunScan(&image, &runs);
+    ob->run = &runs;
+    }
+  if (opt->labels)                              // Pass 1: the labels
+    {
+    SymCopy(&sym, opt->user);
+    if (!opt->flow) SymScan(&image, &sym, ob->run); // (-r collects them itself)
+    if (!opt->flow && opt->sig) SigScan(&image, &sym, ob->run, opt->sig);
+    ob->sym = &sym;
+    }
+  if (opt->xref && !opt->format)                // Direct page accesses
+    {
+    memset(&xref, 0, sizeof(XREF));             // (Empty until built)
+    if (!opt->flow) XrefScan(&image, &xref, ob->run); // (-r collects them itself)
+    ob->xref = &xref;
+    }
+
+  if (!opt->flow) StatPhase(ob, STAT_FORMAT);  // (-r traces first)
+  if (opt->flow)
+    n = DasmImageFlow(&image, ob, opt);
+  else if (opt->cache && !opt->format)
+    n = DasmImageCache(&image, ob, opt);
+  else if (opt->parallel && !opt->format && image.kind == HEX_NONE && image.size >= 2*opt->chunk)
+    n = DasmImagePar(&image, ob, opt);
+  else
+    DasmRange(&image, ob, 0, image.size, &n);
+
+  if (ob->xref)
+    {
+    n += XrefReport(ob, &xref, ob->sym);
+    ob->xref = NULL;
+    XrefFree(&xref);
+    }
+  if (opt->cycles && !opt->format) n += CycReport(ob, &image, opt);
+  if (opt->labels)
+    {
+    ob->sym = NULL;
+    SymFree(&sym);
+    }
+  if (opt->fill)
+    {
+    ob->run = NULL;
+    RunFree(&runs);
+    }
+  ob->reg = NULL;
+
+  if (ob->stats) ob->stats->files++;
+  if (opt->format)
+    {
+    FmtEnd(ob, image.size);
+    ImageClose(&image);
+    StatPhase(ob, STAT_NONE);
+    return 0;
+    }
+
+  OutStr(ob, "\n");
+  if (image.cpu == DASM6805_HC05 && image.size > ROMSIZE)
+    {
+    sprintf(line, "Warning: %s exceeds M68HC05 ROM-Size\n", name);
+    OutStr(ob, line);
+    }
+
+  sprintf(line, "%d Source lines produced\n", n);
+  OutStr(ob, line);
+  ImageClose(&image);
+  StatPhase(ob, STAT_NONE);
+  return 0;
+  } // DasmFile
 
 /*****************************************************************
 **                                                              **
 ** Function: main                                               **
 **                                                              **
 ** Abstract: The command Line is read and checked for the       **
-**           input file name. If no filename was found          **
-**           an error exit will be performed.                   **
+**           input file names. If no filename was found         **
+**           an error exit will be performed. More than one     **
+**           file, a folder or an @list are run in batch mode.  **
 **                                                              **
 ** Extern Input: int argc, char *argv[] from command line       **
 **                                                              **
@@ -389,135 +284,314 @@ _6805MNEMONIC mnemonic6805[] = {
 *****************************************************************/
 void main(int argc, char *argv[])
   {
-  if (argc != 2) // Illegal parameter, display help             
+  DASMOPT opt;
+  BATCH batch;
+  SYMTAB user;
+  SIGINDEX sig;
+  REGMAP reg;
+  static GREP grep;
+  static DASMSTATS stats;
+  SIMMAP map;
+  char *arg, *p, *sigout = NULL, *diff[2] = {NULL, NULL};
+  int n, bad, verify = FALSE, bench = FALSE, serve = FALSE, stream;
+
+  memset(&opt, 0, sizeof(DASMOPT));
+  memset(&batch, 0, sizeof(BATCH));
+  memset(&map, 0, sizeof(SIMMAP));
+  opt.chunk = PARCHUNK;
+  opt.vectors = ERR;                            // (Default of the CPU)
+  batch.opt = &opt;
+
+  for (n=1; n<argc; n++)
     {
-    printf(signon);
-    printf("Usage: %s file.bin [>file.txt]\n", PathFindFileName(argv[0]));                               
-    exit(1);
-    }
+    if (argv[n][0] != '-' || argv[n][1] == 0)
+      {
+      BatchAdd(&batch, argv[n]);
+      continue;
+      }
 
-  // get argv_name and convert to upper case chars
-  for (i=0; i<LENGTH; i++) argv[1][i] = toupper(argv[1][i]);
-  strcpy(argv_name, argv [1]);
-  argv_name[LENGTH+4] = 0;    // ensure NUL at string end
+    // Long option: "--cpu hc08" or "--cpu=hc08", "--stats[=json]",
+    // "--diff old.bin new.bin"
+    if (argv[n][1] == '-')
+      {
+      if ((p = strchr(argv[n], '=')) != NULL) *p++ = 0;
+      if (StrCmpI(&argv[n][2], "diff") == 0)
+        {
+        if (p == NULL && n+1 < argc) p = argv[++n];
+        if (p == NULL || n+1 >= argc)
+          {
+          batch.count = 0;
+          break;
+          }
+        diff[0] = p;
+        diff[1] = argv[++n];
+        continue;
+        }
+      if (StrCmpI(&argv[n][2], "stats") == 0)
+        {
+        if (p && StrCmpI(p, "json") != 0)
+          {
+          batch.count = 0;
+          break;
+          }
+        opt.stats = p ? STATS_JSON : STATS_TEXT;
+        continue;
+        }
+      arg = p ? p : (n+1 < argc) ? argv[n+1] : NULL;
+      if (arg == NULL || StrCmpI(&argv[n][2], "cpu") != 0)
+        {
+        batch.count = 0;                        // Illegal option
+        break;
+        }
+      if (StrCmpI(arg, "hc05") == 0 || StrCmpI(arg, "6805") == 0) opt.cpu = DASM6805_HC05;
+      else if (StrCmpI(arg, "hc08") == 0) opt.cpu = DASM6805_HC08;
+      else if (StrCmpI(arg, "hc11") == 0) opt.cpu = DASM6805_HC11;
+      else
+        {
+        batch.count = 0;
+        break;
+        }
+      if (arg == argv[n+1]) n++;
+      continue;
+      }
 
-  // check and open input file
-  if ((fh=open(argv_name, O_RDONLY|O_BINARY)) == ERR)
+    // Options with a value: "-j4" or "-j 4"
+    arg = argv[n][2] ? &argv[n][2] : (n+1 < argc) ? argv[n+1] : NULL;
+    switch (toupper(argv[n][1]))
+      {
+      case 'C':                                 // combined listing to stdout
+        batch.combined = TRUE;
+        continue;
+      case 'J':                                 // number of worker threads
+        if (arg == NULL || (opt.threads = atoi(arg)) <= 0) break;
+        if (arg == argv[n+1]) n++;
+        continue;
+      case 'P':                                 // parallel sweep of one image
+        opt.parallel = TRUE;
+        continue;
+      case 'T':                                 // test parallel against serial
+        verify = TRUE;
+        continue;
+      case 'B':                                 // benchmark, golden listings
+        bench = TRUE;
+        continue;
+      case 'Q':                                 // query server
+        serve = TRUE;
+        continue;
+      case 'R':                                 // control flow guided
+        opt.flow = TRUE;
+        continue;
+      case 'V':                                 // number of vectors
+        if (arg == NULL || (opt.vectors = atoi(arg)) < 0) break;
+        if (arg == argv[n+1]) n++;
+        continue;
+      case 'E':                                 // entry points addr[,addr..]
+        if (arg == NULL) break;
+        for (p=arg; *p && opt.nentry < MAXENTRY; p++)
+          {
+          opt.entry[opt.nentry++] = strtoul(p, &p, 16);
+          if (*p != ',') break;
+          }
+        if (*p) break;
+        if (arg == argv[n+1]) n++;
+        continue;
+      case 'F':                                 // fill runs and strings
+        opt.fill = TRUE;
+        continue;
+      case 'L':                                 // labels
+        opt.labels = TRUE;
+        continue;
+      case 'A':                                 // direct page cross-reference
+        opt.xref = TRUE;
+        continue;
+      case 'U':                                 // cycle budget of n routines
+        if (arg == NULL || (opt.cycles = atoi(arg)) <= 0) break;
+        if (arg == argv[n+1]) n++;
+        continue;
+      case 'S':                                 // user symbol file
+        if (arg == NULL) break;
+        if (opt.user == NULL) SymInit(&user);
+        if ((bad = SymLoad(&user, arg)) == ERR)
+          {
+          printf("Open failed on %s\n", arg);
+          exit(1);
+          }
+        if (bad) exit(1);                       // Bad lines
+        opt.user = &user;
+        opt.labels = TRUE;
+        if (arg == argv[n+1]) n++;
+        continue;
+      case 'N':                                 // signatures of known functions
+        if (arg == NULL || opt.sig) break;
+        if ((bad = SigOpen(&sig, arg)) != 0)
+          {
+          printf(bad == ERR ? "Open failed on %s\n" : "Bad signature file %s\n", arg);
+          exit(1);
+          }
+        opt.sig = &sig;
+        opt.labels = TRUE;
+        if (arg == argv[n+1]) n++;
+        continue;
+      case 'I':                                 // register map of the derivative
+        if (arg == NULL || opt.reg) break;
+        if ((bad = RegOpen(&reg, arg)) != 0)
+          {
+          if (bad == ERR) printf("Open failed on %s\n", arg);
+          exit(1);                              // (Bad lines: on stderr)
+          }
+        opt.reg = &reg;
+        if (arg == argv[n+1]) n++;
+        continue;
+      case 'W':                                 // write the signatures
+        if (arg == NULL) break;
+        sigout = arg;
+        if (arg == argv[n+1]) n++;
+        continue;
+      case 'G':                                 // search pattern
+        if (arg == NULL) break;
+        if (!GrepAdd(&grep, arg))
+          {
+          printf("Bad pattern %s\n", arg);
+          exit(1);
+          }
+        if (arg == argv[n+1]) n++;
+        continue;
+      case 'X':                                 // simulate n cycles (-r)
+        if (arg == NULL || (opt.sim = strtoul(arg, &p, 10)) == 0 || *p) break;
+        opt.flow = TRUE;
+        if (arg == argv[n+1]) n++;
+        continue;
+      case 'Y':                                 // memory map of the simulation
+        if (arg == NULL || !SimMap(&map, arg)) break;
+        opt.map = &map;
+        if (arg == argv[n+1]) n++;
+        continue;
+      case 'K':                                 // listing cache file
+        if (arg == NULL) break;
+        opt.cache = arg;
+        if (arg == argv[n+1]) n++;
+        continue;
+      case 'M':                                 // machine-readable output
+        if (arg == NULL) break;
+        opt.format = toupper(arg[0]) == 'J' ? FMT_JSON : toupper(arg[0]) == 'B' ? FMT_REC : FMT_TEXT;
+        if (opt.format == FMT_TEXT) break;
+        if (arg == argv[n+1]) n++;
+        continue;
+      case 'O':                                 // output folder
+        if (arg == NULL) break;
+        batch.outdir = arg;
+        if (arg == argv[n+1]) n++;
+        continue;
+      }
+    batch.count = 0;                            // Illegal option
+    break;
+    } // end for
+
+  if (opt.vectors == ERR) opt.vectors = (opt.cpu == DASM6805_HC11) ? FLOWVECTORS11 : FLOWVECTORS;
+  if (grep.count)                               // Search, no listings
     {
-    printf("Open failed on %s\n", argv_name);
-    exit(1);
+    GrepCompile(&grep, opt.cpu);
+    opt.grep = &grep;
+    batch.combined = TRUE;
     }
 
-  bytesrd = read(fh, inbuf, ROMSIZE+1);
-  printf("Disassembly of %s\n\n", argv_name);
+  // -------- Benchmark --------
+  //
+  if (bench && n >= argc) exit(DasmBench(&opt) ? 1 : 0);
 
-  // -------- Disassemble MC6805 binary file --------
+  // -------- Compare two images --------
   //
-  i=0; k=0;
-  
-  while (i<bytesrd)
+  if (diff[0] && n >= argc && batch.count == 0)
     {
-    printf("%04X  %02X ", i, (UCHAR)inbuf[i]);  // print address & instruction opcode
-    j = (UCHAR)inbuf[i];                        // get instruction mnemonic index
+    OutInit(&outbuf, stdout);
+    n = DasmDiff(diff[0], diff[1], &outbuf, &opt);
+    OutFree(&outbuf);
+    exit(n == ERR ? 1 : 0);
+    }
 
-    if (mnemonic6805[j].mneStr[0] == '\t')
-      {
-      // 3 byte instruction "\t\t"
-      if (mnemonic6805[j].mneStr[1] == '\t' && (bytesrd-i) >= 3)  
-        {
-        i++;
-        printf("%02X ", (UCHAR)inbuf[i]);       // print operand 1
-        i++;
-        printf("%02X", (UCHAR)inbuf[i]);        // print operand 2
-        printf(mnemonic6805[j].mneStr);         // print mnemonics
+  if (batch.combined && opt.format == FMT_REC) batch.count = 0;  // One record file per image
+  if (opt.sim && opt.cpu != DASM6805_HC05) batch.count = 0;      // M68HC05 only
+  if (serve && batch.count != 1) batch.count = 0; // One image
+  if (sigout && opt.user == NULL) batch.count = 0; // Names of the signatures
+  stream = batch.count == 1 && strcmp(batch.name[0], "-") == 0;
+  if (stream && (opt.flow || opt.labels || opt.fill || opt.cache || opt.parallel || opt.format ||
+                 opt.xref || opt.cycles || opt.grep || serve || verify || sigout || batch.combined || batch.outdir))
+    batch.count = 0;                            // Linear sweep of stdin only
 
-        if (j>=0x00 && j<=0x0F)                 // bit test and branch
-          {
-          printf("%03X", (UCHAR)inbuf[i-1]);    // print 8bit RAM location address
-          if (inbuf[i] < 0x80) l = i+1 + (int)inbuf[i];
-          else l = i+128 + (int)(inbuf[i] | 0xFF00);
-          printf(",$%04X", (WORD)l);            // ",$" append 16bit branch address
-          }
-        else                                    // print 16bit location address
-          printf("%02X%02X", (UCHAR)inbuf[i-1], (UCHAR)inbuf[i]);
-        
-        if (j>=0xD0 && j<=0xDF) printf(",x");   // indexed 16bit offset
-
-        // For the sake of legibility:
-        // Insert a blank line after unconditional JMPs
-        if (!StrCmpNI(&mnemonic6805[j].mneStr[6], "jmp",3)) printf("\n");
-        } // end if "\t\t"
-      
-      // 2 byte instruction "\t"
-      else if ((bytesrd-i) >= 2)                
-        {                                       
-        i++;                                   
-        printf("%02X\t", (UCHAR)inbuf[i]);      // print operand byte
-
-        // Check if two odd last bytes were left for a 3 byte instruction
-        if (mnemonic6805[j].mneStr[1] == '\t') 
-          printf("\t\t---\t\t\t; FCB  $%02X, $", (UCHAR)inbuf[i+1]);
-        else
-          printf(&mnemonic6805[j].mneStr[0]);   // print mnemonics
-
-        if (j>=0x20 && j<=0x2F)                 // check relative branches
-          {                                     // calculate absolute address
-          if (inbuf[i] < 0x80) l = i+1 + (int)inbuf[i];
-          else l = i+128 + (int)inbuf[i] | 0xFF00;
-          printf("%04X", (WORD)l);
-          }
-        else                                    
-          {
-          if (j>=0xA0 && j<=0xAF)
-            printf("%02X", (UCHAR)inbuf[i]);    // immediate addressing mode
-          else
-            printf("%03X", (UCHAR)inbuf[i]);    // direct addressing mode
-          }
-        if (j>=0xE0 && j<=0xEF) printf(",x");   // indexed 1 byte offset
-        if (j>=0x60 && j<=0x6F) printf(",x");   // indexed 1 byte offset 
+  if (batch.count == 0) // Illegal parameter, display help             
+    {
+    printf(signon);
+    printf("Usage: %s [options] file.bin [>file.txt]\n", PathFindFileName(argv[0]));
+    printf("       %s [options] file.bin|dir|@list ...\n", PathFindFileName(argv[0]));
+    printf("       %s [options] - <file.bin  (linear sweep, listed as read)\n", PathFindFileName(argv[0]));
+    printf("  -c      ordered combined listing to stdout\n");
+    printf("  -o dir  folder for the file_dasm.txt listings\n");
+    printf("  -j n    number of worker threads\n");
+    printf("  -p      parallel disassembly of one large file\n");
+    printf("  -t      test: parallel listing must equal serial listing\n");
+    printf("  -b      benchmark and golden listing check (no file)\n");
+    printf("  -q      query server: l|b|a addr [n] lists the lines at addr (stdin),\n");
+    printf("          x r|w|t addr|name the reads, writes, bit tests of a direct address\n");
+    printf("  -r      follow the flow of control from the vectors\n");
+    printf("  -v n    number of vectors at the top of memory (%d, M68HC11 %d)\n", FLOWVECTORS, FLOWVECTORS11);
+    printf("  -e a,.. more entry points (hex) for -r\n");
+    printf("  -x n    simulate n cycles from reset, executed code for -r (M68HC05)\n");
+    printf("  -y map  memory map of -x: io:0000-001F,ram:0050-00FF,rom:..\n");
+    printf("  -l      labels Lxxxx for the branch and jump targets\n");
+    printf("  -s file user symbols: name [equ] $addr per line (implies -l)\n");
+    printf("  -f      fill runs as fcb n dup $xx, ASCII strings as fcc\n");
+    printf("  -a      direct page cross-reference: access counts on the lines, report\n");
+    printf("  -n file name the functions (jsr/bsr targets) found in the signature file\n");
+    printf("  -w file write the signatures of the functions at the -s symbols (and -n)\n");
+    printf("  -i part I/O register names of the 705c8a, 705j1a, 705p9 or of a map file\n");
+    printf("          with name [equ] $addr [bit7 .. bit0 names] per line\n");
+    printf("  -u n    cycle budget: the vectored and the n most expensive routines, loops\n");
+    printf("  -k file listing cache: re-disassemble only the changed parts\n");
+    printf("  -m j|b  JSON lines or binary records with address index (not -c)\n");
+    printf("  -g pat  list the matches of an instruction pattern, e.g. \"jsr $1A??\"\n");
+    printf("  --cpu c instruction set hc05 (default), hc08 or hc11\n");
+    printf("  --stats[=json] times, throughput, opcode histogram on stderr\n");
+    printf("  --diff a b  changed instructions of image b against image a (no file)\n");
+    exit(1);
+    }
 
-        // For the sake of legibility:
-        // Insert a blank line after unconditional BRAs and JMPs
-        if (!StrCmpNI(&mnemonic6805[j].mneStr[5],"jmp",3)) printf("\n");
-        if (!StrCmpNI(&mnemonic6805[j].mneStr[5],"bra",3)) printf("\n");
-        } // end else "\t"
+  // -------- Verify the parallel sweep --------
+  //
+  if (verify) exit(DasmVerify(batch.name[0], &opt) ? 1 : 0);
 
-      // One odd last byte left - indeterminable instruction
-      else printf("\t\t\t---\t\t\t; FCB  '%c'", (UCHAR)inbuf[i]);
-      } // end if mnemonic6805[j].mneStr[0]
+  // -------- Write a signature file --------
+  //
+  if (sigout)
+    {
+    if ((n = SigBuild(sigout, &batch, opt.sig ? &sig : NULL)) == ERR) exit(1);
+    printf("%d signatures written to %s\n", n, sigout);
+    exit(0);
+    }
 
-    // 1 byte instruction
-    else
-      {
-      printf ("\t\t");
-      printf (mnemonic6805[j].mneStr);
-
-      // For the sake of legibility:
-      // Insert a blank line after unconditional RTS, RTI and JMPs
-      if (!StrCmpNI(&mnemonic6805[j].mneStr[4], "rts",3)) printf("\n");
-      if (!StrCmpNI(&mnemonic6805[j].mneStr[4], "rti",3)) printf("\n");
-      if (!StrCmpNI(&mnemonic6805[j].mneStr[4], "jmp",3)) printf("\n");
-      }
+  // -------- Serve queries on one image --------
+  //
+  if (serve) exit(DasmServe(batch.name[0], &opt, stdin, stdout) ? 1 : 0);
 
-    if (!StrCmpNI(&mnemonic6805[j].mneStr[2], "---", 3))
-      {
-      if ((UCHAR)inbuf[i] >= SPACE && (UCHAR)inbuf[i] < 0x7F)
-        printf("\t\t\t; FCB  '%c'", (UCHAR)inbuf[i]);
-      else
-        printf("\t\t\t; FCB  $%02X", (UCHAR)inbuf[i]);
-      }
+  // -------- Disassemble many MC6805 binary files --------
+  //
+  if (batch.count > 1 || batch.expanded || batch.combined || batch.outdir)
+    exit(BatchRun(&batch) ? 1 : 0);
 
-    printf("\n");
-    i++; k++;
-    } // end while */
-
-  printf("\n"); 
-  if (bytesrd > ROMSIZE)
-    printf("Warning: %s exceeds M68HC05 ROM-Size\n", argv_name);
-  
-  printf("%d Source lines produced\n", k);
-  close(fh);
-  exit(0);
+  // -------- Disassemble MC6805 binary file (or stdin) --------
+  //
+  if (opt.format == FMT_REC) _setmode(_fileno(stdout), _O_BINARY);
+  if (stream) _setmode(_fileno(stdin), _O_BINARY);
+  OutInit(&outbuf, stdout);
+  if (opt.stats)
+    {
+    StatInit(&stats, opt.cpu);
+    outbuf.stats = &stats;
+    }
+  if (stream) n = DasmStream(_fileno(stdin), &outbuf, &opt);
+  else n = DasmFile(batch.name[0], &outbuf, &opt);
+  OutFree(&outbuf);
+  if (opt.stats) StatReport(&stats, opt.stats);
+  exit(n == ERR ? 1 : 0);
   } // main
 
 //****************************************************************************
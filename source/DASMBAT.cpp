@@ -0,0 +1,414 @@
+// haDASM - Disassembler for Microchip processors
+// dasmbat.cpp - C++ Developer source file.
+// (c)1990-2023 by helmut altmann
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; see the file COPYING.  If not, write to
+// the Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+// Boston, MA 02111-1307, USA.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <io.h>
+#include <windows.h>
+#include <shlwapi.h>   // PathIsDirectory, PathFindFileName, ..
+
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include "equate.h"
+#include "extern.h"
+
+// --------------------------------------------
+// Work-stealing thread pool
+// --------------------------------------------
+// Every worker owns a range [lo,hi) of job numbers, packed into one
+// 64bit word (lo | hi<<32). The owner takes jobs from the front (lo++),
+// an idle worker steals from the back of another range (hi--).
+// Both are a single compare-exchange, no locks.
+//
+typedef struct tag_POOLQUEUE {
+  std::atomic<unsigned long long> range;
+  char pad[64 - sizeof(unsigned long long)];  // One cache line per queue
+} POOLQUEUE;
+
+typedef struct tag_POOL {
+  POOLQUEUE* queue;
+  int threads;
+  POOLPROC proc;
+  void* ctx;
+} POOL;
+
+static BOOL PoolTake(POOLQUEUE* q, int steal, int* job)
+  {
+  unsigned long long r = q->range.load(), n;
+  DWORD lo, hi;
+
+  do
+    {
+    lo = (DWORD)r;
+    hi = (DWORD)(r >> 32);
+    if (lo >= hi) return FALSE;
+    n = steal ? r - (1ULL << 32) : r + 1;
+    } while (!q->range.compare_exchange_weak(r, n));
+
+  *job = steal ? hi-1 : lo;
+  return TRUE;
+  } // PoolTake
+
+static void PoolWorker(POOL* pool, int self)
+  {
+  int job, n;
+
+  for (;;)
+    {
+    if (!PoolTake(&pool->queue[self], FALSE, &job))
+      {
+      // Own range is empty: steal from the others
+      for (n=1; n<pool->threads; n++)
+        if (PoolTake(&pool->queue[(self+n) % pool->threads], TRUE, &job)) break;
+      if (n >= pool->threads) return;           // All ranges are empty
+      }
+    pool->proc(pool->ctx, job);
+    }
+  } // PoolWorker
+
+//-----------------------------------------------------------------------------
+//
+//                          PoolRun
+//
+// Run proc(ctx, job) for job = 0..jobs-1 on 'threads' worker threads
+// (0 = one per processor). Returns when all jobs are done.
+//
+void PoolRun(int jobs, int threads, POOLPROC proc, void* ctx)
+  {
+  std::thread* worker;
+  POOL pool;
+  int n;
+
+  if (threads <= 0) threads = std::thread::hardware_concurrency();
+  if (threads > jobs) threads = jobs;
+  if (threads <= 0) threads = 1;
+
+  pool.queue = new POOLQUEUE[threads];
+  pool.threads = threads;
+  pool.proc = proc;
+  pool.ctx = ctx;
+
+  // Initial split: contiguous ranges of equal size
+  for (n=0; n<threads; n++)
+    pool.queue[n].range = (unsigned long long)((long long)jobs * n / threads) |
+                          (unsigned long long)((long long)jobs * (n+1) / threads) << 32;
+
+  worker = new std::thread[threads];
+  for (n=1; n<threads; n++) worker[n] = std::thread(PoolWorker, &pool, n);
+  PoolWorker(&pool, 0);                         // The caller is worker 0
+  for (n=1; n<threads; n++) worker[n].join();
+
+  delete[] worker;
+  delete[] pool.queue;
+  } // PoolRun
+
+// --------------------------------------------
+// Batch mode
+// --------------------------------------------
+// In combined mode the files are taken in the order of the list, and
+// at most BATCHAHEAD listings per worker thread are kept in memory:
+// a worker that would run further ahead of the next listing due for
+// output waits for the writer.
+//
+#define BATCHAHEAD  2         // Listings in memory per worker (combined mode)
+
+typedef struct tag_BATCHRUN {
+  BATCH* batch;
+  OUTBUF* out;                                  // Listings (combined mode)
+  char* done;                                   // Job has finished
+  int next;                                     // Next job to take (combined mode)
+  int written;                                  // Listings written to stdout
+  int ahead;                                    // Jobs taken ahead of 'written', at most
+  std::atomic<int> errors;
+  std::atomic<int> matches;                     // Pattern search (-g)
+  DASMSTATS stats;                              // Of all jobs (--stats)
+  std::mutex lock;
+  std::condition_variable cond;
+} BATCHRUN;
+
+static void BatchAddName(BATCH* bat, const char* name)
+  {
+  if (bat->count == bat->alloc)
+    {
+    bat->alloc = bat->alloc ? 2*bat->alloc : 64;
+    OutOfMemory(bat->name = (char**)realloc(bat->name, bat->alloc * sizeof(char*)));
+    }
+  bat->name[bat->count++] = _strdup(name);
+  } // BatchAddName
+
+static int BatchCompare(const void* a, const void* b)
+  {
+  return strcmp(*(char**)a, *(char**)b);
+  } // BatchCompare
+
+//-----------------------------------------------------------------------------
+//
+//                          BatchAdd
+//
+// Add the command line argument 'arg' to the batch file list:
+//   file.bin     the file
+//   dir          all files dir\*.bin
+//   dir\*.s19    all files matching the wildcard
+//   @list        all files (folders, wildcards) named in the list file
+//
+void BatchAdd(BATCH* bat, const char* arg)
+  {
+  char path[MAX_PATH+8], line[MAX_PATH+8];
+  WIN32_FIND_DATAA fd;
+  HANDLE hFind;
+  FILE* fp;
+  char* p;
+  int n, first;
+
+  if (arg[0] == '@')
+    {
+    bat->expanded = TRUE;
+    if ((fp = fopen(&arg[1], "r")) == NULL)
+      {
+      fprintf(stderr, "Open failed on %s\n", &arg[1]);
+      return;
+      }
+    while (fgets(line, sizeof(line), fp))
+      {
+      for (p=line; isspace((UCHAR)*p); p++);
+      for (n=strlen(p); n && isspace((UCHAR)p[n-1]); n--) p[n-1] = 0;
+      if (*p && *p != ';') BatchAdd(bat, p);    // ';' comment line
+      }
+    fclose(fp);
+    return;
+    }
+
+  if (PathIsDirectoryA(arg))
+    _snprintf(path, sizeof(path), "%s\\*.bin", arg);
+  else if (strpbrk(arg, "*?"))
+    _snprintf(path, sizeof(path), "%s", arg);
+  else
+    {
+    BatchAddName(bat, arg);
+    return;
+    }
+  path[sizeof(path)-1] = 0;
+  bat->expanded = TRUE;
+
+  // Folder prefix of the wildcard
+  p = PathFindFileNameA(path);
+  n = p - path;
+  first = bat->count;
+
+  if ((hFind = FindFirstFileA(path, &fd)) == INVALID_HANDLE_VALUE) return;
+  do
+    {
+    if (fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) continue;
+    _snprintf(line, sizeof(line), "%.*s%s", n, path, fd.cFileName);
+    line[sizeof(line)-1] = 0;
+    BatchAddName(bat, line);
+    } while (FindNextFileA(hFind, &fd));
+  FindClose(hFind);
+
+  qsort(&bat->name[first], bat->count - first, sizeof(char*), BatchCompare);
+  } // BatchAdd
+
+//-----------------------------------------------------------------------------
+//
+//                          BatchJob
+//
+// Disassemble file number 'job' of the batch, either into its own
+// listing file name_dasm.txt (.json, .dsr with -m) or (combined mode)
+// into memory. A pattern search (-g) lists its matches in memory.
+// The statistics of the job (--stats) are added to run->stats.
+//
+static void BatchJob(void* ctx, int job)
+  {
+  BATCHRUN* run = (BATCHRUN*)ctx;
+  BATCH* bat = run->batch;
+  const char* name = bat->name[job];
+  DASMOPT opt = *bat->opt;
+  char path[MAX_PATH+16];
+  DASMSTATS st;
+  OUTBUF ob;
+  FILE* fp;
+  int n;
+
+  opt.parallel = FALSE;                         // The files run in parallel
+  opt.cache = NULL;                             // One cache file per image
+
+  if (opt.stats) StatInit(&st, opt.cpu);
+  if (bat->combined)
+    {
+    OutInit(&run->out[job], NULL);
+    if (opt.stats) run->out[job].stats = &st;
+    n = opt.grep ? GrepFile(name, &run->out[job], &opt) : DasmFile(name, &run->out[job], &opt);
+    if (n == ERR)
+      {
+      fprintf(stderr, "Open failed on %s\n", name);
+      run->errors++;
+      }
+    else if (opt.grep) run->matches += n;
+    st.out = run->out[job].len;                 // Written by BatchWriter
+    std::lock_guard<std::mutex> lk(run->lock);
+    if (opt.stats) StatAdd(&run->stats, &st);
+    run->done[job] = TRUE;
+    run->cond.notify_all();
+    return;
+    }
+
+  if (_access(name, 4) == ERR)                  // No listing for a missing file
+    {
+    fprintf(stderr, "Open failed on %s\n", name);
+    run->errors++;
+    return;
+    }
+
+  // Listing file: [outdir\]name_dasm.txt
+  if (bat->outdir) n = _snprintf(path, sizeof(path), "%s\\%s", bat->outdir, PathFindFileNameA(name));
+  else n = _snprintf(path, sizeof(path), "%s", name);
+  path[sizeof(path)-1] = 0;
+  n = PathFindExtensionA(path) - path;
+  _snprintf(&path[n], sizeof(path)-n, opt.format == FMT_JSON ? "_dasm.json" :
+                                      opt.format == FMT_REC ? "_dasm.dsr" : "_dasm.txt");
+  path[sizeof(path)-1] = 0;
+
+  if ((fp = fopen(path, opt.format == FMT_REC ? "wb" : "w")) == NULL)
+    {
+    fprintf(stderr, "Open failed on %s\n", path);
+    run->errors++;
+    return;
+    }
+
+  OutInit(&ob, fp);
+  if (opt.stats) ob.stats = &st;
+  if (DasmFile(name, &ob, &opt) == ERR)
+    {
+    fprintf(stderr, "Open failed on %s\n", name);
+    run->errors++;
+    }
+  OutFree(&ob);
+  if (opt.stats)
+    {
+    std::lock_guard<std::mutex> lk(run->lock);
+    StatAdd(&run->stats, &st);
+    }
+  if (fclose(fp))
+    {
+    fprintf(stderr, "Write failed on %s\n", path);
+    run->errors++;
+    }
+  } // BatchJob
+
+// Combined mode: the pool job number is ignored, the next file of the
+// list is taken once it is no more than run->ahead in front of the
+// next listing due for output
+static void BatchOrdered(void* ctx, int)
+  {
+  BATCHRUN* run = (BATCHRUN*)ctx;
+  int job;
+
+    {
+    std::unique_lock<std::mutex> lk(run->lock);
+    job = run->next++;
+    while (job >= run->written + run->ahead) run->cond.wait(lk);
+    }
+  BatchJob(ctx, job);
+  } // BatchOrdered
+
+//-----------------------------------------------------------------------------
+//
+//                          BatchWriter
+//
+// Combined mode: copy the listings to stdout in the order of the
+// batch file list, each as soon as it (and all before it) is done,
+// and free it.
+//
+static void BatchWriter(BATCHRUN* run)
+  {
+  int job;
+
+  for (job=0; job<run->batch->count; job++)
+    {
+      {
+      std::unique_lock<std::mutex> lk(run->lock);
+      while (!run->done[job]) run->cond.wait(lk);
+      }
+    fwrite(run->out[job].buf, 1, run->out[job].len, stdout);
+    free(run->out[job].buf);
+    run->out[job].buf = NULL;
+      {
+      std::lock_guard<std::mutex> lk(run->lock);
+      run->written = job + 1;
+      run->cond.notify_all();
+      }
+    }
+  fflush(stdout);
+  } // BatchWriter
+
+//-----------------------------------------------------------------------------
+//
+//                          BatchRun
+//
+// Disassemble all files of the batch in parallel.
+//
+// Returns the number of files that failed.
+//
+int BatchRun(BATCH* bat)
+  {
+  std::thread writer;
+  BATCHRUN run;
+  int threads = bat->opt->threads;
+
+  if (threads <= 0) threads = std::thread::hardware_concurrency();
+  run.batch = bat;
+  run.next = run.written = 0;
+  run.ahead = BATCHAHEAD * (threads > 0 ? threads : 1);
+  run.errors = 0;
+  run.matches = 0;
+  run.out = NULL;
+  run.done = NULL;
+  if (bat->opt->stats) StatInit(&run.stats, bat->opt->cpu);
+
+  if (bat->combined)
+    {
+    OutOfMemory(run.out = (OUTBUF*)calloc(bat->count, sizeof(OUTBUF)));
+    OutOfMemory(run.done = (char*)calloc(bat->count, 1));
+    writer = std::thread(BatchWriter, &run);
+    }
+
+  PoolRun(bat->count, bat->opt->threads, bat->combined ? BatchOrdered : BatchJob, &run);
+
+  if (bat->combined)
+    {
+    writer.join();
+    free(run.out);
+    free(run.done);
+    }
+
+  if (bat->opt->grep)
+    fprintf(stderr, "%d files searched, %d matches, %d failed\n",
+            bat->count - run.errors, (int)run.matches, (int)run.errors);
+  else
+    fprintf(stderr, "%d files disassembled, %d failed\n", bat->count - run.errors, (int)run.errors);
+  if (bat->opt->stats && !bat->opt->grep) StatReport(&run.stats, bat->opt->stats);
+  return run.errors;
+  } // BatchRun
+
+//--------------------------end-of-c++-module-----------------------------------
@@ -0,0 +1,1277 @@
+// haDASM - Disassembler for Microchip processors
+// dasmbench.cpp - C++ Developer source file.
+// (c)1990-2023 by helmut altmann
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; see the file COPYING.  If not, write to
+// the Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+// Boston, MA 02111-1307, USA.
+
+
+#include <ctype.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <io.h>
+#include <windows.h>
+
+#include <chrono>
+
+#include "equate.h"
+#include "extern.h"
+#include "dasmisa.h"
+
+// --------------------------------------------
+// Benchmark and golden listings (-b)
+// --------------------------------------------
+// Generated, reproducible inputs (fixed seed): random bytes, all 256
+// opcodes with random operands, branch-heavy code, an FF-filled image
+// and a firmware-like mix of code, strings and FF padding. Each is
+// first listed at ROMSIZE in several modes and the FNV-1a hash of the
+// listing compared with benchGold[]; then decode, format (without and
+// with the register names of -i) and the whole file listing (without
+// and with the counters of --stats) are timed separately at BENCHSIZE
+// (best of BENCHRUNS).
+//
+// A change that is meant to change the listing must update the hashes
+// in benchGold[] (a mismatch prints the new hash). An image over
+// IMAGEWINDOW checks the fallback of -r to the linear sweep, a
+// one-insert, one-change pair the hunks of --diff, the simulator
+// image the readers and writers of one direct page address, the
+// cycles of its loop by -u and the targets of its jump table by -x,
+// the firmware input as S-records and Intel HEX the loaders, a few
+// placed instructions the pattern search of -g, the firmware input
+// the pages of the query server -q and its record files Dasm6805Seek.
+//
+#define BENCHSIZE   4*1024*1024   // Timed input size (FF fill: 4 times)
+#define BENCHRUNS   3             // Timed runs, the best one counts
+#define BENCHREC    4096          // Instruction records per decode call
+#define BENCHSIM    20000000      // Timed simulator cycles (-x)
+
+typedef void (*BENCHGEN)(BYTE* p, DWORD n);
+
+typedef struct tag_BENCHINPUT {
+  const char* name;
+  BENCHGEN gen;
+  DWORD size;                     // Timed size
+} BENCHINPUT;
+
+typedef struct tag_BENCHGOLD {
+  int input;                      // benchInput[]
+  const char* mode;               // Command line options of the listing
+  unsigned long long hash;        // FNV-1a of the listing without line 1
+} BENCHGOLD;
+
+typedef std::chrono::steady_clock BENCHCLOCK;
+
+static DWORD BenchRand(DWORD* s)  // xorshift32
+  {
+  *s ^= *s << 13;
+  *s ^= *s >> 17;
+  *s ^= *s << 5;
+  return *s;
+  } // BenchRand
+
+static void GenRandom(BYTE* p, DWORD n)
+  {
+  DWORD s = 0x6805;
+
+  while (n--) *p++ = (BYTE)BenchRand(&s);
+  } // GenRandom
+
+static void GenOpcodes(BYTE* p, DWORD n)         // 00, 01, .. FF with operands
+  {
+  DWORD s = 0x68C05, i = 0, k;
+  int op = 0;
+
+  while (i < n)
+    {
+    p[i++] = (BYTE)op;
+    for (k=1; k<opDesc6805[op].len && i<n; k++) p[i++] = (BYTE)BenchRand(&s);
+    op = (op + 1) & 0xFF;
+    }
+  } // GenOpcodes
+
+static void GenBranch(BYTE* p, DWORD n)          // bra, brset, jsr, rts, ..
+  {
+  static const BYTE ops[] = {0x00, 0x03, 0x0E, 0x20, 0x22, 0x26, 0x27, 0x2A,
+                             0xAD, 0xBC, 0xBD, 0xCC, 0xCD, 0x81, 0x4C, 0xA6};
+  DWORD s = 0x2005, i = 0, r;
+  int op;
+
+  while (i < n)
+    {
+    r = BenchRand(&s);
+    op = ops[r & 0x0F];
+    p[i++] = (BYTE)op;
+    if (opDesc6805[op].mode == AM_EXT)
+      r = (r >> 8) % n;                         // Target inside the image
+    if (opDesc6805[op].len > 1 && i < n) p[i++] = (BYTE)(r >> (opDesc6805[op].len == 3 ? 16 : 8));
+    if (opDesc6805[op].len > 2 && i < n) p[i++] = (BYTE)r;
+    }
+  } // GenBranch
+
+static void GenFill(BYTE* p, DWORD n)
+  {
+  memset(p, 0xFF, n);
+  } // GenFill
+
+static void GenFirmware(BYTE* p, DWORD n)        // code, strings, FF padding
+  {
+  static const char* text[] = {"(c)1990 MOTOROLA", "CHECKSUM ERROR", "Press any key", "Version 2.0"};
+  DWORD s = 0x0505, i = 0, m, r;
+
+  while (i < n)
+    {
+    r = BenchRand(&s);
+    m = 64 + (r >> 8) % 960;
+    if (m > n - i) m = n - i;
+    switch (r & 3)
+      {
+      case 2:                                   // Erased EPROM
+        memset(&p[i], 0xFF, m);
+        break;
+      case 3:                                   // NUL terminated string
+        if (m > strlen(text[(r >> 4) & 3]) + 1) m = strlen(text[(r >> 4) & 3]) + 1;
+        memcpy(&p[i], text[(r >> 4) & 3], m);
+        p[i+m-1] = 0;
+        break;
+      default:
+        GenBranch(&p[i], m);
+      }
+    i += m;
+    }
+  } // GenFirmware
+
+// Simulator loop at $0100: call the four routines of a jump table
+// at $0300 (jsr $0300,x), again and again
+static const BYTE benchSimCode[] = {
+  0x4F, 0xB7, 0x80, 0xB6, 0x80, 0x97, 0x58, 0xBF,   // clra, sta $80, lda $80, tax, lslx, stx $81
+  0x81, 0xBB, 0x81, 0x97, 0xDD, 0x03, 0x00, 0x3C,   // add $81, tax, jsr $0300,x, inc $80
+  0x80, 0xB6, 0x80, 0xA1, 0x04, 0x26, 0xEC, 0x20,   // lda $80, cmp #4, bne $0103
+  0xE7                                              // bra $0100
+  };
+static const BYTE benchSimTable[] = {
+  0xCC, 0x04, 0x00, 0xCC, 0x05, 0x00, 0xCC, 0x06,   // jmp $0400, jmp $0500, ..
+  0x00, 0xCC, 0x07, 0x00
+  };
+static const BYTE benchSimSub[] = {
+  0x9D, 0x48, 0x49, 0x44, 0x5A, 0x26, 0xFB, 0x81    // nop, lsla, rola, lsra, decx, bne, rts
+  };
+
+static const BENCHINPUT benchInput[] = {
+  {"random",  GenRandom,  BENCHSIZE},
+  {"opcodes", GenOpcodes, BENCHSIZE},
+  {"branch",  GenBranch,  BENCHSIZE},
+  {"fill-FF", GenFill,    4*BENCHSIZE},
+  {"firmware",GenFirmware,BENCHSIZE},
+  };
+#define BENCHINPUTS (int)(sizeof(benchInput)/sizeof(benchInput[0]))
+
+static const BENCHGOLD benchGold[] = {
+  {0, "",                     0x434D7CE23163AADAULL},
+  {0, "-l",                   0xA14AD1DAB570626DULL},
+  {0, "-r",                   0xB4A765AFEC175AEAULL},
+  {0, "-p",                   0x434D7CE23163AADAULL},
+  {0, "-f",                   0x4E972919F0B03F89ULL},
+  {1, "",                     0xA108D9D5D3FC7825ULL},
+  {1, "-l",                   0xE19CEF4B6F04AA36ULL},
+  {1, "-r",                   0x97F2B16168A17D11ULL},
+  {2, "",                     0xFFB90EEB38C1408CULL},
+  {2, "-l",                   0x2D34440128BC3884ULL},
+  {2, "-r",                   0x095838492166BEBDULL},
+  {2, "-p",                   0xFFB90EEB38C1408CULL},
+  {3, "",                     0xB8EA111402108E99ULL},
+  {3, "-r",                   0xEDFE00A2E9EFE300ULL},
+  {3, "-f",                   0xA3DBA86DEDD60F25ULL},
+  {3, "-r -f",                0x32B0ECB5A801C994ULL},
+  {4, "",                     0xB752C4823EA1B548ULL},
+  {4, "-f",                   0x16126ACE363C19C7ULL},
+  {4, "-l -f",                0x1E25D49DF1F36726ULL},
+  {4, "-r -f",                0xF6EE2FC14A7C6F4FULL},
+  {4, "-p -f",                0x16126ACE363C19C7ULL},
+  {4, "-k",                   0xB752C4823EA1B548ULL},
+  {4, "-l -f -k",             0x1E25D49DF1F36726ULL},
+  {4, "-l -m j",              0x340E935925565DE1ULL},
+  {4, "-r -f -m j",           0xCDFA596828A18A29ULL},
+  {4, "-l -f -m b",           0xB9AB302123E41D9DULL},
+  {1, "-r -x 100000",         0x970352C5B7406093ULL},
+  {3, "-r -x 100000",         0x086B2D615FCD6A0CULL},
+  {0, "--cpu hc08",           0xCE0364EC985BE1DCULL},
+  {0, "--cpu hc08 -p",        0xCE0364EC985BE1DCULL},
+  {0, "--cpu hc11",           0x3B67C42DB55F5D56ULL},
+  {0, "--cpu hc11 -p",        0x3B67C42DB55F5D56ULL},
+  {0, "-",                    0x434D7CE23163AADAULL},
+  {2, "-",                    0xFFB90EEB38C1408CULL},
+  {4, "-",                    0xB752C4823EA1B548ULL},
+  {0, "--cpu hc08 -",         0xCE0364EC985BE1DCULL},
+  {0, "--cpu hc11 -",         0x3B67C42DB55F5D56ULL},
+  {1, "--cpu hc08 -l",        0xDC98E474FBE90077ULL},
+  {1, "--cpu hc11 -l",        0x79128EABBEE22B36ULL},
+  {2, "--cpu hc08 -r",        0x57A80CC5E4F756C1ULL},
+  {2, "--cpu hc11 -r",        0x2945B1A26AF0FA45ULL},
+  {4, "--cpu hc08 -r -f",     0xB706EE8EB20A143CULL},
+  {4, "--cpu hc11 -l -f -k",  0x2A767493FEF98710ULL},
+  {4, "--cpu hc11 -l -m j",   0x79A0B79D57938FA4ULL},
+  {1, "-a",                   0x60CC2023614C2CE3ULL},
+  {1, "-p -a",                0x60CC2023614C2CE3ULL},
+  {2, "-l -a",                0xE0B2952C939DFF31ULL},
+  {4, "-r -f -a",             0x82CB9C18B8613DE1ULL},
+  {4, "-l -f -a",             0x07DB5D613846F514ULL},
+  {4, "-l -f -k -a",          0x07DB5D613846F514ULL},
+  {0, "--cpu hc08 -a",        0x8A16E3E336B03199ULL},
+  {0, "--cpu hc11 -a",        0x3BE490C4007B43ECULL},
+  {0, "-w -n",                0x49810844B0FF3E0DULL},
+  {2, "-w -n",                0x8DD4180661AC1D06ULL},
+  {2, "-p -w -n",             0x8DD4180661AC1D06ULL},
+  {4, "-w -n",                0xBD8E8D07F02379C4ULL},
+  {4, "-r -w -n",             0x4D4DB5D99CEE2C5CULL},
+  {0, "--cpu hc08 -w -n",     0x0DB1FDFD15B45EEEULL},
+  {0, "--cpu hc11 -w -n",     0xF1618CE209491627ULL},
+  {0, "--diff",               0xE9DF8611DD668FADULL},
+  {2, "--diff",               0x35539493C6DD800EULL},
+  {4, "--diff",               0xAE9E28BD5C114DA7ULL},
+  {0, "--cpu hc08 --diff",    0xC3F05062C95F3AAFULL},
+  {0, "--cpu hc11 --diff",    0x4C630B4902D3ED19ULL},
+  {0, "-i 705c8a",            0x2D5CA1840D850C51ULL},
+  {1, "-i 705c8a",            0x523423BC1D6B06F1ULL},
+  {1, "-p -i 705c8a",         0x523423BC1D6B06F1ULL},
+  {2, "-l -i 705c8a",         0xD460FCC59C96B3F8ULL},
+  {2, "-r -i 705c8a",         0xC65ECDD9FF71401BULL},
+  {4, "-l -f -k -i 705c8a",   0x0061061AB6F348F3ULL},
+  {0, "- -i 705c8a",          0x2D5CA1840D850C51ULL},
+  {0, "--cpu hc08 -i 705c8a", 0x309963160453DCFBULL},
+  {0, "--cpu hc11 -i 705c8a", 0x4A3A8509173BFDB6ULL},
+  {0, "-u 10",                0xC3F3A1276F8C29CFULL},
+  {1, "-u 10",                0xBD6A03898BAFC0ECULL},
+  {2, "-u 10",                0xEF1EBA43E1318C49ULL},
+  {2, "-l -u 10",             0xBB61EF86E10DB1F8ULL},
+  {4, "-u 10",                0xA12EA7105EDD25B8ULL},
+  {4, "-r -f -u 10",          0x2FFE84485E722D46ULL},
+  {4, "-p -u 10",             0xA12EA7105EDD25B8ULL},
+  {0, "--cpu hc08 -u 10",     0x09DD5FCC509BAD06ULL},
+  {0, "--cpu hc11 -u 10",     0x0D3DC76FD514AE22ULL},
+  };
+
+static BOOL BenchWrite(const char* name, const BYTE* p, DWORD n)
+  {
+  FILE* fp;
+  BOOL ok;
+
+  if ((fp = fopen(name, "wb")) == NULL) return FALSE;
+  ok = fwrite(p, 1, n, fp) == n;
+  return fclose(fp) == 0 && ok;
+  } // BenchWrite
+
+//-----------------------------------------------------------------------------
+//
+//                          BenchFile
+//
+// Generate input 'in' of 'n' bytes into p[] and write it to the
+// temporary file 'name'. The reset vector at the top points to 0
+// (except the FF fill).
+//
+static BOOL BenchFile(const BENCHINPUT* in, BYTE* p, DWORD n, const char* name)
+  {
+  in->gen(p, n);
+  if (in->gen != GenFill) p[n-2] = p[n-1] = 0;
+  return BenchWrite(name, p, n);
+  } // BenchFile
+
+static double BenchSeconds(BENCHCLOCK::time_point t0)
+  {
+  return std::chrono::duration<double>(BENCHCLOCK::now() - t0).count();
+  } // BenchSeconds
+
+//-----------------------------------------------------------------------------
+//
+//                          BenchGolden
+//
+// List the temporary file 'name' with the command line options 'mode'
+// into memory. Returns the FNV-1a hash of the listing without its
+// first line (which holds the file name). With -k the listing is made
+// twice, the second time from the cache file of the first. The output
+// of -m j and -m b is hashed as a whole. "-" streams the file like
+// stdin in reads of 1000 bytes: the same listing as the one without.
+// "-w -n" writes the signatures of the functions at all the labels
+// (named fXXXX) and lists the file with them. --diff compares the file
+// with a copy that has a byte inserted at 1/3 and one changed at 2/3.
+//
+// The option 'o' (one or more words) is in 'mode'
+static BOOL BenchOpt(const char* mode, const char* o)
+  {
+  size_t n = strlen(o);
+  const char* s;
+
+  for (s=mode; (s = strstr(s, o)) != NULL; s++)
+    if ((s == mode || s[-1] == SPACE) && (s[n] == SPACE || s[n] == 0)) return TRUE;
+  return FALSE;
+  } // BenchOpt
+
+static unsigned long long BenchGolden(const char* name, const char* mode, const DASMOPT* opt)
+  {
+  unsigned long long h = FNVBASIS;
+  char cache[MAX_PATH+8];
+  DASMOPT o = *opt;
+  char sigfile[MAX_PATH+8], newfile[MAX_PATH+8], t[16];
+  const char* names[1] = {name};
+  OUTBUF ob;
+  SYMTAB user;
+  SIGINDEX sig;
+  REGMAP reg;
+  BATCH bat;
+  IMAGE im;
+  BYTE* buf;
+  FILE* fp;
+  size_t i, n;
+  int fd;
+
+  o.labels = BenchOpt(mode, "-l");
+  o.flow = BenchOpt(mode, "-r");
+  o.parallel = BenchOpt(mode, "-p");
+  o.fill = BenchOpt(mode, "-f");
+  o.xref = BenchOpt(mode, "-a");
+  o.cycles = BenchOpt(mode, "-u 10") ? 10 : 0;
+  o.chunk = 1000;                               // Many small chunks
+  o.cache = NULL;
+  o.format = BenchOpt(mode, "-m j") ? FMT_JSON : BenchOpt(mode, "-m b") ? FMT_REC : FMT_TEXT;
+  o.cpu = BenchOpt(mode, "--cpu hc08") ? DASM6805_HC08 :
+          BenchOpt(mode, "--cpu hc11") ? DASM6805_HC11 : DASM6805_HC05;
+  if (o.cpu == DASM6805_HC11) o.vectors = FLOWVECTORS11;
+  o.sim = BenchOpt(mode, "-x 100000") ? 100000 : 0;
+  o.map = NULL;
+  o.sig = NULL;
+  o.reg = NULL;
+  if (BenchOpt(mode, "-i 705c8a") && RegOpen(&reg, "705c8a") == 0) o.reg = &reg;
+
+  if (BenchOpt(mode, "-w -n") && ImageOpen(&im, name) != ERR)
+    {
+    im.cpu = o.cpu;
+    SymInit(&user);
+    SymScan(&im, &user, NULL);
+    ImageClose(&im);
+    for (i=0; i<user.count; i++)
+      user.sym[i].name |= SymPool(&user, t, sprintf(t, "f%X", (unsigned)user.sym[i].addr));
+    memset(&bat, 0, sizeof(BATCH));
+    bat.name = (char**)names;
+    bat.count = 1;
+    bat.opt = &o;
+    o.user = &user;
+    sprintf(sigfile, "%s.sig", name);
+    SigBuild(sigfile, &bat, NULL);
+    o.user = NULL;
+    SymFree(&user);
+    if (SigOpen(&sig, sigfile) == 0)
+      {
+      o.sig = &sig;
+      o.labels = TRUE;
+      }
+    }
+
+  newfile[0] = 0;
+  if (BenchOpt(mode, "--diff") && (fp = fopen(name, "rb")) != NULL)
+    {
+    fseek(fp, 0, SEEK_END);
+    n = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    if ((buf = (BYTE*)malloc(n + 1)) != NULL && fread(buf, 1, n, fp) == n)
+      {
+      fclose(fp);
+      memmove(&buf[n/3 + 1], &buf[n/3], n - n/3);
+      buf[n/3] = 0x9D;                          // nop
+      buf[2*n/3] ^= 0x01;
+      sprintf(newfile, "%s.new", name);
+      if ((fp = fopen(newfile, "wb")) != NULL && fwrite(buf, 1, n + 1, fp) != n + 1) newfile[0] = 0;
+      }
+    if (fp) fclose(fp);
+    free(buf);
+    }
+
+  if (BenchOpt(mode, "-k"))                     // Cold run into the cache
+    {
+    sprintf(cache, "%s.dsk", name);
+    DeleteFileA(cache);
+    o.cache = cache;
+    OutInit(&ob, NULL);
+    DasmFile(name, &ob, &o);
+    OutFree(&ob);
+    }
+
+  OutInit(&ob, NULL);
+  if (BenchOpt(mode, "-") && (fd = open(name, O_RDONLY|O_BINARY)) != ERR)
+    {
+    DasmStream(fd, &ob, &o);
+    close(fd);
+    }
+  else if (newfile[0]) DasmDiff(name, newfile, &ob, &o);
+  else DasmFile(name, &ob, &o);
+  if (o.cache) DeleteFileA(cache);
+  if (newfile[0]) DeleteFileA(newfile);
+  if (o.sig)
+    {
+    SigClose(&sig);
+    DeleteFileA(sigfile);
+    }
+  if (o.reg) RegClose(&reg);
+  for (i=0; !o.format && i<ob.len && ob.buf[i] != '\n'; i++);
+  for (; i<ob.len; i++) h = (h ^ (BYTE)ob.buf[i]) * FNVPRIME;
+  OutFree(&ob);
+  return h;
+  } // BenchGolden
+
+//-----------------------------------------------------------------------------
+//
+//                          BenchLarge
+//
+// An image over IMAGEWINDOW (firmware, then FF fill) in the temporary
+// file 'name', p[] the buffer of IMAGEWINDOW bytes: -r falls back to
+// the linear sweep, so the listing with -raf must be the one of -af
+// after the warning, the cross-reference included.
+//
+// Returns 0 if so, 1 on a mismatch.
+//
+static int BenchLarge(const char* name, BYTE* p, const DASMOPT* opt)
+  {
+  static const char warn[] = "Warning: image too large for -r, linear sweep\n\n";
+  DASMOPT o = *opt;
+  OUTBUF lin, flow;
+  FILE* fp;
+  char* w;
+  BOOL ok;
+
+  GenFirmware(p, ROMSIZE);
+  memset(&p[ROMSIZE], 0xFF, IMAGEWINDOW - ROMSIZE);
+  if ((fp = fopen(name, "wb")) == NULL) return 1;
+  ok = fwrite(p, 1, IMAGEWINDOW, fp) == IMAGEWINDOW && fwrite(&p[ROMSIZE], 1, ROMSIZE, fp) == ROMSIZE;
+  if (fclose(fp) != 0 || !ok) return 1;
+
+  o.labels = o.parallel = o.sim = o.cycles = 0;
+  o.cache = NULL;
+  o.sig = NULL;
+  o.reg = NULL;
+  o.format = FMT_TEXT;
+  o.cpu = DASM6805_HC05;
+  o.fill = o.xref = TRUE;
+  OutInit(&lin, NULL);
+  o.flow = FALSE;
+  DasmFile(name, &lin, &o);
+  OutInit(&flow, NULL);
+  o.flow = TRUE;
+  DasmFile(name, &flow, &o);
+
+  OutMem(&lin, "", 1);                          // NUL terminated
+  OutMem(&flow, "", 1);
+  lin.len--;
+  flow.len--;
+  ok = FALSE;
+  if ((w = strstr(flow.buf, warn)) != NULL)
+    {
+    memmove(w, w + sizeof(warn)-1, flow.len - (w - flow.buf) - (sizeof(warn)-1));
+    flow.len -= sizeof(warn)-1;
+    ok = flow.len == lin.len && memcmp(flow.buf, lin.buf, lin.len) == 0 &&
+         strstr(lin.buf, "; Direct page cross-reference") != NULL;
+    }
+  printf("Large    -raf %u bytes %s\n", (unsigned)(IMAGEWINDOW + ROMSIZE), ok ? "ok" : "MISMATCH");
+  OutFree(&flow);
+  OutFree(&lin);
+  return ok ? 0 : 1;
+  } // BenchLarge
+
+//-----------------------------------------------------------------------------
+//
+//                          BenchDiff
+//
+// --diff of ROMSIZE bytes of lda #nn against a copy with a nop
+// inserted at $2AAA and the lda at $5554 changed to ldx: exactly two
+// hunks, "@@ -2AAA,0 +2AAA,1 @@" and "@@ -5554,1 +5555,1 @@", one
+// instruction removed and two added. 'name' is the temporary file,
+// p[] a buffer of 2*ROMSIZE bytes.
+//
+// Returns 0 if so, 1 otherwise.
+//
+static int BenchDiff(const char* name, BYTE* p, const DASMOPT* opt)
+  {
+  DWORD ins = (ROMSIZE/3) & ~1, chg = (2*ROMSIZE/3) & ~1, i;
+  char newfile[MAX_PATH+8], want[3][48];
+  DASMOPT o = *opt;
+  OUTBUF ob;
+  BOOL ok;
+  int hunks;
+
+  for (i=0; i<ROMSIZE; i+=2)
+    {
+    p[i] = 0xA6;                                // lda #nn
+    p[i+1] = (BYTE)(i >> 1);
+    }
+  memcpy(&p[ROMSIZE], p, ins);
+  p[ROMSIZE + ins] = 0x9D;                      // nop
+  memcpy(&p[ROMSIZE + ins + 1], &p[ins], ROMSIZE - ins);
+  p[ROMSIZE + chg + 1] = 0xAE;                  // ldx #nn
+  sprintf(newfile, "%s.new", name);
+  if (!BenchWrite(name, p, ROMSIZE) || !BenchWrite(newfile, &p[ROMSIZE], ROMSIZE + 1)) return 1;
+
+  sprintf(want[0], "@@ -%04X,0 +%04X,1 @@\n", (unsigned)ins, (unsigned)ins);
+  sprintf(want[1], "@@ -%04X,1 +%04X,1 @@\n", (unsigned)chg, (unsigned)chg + 1);
+  strcpy(want[2], "\n2 hunks, 1 instructions removed, 2 added\n");
+  o.cpu = DASM6805_HC05;
+  o.reg = NULL;
+  OutInit(&ob, NULL);
+  hunks = DasmDiff(name, newfile, &ob, &o);
+  DeleteFileA(newfile);
+  OutMem(&ob, "", 1);                           // NUL terminated
+  ok = hunks == 2;
+  for (i=0; i<3; i++) ok = ok && strstr(ob.buf, want[i]) != NULL;
+  printf("Diff     --diff %d hunks %s\n", hunks, ok ? "ok" : "MISMATCH");
+  OutFree(&ob);
+  return ok ? 0 : 1;
+  } // BenchDiff
+
+//-----------------------------------------------------------------------------
+//
+//                          BenchHexFile
+//
+// Write p[0..n-1] without the gap g0..g1-1 to the hex file 'name' of
+// 'kind', 16 bytes per record. S-records: S1 below the gap, then S2,
+// S3 in the upper half. Intel HEX: data after an 04 record below the
+// gap, then relative to an 02 segment of $1000, an 04 record of 0 in
+// the upper half. With 'bad' the first data record has a wrong
+// checksum.
+//
+static BOOL BenchHexFile(const char* name, const BYTE* p, DWORD n, DWORD g0, DWORD g1, int kind, BOOL bad)
+  {
+  DWORD a, k, i, upper = ERR, seg;
+  BYTE rec[24];
+  FILE* fp;
+  BOOL ok;
+  int t;
+
+  if ((fp = fopen(name, "w")) == NULL) return FALSE;
+  for (a=0; a<n; a+=k)
+    {
+    if (a == g0 && g0 < g1) a = g1;
+    k = (a < g0 ? g0 : n) - a;
+    if (k > 16) k = 16;
+    seg = (a < g1 || g0 == g1) ? 0 : (a < n/2 ? 0x1000 : 0);
+    if (kind == HEX_SREC)                       // Sn cc aa.. dd.. ss
+      {
+      t = (a < g0) ? 1 : (a < n/2) ? 2 : 3;
+      rec[0] = (BYTE)(t + 2 + k);
+      for (i=1; i<=(DWORD)t+1; i++) rec[i] = (BYTE)(a >> 8*(t+1-i));
+      fputc('S', fp);
+      fputc('0' + t, fp);
+      }
+    else                                        // :ll aaaa tt dd.. cc
+      {
+      if (seg != upper)
+        fprintf(fp, seg ? ":02000002%04X%02X\n" : ":020000040000FA\n", (unsigned)(seg >> 4),
+                (unsigned)((0x100 - 4 - (seg >> 12) - ((seg >> 4) & 0xFF)) & 0xFF));
+      upper = seg;
+      rec[0] = (BYTE)k;
+      rec[1] = (BYTE)((a - seg) >> 8);
+      rec[2] = (BYTE)(a - seg);
+      rec[3] = 0x00;
+      i = 4;
+      fputc(':', fp);
+      }
+    memcpy(&rec[i], &p[a], k);
+    i += k;
+    rec[i] = 0;
+    for (t=0; t<(int)i; t++) rec[i] += rec[t];
+    rec[i] = (BYTE)((kind == HEX_SREC ? ~rec[i] : -rec[i]) + (bad && a == 0));
+    for (t=0; t<=(int)i; t++) fprintf(fp, "%02X", rec[t]);
+    fputc('\n', fp);
+    }
+  fputs(kind == HEX_SREC ? "S9030000FC\n" : ":00000001FF\n", fp);
+  ok = !ferror(fp);
+  return fclose(fp) == 0 && ok;
+  } // BenchHexFile
+
+//-----------------------------------------------------------------------------
+//
+//                          BenchText
+//
+// List the file 'name' into 'ob', NUL terminated, without its last
+// line (the line count). Returns the listing after its first line
+// (the file name).
+//
+static char* BenchText(const char* name, OUTBUF* ob, const DASMOPT* o)
+  {
+  char* s;
+
+  OutInit(ob, NULL);
+  DasmFile(name, ob, o);
+  OutMem(ob, "", 1);
+  for (s=ob->buf+ob->len-2; s>ob->buf && s[-1] != '\n'; s--);
+  *s = 0;
+  return (s = strchr(ob->buf, '\n')) != NULL ? s+1 : ob->buf;
+  } // BenchText
+
+//-----------------------------------------------------------------------------
+//
+//                          BenchHex
+//
+// The firmware input at ROMSIZE, as S-records and as Intel HEX (see
+// BenchHexFile) with a gap at an instruction boundary in the lower
+// half: the listing is the one of the binary with the gap filled with
+// nop, an org line in place of the nops. Without a gap the listings
+// with -r (of the flat copy of the hex file) are the same. A record
+// with a bad checksum fails the load. 'name' is the temporary file,
+// p[] a buffer of ROMSIZE bytes.
+//
+// Returns the number of mismatches.
+//
+static int BenchHex(const char* name, BYTE* p, const DASMOPT* opt)
+  {
+  static const char* const ext[2] = {"s19", "hex"};
+  char file[MAX_PATH+8], org[40], *b, *h, *s0, *s1;
+  DWORD g0, g1;
+  DASMOPT o = *opt;
+  OUTBUF bin, hex;
+  IMAGE im;
+  int k, errors = 0;
+  BOOL ok;
+
+  GenFirmware(p, ROMSIZE);
+  p[ROMSIZE-2] = p[ROMSIZE-1] = 0;
+  for (g0=0; g0<ROMSIZE/4; g0+=opDesc6805[p[g0]].len);
+  g1 = g0 + 0x0C00;
+  memset(&p[g0], 0x9D, g1 - g0);                // nop
+  o.labels = o.flow = o.parallel = o.fill = o.xref = o.sim = o.cycles = 0;
+  o.cache = NULL;
+  o.sig = NULL;
+  o.reg = NULL;
+  o.format = FMT_TEXT;
+  o.cpu = DASM6805_HC05;
+  if (!BenchWrite(name, p, ROMSIZE)) return 1;
+
+  for (k=0; k<2; k++)
+    {
+    sprintf(file, "%s.%s", name, ext[k]);
+    ok = BenchHexFile(file, p, ROMSIZE, g0, g1, k ? HEX_INTEL : HEX_SREC, FALSE);
+    o.flow = FALSE;                             // Gap: binary with an org line
+    b = BenchText(name, &bin, &o);
+    h = BenchText(file, &hex, &o);
+    sprintf(org, "\n%04X  ", (unsigned)g0);
+    s0 = strstr(b, org);
+    sprintf(org, "\n%04X  ", (unsigned)g1);
+    s1 = strstr(b, org);
+    sprintf(org, "\n\n%04X  \t\t\t\torg\t$%04X", (unsigned)g1, (unsigned)g1);
+    ok = ok && s0 && s1 && strncmp(h, b, s0 - b) == 0 && strncmp(h + (s0 - b), org, strlen(org)) == 0 &&
+         strcmp(h + (s0 - b) + strlen(org), s1) == 0;
+    OutFree(&hex);
+    OutFree(&bin);
+
+    ok = ok && BenchHexFile(file, p, ROMSIZE, g0, g0, k ? HEX_INTEL : HEX_SREC, FALSE);
+    o.flow = TRUE;                              // No gap, -r: the same listing
+    b = BenchText(name, &bin, &o);
+    h = BenchText(file, &hex, &o);
+    ok = ok && strcmp(b, h) == 0;
+    OutFree(&hex);
+    OutFree(&bin);
+
+    ok = ok && BenchHexFile(file, p, ROMSIZE, g0, g1, k ? HEX_INTEL : HEX_SREC, TRUE);
+    ok = ok && ImageOpen(&im, file) == ERR;     // Bad checksum
+    DeleteFileA(file);
+    printf("Hex      %-8s gap $%04X..$%04X, -r, checksum %s\n", ext[k], (unsigned)g0, (unsigned)g1 - 1,
+           ok ? "ok" : "MISMATCH");
+    if (!ok) errors++;
+    }
+  return errors;
+  } // BenchHex
+
+//-----------------------------------------------------------------------------
+//
+//                          BenchGrep
+//
+// The pattern search (-g) in images of nop with a few instructions at
+// known addresses, and near misses of them. "jsr $1234" alone has 5
+// first bytes, searched with vector compares; with "brset 3,$40,*"
+// there are 13, more than GREPBYTES, searched by the table. Then
+// "ldy #$1234" in an M68HC11 image, the prebyte $18 the first byte.
+// The matches must be the addresses in benchGrep[], in this order.
+// 'name' is the temporary file, p[] a buffer of ROMSIZE bytes.
+//
+// Returns the number of mismatches.
+//
+static int BenchGrep(const char* name, BYTE* p, const DASMOPT* opt)
+  {
+  static const struct {
+    int cpu;
+    const char* pat[2];
+    BOOL vector;                                // Vector compare
+    DWORD addr[6];                              // The matches, ERR ends
+    } benchGrep[] = {
+    {DASM6805_HC05, {"jsr $1234", NULL},              TRUE,  {0x0100, 0x2345, 0x7000, ERR}},
+    {DASM6805_HC05, {"jsr $1234", "brset 3,$40,*"},   FALSE, {0x0100, 0x0200, 0x2345, 0x4001, 0x7000, ERR}},
+    {DASM6805_HC11, {"ldy #$1234", NULL},             TRUE,  {0x0100, 0x0201, ERR}},
+    };
+  static const BYTE jsr[] = {0xCD, 0x12, 0x34}, jsr2[] = {0xCD, 0x12, 0x35}, jsrd[] = {0xBD, 0x34};
+  static const BYTE brset[] = {0x06, 0x40, 0xFD}, brset2[] = {0x04, 0x40, 0xFD}, brset3[] = {0x06, 0x41, 0xFD};
+  static const BYTE ldy[] = {0x18, 0xCE, 0x12, 0x34}, ldx[] = {0xCE, 0x12, 0x34}, ldy2[] = {0x18, 0xCE, 0x12, 0x35};
+  static GREP grep;
+  DASMOPT o = *opt;
+  OUTBUF ob;
+  char* s;
+  int k, i, n, errors = 0;
+  BOOL ok;
+
+  for (k=0; k<(int)(sizeof(benchGrep)/sizeof(benchGrep[0])); k++)
+    {
+    if (benchGrep[k].cpu == DASM6805_HC05)
+      {
+      memset(p, 0x9D, ROMSIZE);                 // nop
+      memcpy(&p[0x0100], jsr, sizeof(jsr));
+      memcpy(&p[0x2345], jsr, sizeof(jsr));
+      memcpy(&p[0x7000], jsr, sizeof(jsr));
+      memcpy(&p[0x0300], jsr2, sizeof(jsr2));
+      memcpy(&p[0x0400], jsrd, sizeof(jsrd));
+      memcpy(&p[0x0200], brset, sizeof(brset));
+      memcpy(&p[0x4001], brset, sizeof(brset));
+      memcpy(&p[0x0500], brset2, sizeof(brset2));
+      memcpy(&p[0x0600], brset3, sizeof(brset3));
+      }
+    else
+      {
+      memset(p, 0x01, ROMSIZE);                 // nop
+      memcpy(&p[0x0100], ldy, sizeof(ldy));
+      memcpy(&p[0x0201], ldy, sizeof(ldy));
+      memcpy(&p[0x0300], ldx, sizeof(ldx));
+      memcpy(&p[0x0400], ldy2, sizeof(ldy2));
+      }
+    if (!BenchWrite(name, p, ROMSIZE)) return errors + 1;
+
+    grep.count = 0;
+    for (i=0; i<2 && benchGrep[k].pat[i]; i++) GrepAdd(&grep, benchGrep[k].pat[i]);
+    GrepCompile(&grep, benchGrep[k].cpu);
+    o.grep = &grep;
+    OutInit(&ob, NULL);
+    n = GrepFile(name, &ob, &o);
+    OutMem(&ob, "", 1);                         // NUL terminated
+
+    ok = (grep.nbyte != 0) == benchGrep[k].vector;
+    for (i=0, s=ob.buf; ok && benchGrep[k].addr[i] != (DWORD)ERR; i++)
+      {
+      ok = strncmp(s, name, strlen(name)) == 0 && s[strlen(name)] == ':' &&
+           strtoul(s + strlen(name) + 1, &s, 16) == benchGrep[k].addr[i];
+      s = strchr(s, '\n');
+      if (s) s++;
+      else ok = FALSE;
+      }
+    ok = ok && n == i && *s == 0;
+    printf("Grep     %-8s %s%s%s (%s) %d matches %s\n", benchGrep[k].cpu == DASM6805_HC11 ? "hc11" : "hc05",
+           benchGrep[k].pat[0], benchGrep[k].pat[1] ? "; " : "", benchGrep[k].pat[1] ? benchGrep[k].pat[1] : "",
+           benchGrep[k].vector ? "vector" : "table", n, ok ? "ok" : "MISMATCH");
+    if (!ok) errors++;
+    OutFree(&ob);
+    }
+  return errors;
+  } // BenchGrep
+
+//-----------------------------------------------------------------------------
+//
+//                          BenchServe
+//
+// The query server (-q) on the firmware input at BENCHSIZE (plain and
+// with -l -f) and as S-records with a gap: "l 0" with more lines than
+// the listing must give the listing of DasmFile, page by page, with
+// more pages than SRVCACHE for the first two. Then "b" and "a" of 300
+// lines at two addresses, the first one long evicted from the cache,
+// must give the lines before and around the item in that listing.
+// 'name' is the temporary file, p[] a buffer of BENCHSIZE bytes.
+//
+// Returns the number of mismatches.
+//
+static DWORD BenchLineAddr(const char* s)       // (as SrvLineAddr)
+  {
+  DWORD a = 0;
+  int n;
+
+  for (n=0; isxdigit((UCHAR)s[n]); n++)
+    a = (a << 4) | (isdigit((UCHAR)s[n]) ? s[n] - '0' : toupper(s[n]) - 'A' + 10);
+  return (n >= 4 && s[n] == SPACE) ? a : (DWORD)ERR;
+  } // BenchLineAddr
+
+static int BenchServe(const char* name, BYTE* p, const DASMOPT* opt)
+  {
+  static const char* const mode[3] = {"", "-lf", "s19"};
+  char file[MAX_PATH+8], query[MAX_PATH+8], answer[MAX_PATH+8], *text, *a, *e;
+  DWORD addr[2], *line = NULL, nline, alloc = 0, i, k, q, lo, hi;
+  DASMOPT o = *opt;
+  OUTBUF ob;
+  FILE *in, *out;
+  size_t n;
+  int m, errors = 0;
+  BOOL ok;
+
+  o.flow = o.parallel = o.xref = o.sim = o.cycles = 0;
+  o.cache = NULL;
+  o.sig = NULL;
+  o.reg = NULL;
+  o.user = NULL;
+  o.format = FMT_TEXT;
+  o.cpu = DASM6805_HC05;
+  sprintf(query, "%s.q", name);
+  sprintf(answer, "%s.a", name);
+  for (m=0; m<3; m++)
+    {
+    o.labels = o.fill = m == 1;
+    if (m < 2)
+      {
+      strcpy(file, name);
+      ok = BenchFile(&benchInput[4], p, BENCHSIZE, file);
+      addr[0] = 0x1005;
+      addr[1] = BENCHSIZE - 0x1000 + 3;
+      }
+    else
+      {
+      sprintf(file, "%s.s19", name);
+      GenFirmware(p, ROMSIZE);
+      ok = BenchHexFile(file, p, ROMSIZE, 0x2000, 0x2C00, HEX_SREC, FALSE);
+      addr[0] = 0x1005;
+      addr[1] = 0x2C00;                         // After the gap
+      }
+
+    // The listing of DasmFile without the blank lines around it (and
+    // the warning after it), its lines
+    text = BenchText(file, &ob, &o) + 1;
+    for (e=text+strlen(text); e>text+1 && !(e[-2] == '\n' && e[-1] == '\n'); e--);
+    if (e > text) e[-1] = 0;
+    for (nline=0, e=text; *e; nline++)
+      {
+      if (nline + 1 >= alloc)
+        {
+        alloc = alloc ? 2*alloc : 65536;
+        OutOfMemory(line = (DWORD*)realloc(line, alloc * sizeof(DWORD)));
+        }
+      line[nline] = (DWORD)(e - text);
+      e = strchr(e, '\n') + 1;
+      }
+    line[nline] = (DWORD)(e - text);
+
+    if ((in = fopen(query, "w")) != NULL)
+      {
+      fprintf(in, "l 0 %u\n", (unsigned)nline + 100);
+      for (q=0; q<2; q++) fprintf(in, "b %X 300\na %X 300\n", (unsigned)addr[q], (unsigned)addr[q]);
+      fputs("q\n", in);
+      ok = fclose(in) == 0 && ok;
+      }
+    in = fopen(query, "r");
+    out = fopen(answer, "w+b");
+    ok = ok && in && out && DasmServe(file, &o, in, out) == 0;
+    a = NULL;
+    if (ok)
+      {
+      n = ftell(out);
+      OutOfMemory(a = (char*)malloc(n + 1));
+      fseek(out, 0, SEEK_SET);
+      a[fread(a, 1, n, out)] = 0;
+      }
+    if (in) fclose(in);
+    if (out) fclose(out);
+
+    // Answer 1: the listing, then 'b' and 'a' of each address
+    e = a;
+    for (q=0; ok && q<5; q++)
+      {
+      if (q == 0) lo = 0, hi = nline;
+      else
+        {
+        for (k=0, i=0; i<nline; i++)            // The line of the item, its label
+          {
+          if ((lo = BenchLineAddr(&text[line[i]])) == (DWORD)ERR) continue;
+          if (lo > addr[(q-1)/2]) break;
+          k = i;
+          }
+        while (k > 0 && line[k] - line[k-1] > 1 && BenchLineAddr(&text[line[k-1]]) == (DWORD)ERR) k--;
+        lo = (q & 1) ? (k > 300 ? k - 300 : 0) : (k > 150 ? k - 150 : 0);
+        hi = (q & 1) ? k : (k + 150 < nline ? k + 150 : nline);
+        }
+      n = line[hi] - line[lo];
+      ok = strncmp(e, &text[line[lo]], n) == 0 && strncmp(e + n, ".\n", 2) == 0;
+      e += n + 2;
+      }
+    ok = ok && *e == 0;
+
+    printf("Serve    %-8s %u lines, b/a $%X $%X %s\n", mode[m], (unsigned)nline, (unsigned)addr[0],
+           (unsigned)addr[1], ok ? "ok" : "MISMATCH");
+    if (!ok) errors++;
+    free(a);
+    OutFree(&ob);
+    if (m == 2) DeleteFileA(file);
+    }
+  DeleteFileA(query);
+  DeleteFileA(answer);
+  free(line);
+  return errors;
+  } // BenchServe
+
+//-----------------------------------------------------------------------------
+//
+//                          BenchSeek
+//
+// Dasm6805Seek of every address of the record files (-m b) of the
+// firmware input in the temporary file 'name' (plain, -r -f and as
+// M68HC11 code with -r) against the record covering it, as noted by a
+// run over all the records; the file without its last byte finds
+// none. p[] is the buffer of ROMSIZE bytes.
+//
+// Returns 0 if all match, 1 for each mismatching file.
+//
+static int BenchSeek(const char* name, BYTE* p, const DASMOPT* opt)
+  {
+  static const char* const mode[] = {"", "-r -f", "--cpu hc11 -r"};
+  const DASMREC **cover, *rec;
+  const DASMRECTAIL* t;
+  DASMOPT o = *opt;
+  OUTBUF ob;
+  DWORD a, i;
+  int m, errors = 0;
+  BOOL ok;
+
+  GenFirmware(p, ROMSIZE);
+  if (!BenchWrite(name, p, ROMSIZE)) return 1;
+  OutOfMemory(cover = (const DASMREC**)malloc((ROMSIZE + (1 << DASMREC_SHIFT)) * sizeof(DASMREC*)));
+  o.labels = o.parallel = o.xref = FALSE;
+  o.sim = o.cycles = 0;
+  o.cache = NULL;
+  o.sig = NULL;
+  o.reg = NULL;
+  o.format = FMT_REC;
+  for (m=0; m<3; m++)
+    {
+    o.flow = BenchOpt(mode[m], "-r");
+    o.fill = BenchOpt(mode[m], "-f");
+    o.cpu = BenchOpt(mode[m], "--cpu hc11") ? DASM6805_HC11 : DASM6805_HC05;
+    o.vectors = o.cpu == DASM6805_HC11 ? FLOWVECTORS11 : opt->vectors;
+    OutInit(&ob, NULL);
+    DasmFile(name, &ob, &o);
+    ok = ob.len > sizeof(DASMRECTAIL);
+    t = (const DASMRECTAIL*)(ob.buf + ob.len - sizeof(DASMRECTAIL));
+    rec = (const DASMREC*)ob.buf;
+    memset(cover, 0, (ROMSIZE + (1 << DASMREC_SHIFT)) * sizeof(DASMREC*));
+    for (i=0; ok && i<t->count; i++)
+      for (a=rec[i].addr; a<rec[i].addr+rec[i].len && a<ROMSIZE; a++) cover[a] = &rec[i];
+    for (a=0; ok && a<ROMSIZE+(1 << DASMREC_SHIFT); a++)
+      ok = Dasm6805Seek(ob.buf, ob.len, a) == cover[a] && Dasm6805Seek(ob.buf, ob.len - 1, a) == NULL;
+    printf("Seek     %-13s %u records %s\n", mode[m], ok ? (unsigned)t->count : 0, ok ? "ok" : "MISMATCH");
+    if (!ok) errors++;
+    OutFree(&ob);
+    }
+  free(cover);
+  return errors;
+  } // BenchSeek
+
+//-----------------------------------------------------------------------------
+//
+//                          BenchSimImage
+//
+// The simulator loop at $0100 with its jump table and routines in
+// ROMSIZE bytes of nop at p[], reset to $0100.
+//
+static void BenchSimImage(BYTE* p)
+  {
+  int n;
+
+  memset(p, 0x9D, ROMSIZE);                     // nop
+  memcpy(&p[0x100], benchSimCode, sizeof(benchSimCode));
+  memcpy(&p[0x300], benchSimTable, sizeof(benchSimTable));
+  for (n=4; n<8; n++) memcpy(&p[n << 8], benchSimSub, sizeof(benchSimSub));
+  p[ROMSIZE-2] = 0x01;                          // Reset: $0100
+  p[ROMSIZE-1] = 0x00;
+  } // BenchSimImage
+
+//-----------------------------------------------------------------------------
+//
+//                          BenchXref
+//
+// The cross-reference (-a) of the simulator image in the temporary
+// file 'name': $80 is read by lda $0103, inc $010F and lda $0111,
+// written by sta $0101 and inc $010F, never bit tested.
+//
+// Returns 0 if so, 1 otherwise.
+//
+static int BenchXref(const char* name, BYTE* p)
+  {
+  static const DWORD rd[] = {0x0103, 0x010F, 0x0111}, wr[] = {0x0101, 0x010F};
+  const DWORD* from[XREFKINDS];
+  DWORD n[XREFKINDS];
+  XREF xref;
+  IMAGE im;
+  BOOL ok;
+  int k;
+
+  BenchSimImage(p);
+  if (!BenchWrite(name, p, ROMSIZE) || ImageOpen(&im, name) == ERR) return 1;
+  im.cpu = DASM6805_HC05;
+  memset(&xref, 0, sizeof(XREF));
+  XrefScan(&im, &xref, NULL);
+  ImageClose(&im);
+
+  for (k=0; k<XREFKINDS; k++) from[k] = XrefFind(&xref, 0x80, k, &n[k]);
+  ok = n[XREF_READ] == 3 && memcmp(from[XREF_READ], rd, sizeof(rd)) == 0 &&
+       n[XREF_WRITE] == 2 && memcmp(from[XREF_WRITE], wr, sizeof(wr)) == 0 &&
+       n[XREF_BIT] == 0;
+  printf("Xref     -a $80 r%u w%u t%u %s\n", (unsigned)n[XREF_READ], (unsigned)n[XREF_WRITE],
+         (unsigned)n[XREF_BIT], ok ? "ok" : "MISMATCH");
+  XrefFree(&xref);
+  return ok ? 0 : 1;
+  } // BenchXref
+
+//-----------------------------------------------------------------------------
+//
+//                          BenchCycles
+//
+// The cycle budget (-u) of the simulator image in the temporary file
+// 'name'. A round of the loop at $0100 by the M68HC05 data sheet:
+// clra 3, sta 4, lda 3, tax 2, lslx 3, stx 4, add 3, tax 2, jsr ,x 7
+// (the routine it calls not counted), inc 5, lda 3, cmp 2, bne 3 and
+// bra 3 are 47 cycles, 37 of them the inner loop at $0103 (without
+// clra, sta and bra).
+//
+// Returns 0 if so, 1 otherwise.
+//
+static int BenchCycles(const char* name, BYTE* p, const DASMOPT* opt)
+  {
+  static const char* want[] = {
+    "; Cycle budget: 1 routines, 1 vectored, 3 blocks, 2 loops, 47 cycles\n",
+    ";         47         47      3     2  $0100 L..C ",
+    ";         47  $0100  $0117 ",
+    ";         37  $0103  $0103 "};
+  DASMOPT o = *opt;
+  OUTBUF ob;
+  BOOL ok;
+  int i;
+
+  BenchSimImage(p);
+  if (!BenchWrite(name, p, ROMSIZE)) return 1;
+  o.labels = o.flow = o.parallel = o.fill = o.xref = o.sim = 0;
+  o.cache = NULL;
+  o.sig = NULL;
+  o.reg = NULL;
+  o.format = FMT_TEXT;
+  o.cpu = DASM6805_HC05;
+  o.cycles = 10;
+  OutInit(&ob, NULL);
+  DasmFile(name, &ob, &o);
+  OutMem(&ob, "", 1);                           // NUL terminated
+  for (ok=TRUE, i=0; i<(int)(sizeof(want)/sizeof(want[0])); i++) ok = ok && strstr(ob.buf, want[i]) != NULL;
+  printf("Cycles   -u $0100 47 cycles %s\n", ok ? "ok" : "MISMATCH");
+  OutFree(&ob);
+  return ok ? 0 : 1;
+  } // BenchCycles
+
+//-----------------------------------------------------------------------------
+//
+//                          BenchSimRun
+//
+// The simulator (-x) on the simulator image: the four routines behind
+// jsr $0300,x (the jump table to $0400, $0500, $0600 and $0700) are
+// marked as executed, which -r alone can't find. Then an image of
+// 64K+1 bytes of nop with stop at $1000 and the reset vector in its
+// last two bytes, across the bank: the run ends on the first
+// instruction. p[] holds 64K+1 bytes and the bitmap after them.
+//
+// Returns 0 if so, 1 otherwise.
+//
+static int BenchSimRun(BYTE* p, const DASMOPT* opt)
+  {
+  BYTE* exec = p + ROMSIZE;
+  DASMOPT o = *opt;
+  SIMSTATS st;
+  BOOL ok;
+  int n;
+
+  BenchSimImage(p);
+  memset(exec, 0, ROMSIZE/8 + 1);
+  o.sim = 100000;
+  o.map = NULL;
+  ok = SimRun(p, ROMSIZE, &o, exec, &st);
+  for (n=4; n<8; n++) ok = ok && BITTST(exec, n << 8);
+
+  exec = p + 0x10001;
+  memset(p, 0x9D, 0x10001);                     // nop
+  p[0x1000] = 0x8E;                             // stop
+  p[0xFFFF] = 0x10;                             // Reset: $1000
+  p[0x10000] = 0x00;
+  memset(exec, 0, 0x10001/8 + 1);
+  ok = SimRun(p, 0x10001, &o, exec, &st) && ok && st.insns == 1 && strcmp(st.stop, "stop") == 0;
+  printf("Sim      -x $0400..$0700, reset across 64K %s\n", ok ? "ok" : "MISMATCH");
+  return ok ? 0 : 1;
+  } // BenchSimRun
+
+//-----------------------------------------------------------------------------
+//
+//                          DasmBench
+//
+// Benchmark (-b): check the golden listings, then measure decode-only
+// (Dasm6805Decode), format-only (DasmRender of the decoded records,
+// also with the register map of the MC68HC705C8A) and end-to-end
+// (DasmFile to the NUL device, also with --stats) in input MB/s, and
+// the M68HC05 simulator in instructions per second.
+//
+// Returns the number of golden listing mismatches, ERR if the
+// temporary file can't be written.
+//
+int DasmBench(const DASMOPT* opt)
+  {
+  char dir[MAX_PATH], name[MAX_PATH], line[LINEMAX];
+  DASMINSN* rec;
+  SIMSTATS st;
+  DASMSTATS stats;
+  BENCHCLOCK::time_point t0;
+  double t, best[5];
+  unsigned long long h;
+  size_t k, i, pos, sum = 0;
+  DASMOPT o = *opt;
+  REGMAP reg;
+  OUTBUF ob;
+  FILE* fp;
+  BYTE* p;
+  int n, g, run, errors = 0;
+
+  if (!GetTempPathA(sizeof(dir), dir) || !GetTempFileNameA(dir, "dsm", 0, name)) return ERR;
+  OutOfMemory(p = (BYTE*)malloc(4*BENCHSIZE));
+  OutOfMemory(rec = (DASMINSN*)malloc(BENCHREC * sizeof(DASMINSN)));
+
+  // -------- Golden listings --------
+  //
+  for (n=0; n<BENCHINPUTS; n++)
+    {
+    if (!BenchFile(&benchInput[n], p, ROMSIZE, name)) { errors = ERR; break; }
+    for (g=0; g<(int)(sizeof(benchGold)/sizeof(benchGold[0])); g++)
+      {
+      if (benchGold[g].input != n) continue;
+      h = BenchGolden(name, benchGold[g].mode, opt);
+      printf("Golden %-8s %-20s %016llX %s\n", benchInput[n].name, benchGold[g].mode, h,
+             h == benchGold[g].hash ? "ok" : "MISMATCH");
+      if (h != benchGold[g].hash) errors++;
+      }
+    }
+  if (errors != ERR) errors += BenchLarge(name, p, opt);
+  if (errors != ERR) errors += BenchDiff(name, p, opt);
+  if (errors != ERR) errors += BenchXref(name, p);
+  if (errors != ERR) errors += BenchCycles(name, p, opt);
+  if (errors != ERR) errors += BenchSimRun(p, opt);
+  if (errors != ERR) errors += BenchHex(name, p, opt);
+  if (errors != ERR) errors += BenchGrep(name, p, opt);
+  if (errors != ERR) errors += BenchServe(name, p, opt);
+  if (errors != ERR) errors += BenchSeek(name, p, opt);
+
+  // -------- Throughput --------
+  //
+  if (errors != ERR)
+    {
+    o.parallel = o.flow = o.labels = FALSE;
+    o.cache = NULL;
+    o.format = FMT_TEXT;
+    o.cpu = DASM6805_HC05;
+    o.reg = NULL;
+    RegOpen(&reg, "705c8a");
+    printf("\n%-8s %10s %12s %12s %12s %12s %12s\n", "Input", "Bytes", "Decode MB/s", "Format MB/s",
+           "Regs MB/s", "Listing MB/s", "Stats MB/s");
+    for (n=0; n<BENCHINPUTS; n++)
+      {
+      if (!BenchFile(&benchInput[n], p, benchInput[n].size, name)) { errors = ERR; break; }
+      best[0] = best[1] = best[2] = best[3] = best[4] = 1e9;
+
+      for (run=0; run<BENCHRUNS; run++)
+        {
+        // Decode only
+        t0 = BENCHCLOCK::now();
+        for (pos=0; pos<benchInput[n].size; pos=rec[k-1].addr + rec[k-1].len)
+          {
+          k = Dasm6805Decode(&p[pos], benchInput[n].size - pos, (uint32_t)pos, rec, BENCHREC);
+          sum += rec[k-1].mne;
+          }
+        if ((t = BenchSeconds(t0)) < best[0]) best[0] = t;
+
+        // Format only
+        t = 0;
+        for (pos=0; pos<benchInput[n].size; pos=rec[k-1].addr + rec[k-1].len)
+          {
+          k = Dasm6805Decode(&p[pos], benchInput[n].size - pos, (uint32_t)pos, rec, BENCHREC);
+          t0 = BENCHCLOCK::now();
+          for (i=0; i<k; i++) sum += DasmRender<Isa6805>(line, rec[i].bytes, rec[i].addr, rec[i].len, NULL, NULL, NULL, NULL) - line;
+          t += BenchSeconds(t0);
+          }
+        if (t < best[1]) best[1] = t;
+
+        // Format only, with the register names (-i)
+        t = 0;
+        for (pos=0; pos<benchInput[n].size; pos=rec[k-1].addr + rec[k-1].len)
+          {
+          k = Dasm6805Decode(&p[pos], benchInput[n].size - pos, (uint32_t)pos, rec, BENCHREC);
+          t0 = BENCHCLOCK::now();
+          for (i=0; i<k; i++) sum += DasmRender<Isa6805>(line, rec[i].bytes, rec[i].addr, rec[i].len, NULL, NULL, &reg, NULL) - line;
+          t += BenchSeconds(t0);
+          }
+        if (t < best[4]) best[4] = t;
+
+        // End to end: image file to listing
+        if ((fp = fopen("NUL", "wb")) == NULL) break;
+        OutInit(&ob, fp);
+        t0 = BENCHCLOCK::now();
+        DasmFile(name, &ob, &o);
+        OutFlush(&ob);
+        if ((t = BenchSeconds(t0)) < best[2]) best[2] = t;
+
+        // The same with the counters of --stats
+        StatInit(&stats, o.cpu);
+        ob.stats = &stats;
+        t0 = BENCHCLOCK::now();
+        DasmFile(name, &ob, &o);
+        OutFlush(&ob);
+        if ((t = BenchSeconds(t0)) < best[3]) best[3] = t;
+        sum += stats.op[0x9D];
+        OutFree(&ob);
+        fclose(fp);
+        }
+
+      printf("%-8s %10u %12.1f %12.1f %12.1f %12.1f %12.1f\n", benchInput[n].name, (unsigned)benchInput[n].size,
+             benchInput[n].size / best[0] / 1e6, benchInput[n].size / best[1] / 1e6,
+             benchInput[n].size / best[4] / 1e6, benchInput[n].size / best[2] / 1e6,
+             benchInput[n].size / best[3] / 1e6);
+      }
+    RegClose(&reg);
+    }
+
+  // -------- Simulator --------
+  //
+  if (errors != ERR)
+    {
+    o.sim = BENCHSIM;
+    o.map = NULL;
+    BenchSimImage(p);
+    best[0] = 1e9;
+    for (run=0; run<BENCHRUNS; run++)
+      {
+      memset(p + ROMSIZE, 0, ROMSIZE/8 + 1);
+      t0 = BENCHCLOCK::now();
+      SimRun(p, ROMSIZE, &o, p + ROMSIZE, &st);
+      if ((t = BenchSeconds(t0)) < best[0]) best[0] = t;
+      }
+    sum += st.addrs;
+    printf("\nSimulator %u cycles, %u instructions: %.1f M instructions/s (%s)\n",
+           (unsigned)st.cycles, (unsigned)st.insns, st.insns / best[0] / 1e6, st.stop);
+    }
+
+  DeleteFileA(name);
+  free(rec);
+  free(p);
+  if (errors == ERR) printf("Write failed on %s\n", name);
+  else printf("\n%d golden listing mismatches (checksum %u)\n", errors, (unsigned)sum);
+  return errors;
+  } // DasmBench
+
+//--------------------------end-of-c++-module-----------------------------------
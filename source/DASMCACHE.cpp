@@ -0,0 +1,361 @@
+// haDASM - Disassembler for Microchip processors
+// dasmcache.cpp - C++ Developer source file.
+// (c)1990-2023 by helmut altmann
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; see the file COPYING.  If not, write to
+// the Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+// Boston, MA 02111-1307, USA.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <windows.h>
+
+#include "equate.h"
+#include "extern.h"
+#include "dasmisa.h"
+
+// --------------------------------------------
+// Incremental listing cache (-k)
+// --------------------------------------------
+// The linear sweep is cut into fragments: fragment k holds the items
+// (instructions, fill runs, strings) that start in the k-th block of
+// CACHECHUNK bytes, so it begins at an instruction start. Its listing
+// text only depends on what the key hashes: the start address, the
+// bytes and item boundaries, the labels defined there, the names of
+// the branch and jump targets and the instruction set. The cache file keeps the text of every
+// fragment of the last run under its key. A rerun on a new firmware
+// revision renders only the fragments whose key is not in the file and
+// copies the others; the listing is the same as without -k.
+//
+// Cache file: CACHEHDR, then per fragment a CACHEREC and its text.
+//
+typedef struct tag_CACHEHDR {
+  DWORD  magic;             // CACHEMAGIC
+  DWORD  version;           // CACHEVERSION
+  DWORD  count;             // Number of fragments
+  DWORD  chunk;             // CACHECHUNK
+} CACHEHDR;
+
+typedef struct tag_CACHEREC {
+  unsigned long long key;   // FNV-1a of the fragment input (CacheKey)
+  DWORD  pc;                // First item
+  DWORD  end;               // Address following the last item
+  DWORD  lines;             // Source lines of the text
+  DWORD  len;               // Chars of the text
+} CACHEREC;
+
+typedef struct tag_CACHEOLD {
+  CACHEREC rec;
+  const char* text;         // Text in the loaded file
+} CACHEOLD;
+
+typedef struct tag_CACHE {
+  BYTE*  file;              // Loaded cache file of the previous run
+  CACHEOLD* old;            // Its fragments
+  DWORD  count;
+  DWORD* slot;              // Hash table: index+1 into old[], 0 = empty
+  DWORD  mask;
+  const char* name;         // Cache file
+  FILE*  fp;                // New cache file, NULL = not (yet) opened
+  DWORD  same;              // Fragments old[0..same-1] held back
+  DWORD  written;           // Fragments in the new file
+  BOOL   failed;            // Write error
+} CACHE;
+
+static inline unsigned long long CacheMix(unsigned long long h, DWORD v)
+  {
+  h = (h ^ (v & 0xFF)) * FNVPRIME;
+  h = (h ^ ((v >> 8) & 0xFF)) * FNVPRIME;
+  h = (h ^ ((v >> 16) & 0xFF)) * FNVPRIME;
+  return (h ^ (v >> 24)) * FNVPRIME;
+  } // CacheMix
+
+static inline unsigned long long CacheBytes(unsigned long long h, const BYTE* p, DWORD n)
+  {
+  while (n--) h = (h ^ *p++) * FNVPRIME;
+  return h;
+  } // CacheBytes
+
+// The symbol of address 'addr' as it shows in the listing
+static unsigned long long CacheSym(unsigned long long h, const SYMTAB* st, DWORD addr)
+  {
+  const SYMENT* e = SymFind(st, addr);
+
+  h = CacheMix(h, e ? e->name & SYMDEF : 0);
+  if (e && (e->name & ~SYMDEF))
+    h = CacheBytes(h, (const BYTE*)&st->pool[e->name & ~SYMDEF], strlen(&st->pool[e->name & ~SYMDEF]) + 1);
+  return h;
+  } // CacheSym
+
+//-----------------------------------------------------------------------------
+//
+//                          CacheKey
+//
+// Walk the items of the fragment from address 'pc' (the whole image is
+// at data[0..size-1]) like DasmRange(pc, stop) does, without rendering.
+// Returns the key of the fragment and the address following it in *end.
+//
+template<class ISA>
+static unsigned long long CacheKey(const BYTE* data, DWORD size, const OUTBUF* ob,
+                                   DWORD pc, DWORD stop, DWORD* end)
+  {
+  unsigned long long h = FNVBASIS;
+  const OPDESC* d;
+  const RUNENT* r;
+  DWORD lim, n, t, k = 0;
+
+  h = CacheMix(h, (ob->sym ? 1 : 0) | (ob->run ? 2 : 0) | (ISA::cpu << 2) | (ob->xref ? 16 : 0) |
+                 (ob->reg ? 32 : 0));
+  if (ob->xref)                                 // The counts noted on the lines
+    {
+    h = CacheMix(h, (DWORD)ob->xref->key);
+    h = CacheMix(h, (DWORD)(ob->xref->key >> 32));
+    }
+  if (ob->reg)                                  // The register names
+    {
+    h = CacheMix(h, (DWORD)ob->reg->key);
+    h = CacheMix(h, (DWORD)(ob->reg->key >> 32));
+    }
+  h = CacheMix(h, pc);
+  if (ob->run) k = RunSeek(ob->run, pc);
+
+  while (pc < stop)
+    {
+    if (ob->sym) h = CacheSym(h, ob->sym, pc);  // Label line
+
+    lim = size;
+    r = NULL;
+    if (ob->run)
+      {
+      while (k < ob->run->count && ob->run->run[k].addr + ob->run->run[k].len <= pc) k++;
+      if (k < ob->run->count && ob->run->run[k].addr <= pc) r = &ob->run->run[k];
+      else if (k < ob->run->count) lim = ob->run->run[k].addr;
+      }
+
+    if (r)                                      // Fill run or string
+      {
+      n = r->addr + r->len - pc;
+      h = CacheMix(h, n | r->kind << 31);
+      h = (r->kind == RUN_FILL) ? CacheMix(h, r->fill) : CacheBytes(h, &data[pc], n);
+      pc += n;
+      continue;
+      }
+
+    d = ISA::Desc(&data[pc], lim - pc);
+    n = d->len > lim - pc ? lim - pc : d->len;
+    h = CacheMix(h, n);
+    h = CacheBytes(h, &data[pc], n);
+    if (ob->sym && n == d->len && (t = FlowTarget(d, &data[pc], pc)) != (DWORD)ERR)
+      h = CacheSym(h, ob->sym, t);              // Target name
+    pc += n;
+    }
+
+  *end = pc;
+  return h;
+  } // CacheKey
+
+//-----------------------------------------------------------------------------
+//
+//                          CacheLoad
+//
+// Load the cache file 'name' of the previous run and index its
+// fragments. A missing, foreign or damaged file is an empty cache.
+//
+static void CacheLoad(CACHE* c, const char* name)
+  {
+  CACHEHDR hdr;
+  CACHEREC rec;
+  size_t size, pos;
+  FILE* fp;
+  DWORD n, i;
+
+  memset(c, 0, sizeof(CACHE));
+  c->name = name;
+  if ((fp = fopen(name, "rb")) == NULL) return;
+  fseek(fp, 0, SEEK_END);
+  size = ftell(fp);
+  fseek(fp, 0, SEEK_SET);
+  c->file = (BYTE*)malloc(size + 1);
+  if (c->file == NULL || fread(c->file, 1, size, fp) != size || size < sizeof(CACHEHDR))
+    size = 0;
+  fclose(fp);
+
+  if (size) memcpy(&hdr, c->file, sizeof(CACHEHDR));
+  if (size == 0 || hdr.magic != CACHEMAGIC || hdr.version != CACHEVERSION || hdr.chunk != CACHECHUNK ||
+      hdr.count > size / sizeof(CACHEREC))
+    return;
+
+  OutOfMemory(c->old = (CACHEOLD*)malloc(hdr.count * sizeof(CACHEOLD) + 1));
+  for (c->mask=1; c->mask < 2*hdr.count; c->mask <<= 1);
+  OutOfMemory(c->slot = (DWORD*)calloc(c->mask--, sizeof(DWORD)));
+
+  for (pos=sizeof(CACHEHDR), n=0; n<hdr.count; n++)
+    {
+    if (size - pos < sizeof(CACHEREC)) break;
+    memcpy(&rec, &c->file[pos], sizeof(CACHEREC));
+    pos += sizeof(CACHEREC);
+    if (size - pos < rec.len) break;            // Cut off
+
+    c->old[n].rec = rec;
+    c->old[n].text = (const char*)&c->file[pos];
+    pos += rec.len;
+    for (i=(DWORD)rec.key & c->mask; c->slot[i]; i=(i+1) & c->mask);
+    c->slot[i] = n+1;
+    }
+  c->count = n;
+  } // CacheLoad
+
+// The fragment with key 'key' at 'pc' of the previous run, NULL = miss
+static const CACHEOLD* CacheFind(const CACHE* c, unsigned long long key, DWORD pc, DWORD end)
+  {
+  const CACHEOLD* o;
+  DWORD i;
+
+  if (c->count == 0) return NULL;
+  for (i=(DWORD)key & c->mask; c->slot[i]; i=(i+1) & c->mask)
+    {
+    o = &c->old[c->slot[i]-1];
+    if (o->rec.key == key && o->rec.pc == pc && o->rec.end == end) return o;
+    }
+  return NULL;
+  } // CacheFind
+
+static void CacheWrite(CACHE*, const CACHEREC*, const char*, const CACHEOLD*);
+
+// Open the new cache file and write the fragments held back so far
+static void CacheOpen(CACHE* c)
+  {
+  CACHEHDR hdr;
+  DWORD n, i;
+
+  memset(&hdr, 0, sizeof(CACHEHDR));            // Valid after the last fragment
+  if ((c->fp = fopen(c->name, "wb")) == NULL || fwrite(&hdr, sizeof(CACHEHDR), 1, c->fp) != 1)
+    c->failed = TRUE;
+  n = c->same;
+  c->same = 0;
+  for (i=0; i<n; i++) CacheWrite(c, &c->old[i].rec, c->old[i].text, NULL);
+  } // CacheOpen
+
+// Append a fragment to the new cache file. As long as the fragments are
+// those of the previous run in turn ('o' = old[same]), nothing is written.
+static void CacheWrite(CACHE* c, const CACHEREC* rec, const char* text, const CACHEOLD* o)
+  {
+  if (c->fp == NULL && !c->failed)
+    {
+    if (o != NULL && o == &c->old[c->same])
+      {
+      c->same++;
+      return;
+      }
+    CacheOpen(c);
+    }
+  if (c->failed) return;
+  if (fwrite(rec, sizeof(CACHEREC), 1, c->fp) != 1 || fwrite(text, 1, rec->len, c->fp) != rec->len)
+    c->failed = TRUE;
+  else c->written++;
+  } // CacheWrite
+
+//-----------------------------------------------------------------------------
+//
+//                          DasmImageCache
+//
+// Linear sweep disassembly of the image 'im' into 'ob' with the listing
+// cache file opt->cache (-k). The listing is identical to
+// DasmRange(im, ob, 0, size). The cache file is replaced by the
+// fragments of this run (unless they are all the same as before),
+// the hits and misses are reported on stderr.
+//
+// Returns the number of source lines produced.
+//
+int DasmImageCache(IMAGE* im, OUTBUF* ob, const DASMOPT* opt)
+  {
+  const CACHEOLD* o;
+  CACHEHDR hdr;
+  CACHEREC rec;
+  CACHE c;
+  OUTBUF frag;
+  DWORD pc, stop, end, size = im->size, hits = 0, misses = 0;
+  int n, lines = 0;
+
+  if (im->kind != HEX_NONE || size > IMAGEWINDOW || !ImageWindow(im, 0))
+    {
+    fprintf(stderr, "Cache %s: not used for %s\n", opt->cache,
+            im->kind != HEX_NONE ? "hex files" : "images this large");
+    DasmRange(im, ob, 0, size, &lines);
+    return lines;
+    }
+
+  // The previous run is in memory, the new cache file replaces it
+  CacheLoad(&c, opt->cache);
+
+  OutInit(&frag, NULL);
+  frag.sym = ob->sym;
+  frag.run = ob->run;
+  frag.stats = ob->stats;                       // Counts the misses only
+  frag.xref = ob->xref;
+  frag.reg = ob->reg;
+
+  for (pc=0; pc<size; pc=end)
+    {
+    stop = (pc / CACHECHUNK + 1) * CACHECHUNK;
+    if (stop > size) stop = size;
+
+    rec.key = ISACALL(im->cpu, CacheKey, (im->data, size, ob, pc, stop, &end));
+    rec.pc  = pc;
+    rec.end = end;
+
+    if ((o = CacheFind(&c, rec.key, pc, end)) != NULL)
+      {
+      OutMem(ob, o->text, o->rec.len);
+      lines += o->rec.lines;
+      CacheWrite(&c, &o->rec, o->text, o);
+      hits++;
+      }
+    else
+      {
+      frag.len = 0;
+      n = 0;
+      DasmRange(im, &frag, pc, stop, &n);
+      OutMem(ob, frag.buf, frag.len);
+      lines += n;
+      rec.lines = n;
+      rec.len = (DWORD)frag.len;
+      CacheWrite(&c, &rec, frag.buf, NULL);
+      misses++;
+      }
+    } // end for
+
+  if (c.fp == NULL && !c.failed && c.same < c.count) CacheOpen(&c);  // Fewer fragments
+  if (c.fp)
+    {
+    hdr.magic = CACHEMAGIC;
+    hdr.version = CACHEVERSION;
+    hdr.count = c.written;
+    hdr.chunk = CACHECHUNK;
+    if (!c.failed && (fseek(c.fp, 0, SEEK_SET) || fwrite(&hdr, sizeof(CACHEHDR), 1, c.fp) != 1))
+      c.failed = TRUE;
+    if (fclose(c.fp)) c.failed = TRUE;
+    }
+  if (c.failed) fprintf(stderr, "Write failed on %s\n", opt->cache);
+  fprintf(stderr, "Cache %s: %u hits, %u misses\n", opt->cache, (unsigned)hits, (unsigned)misses);
+
+  OutFree(&frag);
+  free(c.slot);
+  free(c.old);
+  free(c.file);
+  return lines;
+  } // DasmImageCache
+
+//--------------------------end-of-c++-module-----------------------------------
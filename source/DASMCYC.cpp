@@ -0,0 +1,654 @@
+// haDASM - Disassembler for Microchip processors
+// dasmcyc.cpp - C++ Developer source file.
+// (c)1990-2023 by helmut altmann
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; see the file COPYING.  If not, write to
+// the Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+// Boston, MA 02111-1307, USA.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <windows.h>
+
+#include "equate.h"
+#include "extern.h"
+#include "dasmisa.h"
+
+// --------------------------------------------
+// Cycle budget (-u)
+// --------------------------------------------
+// The code reached by the flow trace (see FlowTrace) is cut into basic
+// blocks: a block starts at an entry point, at a branch, jump or call
+// target and after a branch, jump or return. Its cost is the sum of
+// the cycles of its instructions (the cycle column of the opcode
+// table). A routine is the code reached from a vector, a -e entry or
+// a call target without taking its calls; the same block may belong
+// to several routines (shared tails, tail jumps).
+//
+// The blocks of a routine are ordered by a depth first walk (reverse
+// postorder): an edge to a block that is not later in that order is a
+// back edge, its target a loop header. Without the back edges the
+// routine is acyclic and its worst path is the longest path from the
+// entry, each block charged its cycles plus the worst of the routines
+// it calls. So each loop is counted once: the bound of one pass, not
+// of the iterations, which the code alone doesn't tell. A loop is
+// reported with the cost of one iteration, the longest path from its
+// header to the branch back.
+//
+// The routines are evaluated in postorder of the call graph, callees
+// first. A call back into a routine still on the walk (recursion) and
+// the indexed jmp and jsr are not counted, the routine is flagged.
+//
+#define CYCNONE     0xFFFFFFFF  // No block
+#define CYCMAX      0xFFFFFFFF  // Saturated cycle count
+
+#define CYC_LOOP    0x01      // Flags of a routine: it has a loop
+#define CYC_REC     0x02      // a recursive call (not counted)
+#define CYC_IND     0x04      // an indexed jmp, its targets unknown
+#define CYC_CALL    0x08      // an indexed jsr or a call out of the code
+#define CYCFLAGS    4
+
+static const char cycFlag[CYCFLAGS] = {'L', 'R', 'I', 'C'};
+
+typedef struct tag_CYCBLOCK {
+  DWORD  addr;      // Address of the first instruction
+  DWORD  cycles;    // Sum of the cycles of its instructions
+  DWORD  succ[2];   // Successors: target, fall through (CYCNONE = none)
+  DWORD  call;      // Its calls: callee[call] up to the next block's
+  BYTE   flags;     // CYC_IND, CYC_CALL
+} CYCBLOCK;
+
+typedef struct tag_CYCFUNC {
+  DWORD  addr;      // Entry address
+  DWORD  block;     // Entry block
+  DWORD  body;      // Its blocks in reverse postorder: body[body..]
+  DWORD  nbody;
+  DWORD  cycles;    // Sum of the cycles of its blocks
+  DWORD  worst;     // Worst path, each loop once, with the calls
+  DWORD  loops;     // Number of loop headers
+  int    vector;    // Lowest vector (0 = reset) to it, ERR = none
+  BYTE   flags;     // CYC_xxx
+  BYTE   state;     // Call graph walk: 0 new, 1 on the stack, 2 walked, 3 done
+} CYCFUNC;
+
+typedef struct tag_CYCLOOP {
+  DWORD  head;      // Address of the loop header
+  DWORD  tail;      // Address of the block that branches back
+  DWORD  cycles;    // One iteration: longest path from head to tail
+  DWORD  func;      // The routine it was found in
+} CYCLOOP;
+
+typedef struct tag_CYC {
+  CYCBLOCK* blk;    // Blocks by ascending address, blk[nblk] ends the calls
+  DWORD  nblk;
+  DWORD* callee;    // Routines called by the blocks
+  CYCFUNC* func;    // Routines by ascending entry address
+  DWORD  nfunc;
+  DWORD* body;      // Blocks of the routines
+  DWORD  nbody;
+  DWORD  abody;
+  CYCLOOP* loop;
+  DWORD  nloop;
+  DWORD  aloop;
+} CYC;
+
+static inline DWORD CycAdd(DWORD a, DWORD b)
+  {
+  return a + b < a ? CYCMAX : a + b;
+  } // CycAdd
+
+// Index of the block (routine) at address 'a', CYCNONE if none
+static DWORD CycBlock(const CYC* c, DWORD a)
+  {
+  DWORD lo = 0, hi = c->nblk, m;
+
+  while (lo < hi)
+    {
+    m = (lo + hi) / 2;
+    if (c->blk[m].addr < a) lo = m + 1;
+    else hi = m;
+    }
+  return lo < c->nblk && c->blk[lo].addr == a ? lo : CYCNONE;
+  } // CycBlock
+
+static DWORD CycFunc(const CYC* c, DWORD a)
+  {
+  DWORD lo = 0, hi = c->nfunc, m;
+
+  while (lo < hi)
+    {
+    m = (lo + hi) / 2;
+    if (c->func[m].addr < a) lo = m + 1;
+    else hi = m;
+    }
+  return lo < c->nfunc && c->func[lo].addr == a ? lo : CYCNONE;
+  } // CycFunc
+
+//-----------------------------------------------------------------------------
+//
+//                          CycBlocks
+//
+// Cut the reached instructions (bitmap 'start', below 'top') into the
+// basic blocks of 'c' and collect the routine entries: the vectors
+// (the lowest one of a routine kept), the -e entries and the call
+// targets. The call sites hold the target address until CycRoutines.
+//
+template<class ISA>
+static void CycBlocks(CYC* c, const BYTE* data, DWORD size, DWORD top, const DASMOPT* opt,
+                      const BYTE* start)
+  {
+  const OPDESC* d;
+  BYTE* lead;
+  CYCBLOCK* b;
+  DWORD pc, t, n, ncall = 0, nfunc;
+  int k;
+
+  OutOfMemory(lead = (BYTE*)calloc(1, top/8 + 1));
+  c->nblk = 0;
+  c->nfunc = 0;
+
+  // Leaders: the entries, the targets and the instructions after a transfer
+  for (k=0; k<opt->vectors && 2*(DWORD)(k+1) <= size; k++)
+    {
+    n = size - 2*(k+1);
+    if ((t = (n & 0xFFFF0000) | (data[n] << 8) | data[n+1]) < top && BITTST(start, t))
+      BITSET(lead, t);
+    }
+  for (k=0; k<opt->nentry; k++)
+    if (opt->entry[k] < top && BITTST(start, opt->entry[k])) BITSET(lead, opt->entry[k]);
+  for (pc=0; pc<top; pc++)
+    if (BITTST(start, pc))
+      {
+      d = ISA::Desc(&data[pc], top - pc);
+      if ((t = FlowTarget(d, &data[pc], pc)) < top && BITTST(start, t)) BITSET(lead, t);
+      if (d->flow == FC_CALL) ncall++;
+      if ((d->flow == FC_BRANCH || d->flow == FC_JUMP || d->flow == FC_RET) &&
+          pc + d->len < top && BITTST(start, pc + d->len)) BITSET(lead, pc + d->len);
+      }
+  for (pc=0; pc<top; pc++) if (BITTST(lead, pc)) c->nblk++;
+
+  nfunc = opt->vectors + opt->nentry + ncall;
+  OutOfMemory(c->blk = (CYCBLOCK*)calloc(c->nblk + 1, sizeof(CYCBLOCK)));
+  OutOfMemory(c->callee = (DWORD*)malloc((ncall + 1) * sizeof(DWORD)));
+  OutOfMemory(c->func = (CYCFUNC*)calloc(nfunc + 1, sizeof(CYCFUNC)));
+
+  // The blocks, successors and call sites by address
+  b = c->blk;
+  ncall = 0;
+  for (pc=0; pc<top; pc++)
+    {
+    if (!BITTST(lead, pc)) continue;
+    b->addr = pc;
+    b->succ[0] = b->succ[1] = CYCNONE;
+    b->call = ncall;
+    for (n=pc; ; )
+      {
+      d = ISA::Desc(&data[n], top - n);
+      b->cycles += d->cycles;
+      t = FlowTarget(d, &data[n], n);
+      if (d->flow == FC_JUMP && t == (DWORD)ERR) b->flags |= CYC_IND;
+      if (t >= top || !BITTST(start, t)) t = CYCNONE;
+      if (d->flow == FC_CALL)
+        {
+        if (t == CYCNONE) b->flags |= CYC_CALL;
+        else c->callee[ncall++] = t;
+        }
+      else if (d->flow == FC_JUMP)
+        {
+        b->succ[0] = t;
+        break;
+        }
+      else if (d->flow == FC_BRANCH) b->succ[0] = t;
+      if (d->flow == FC_RET) break;
+
+      n += d->len;                              // Falls through
+      if (n >= top || !BITTST(start, n)) break;
+      if (d->flow == FC_BRANCH || BITTST(lead, n))
+        {
+        b->succ[1] = n;
+        break;
+        }
+      }
+    b++;
+    }
+  b->call = ncall;
+
+  // The routine entries, the successors as block indexes
+  for (k=0; k<opt->vectors && 2*(DWORD)(k+1) <= size; k++)
+    {
+    n = size - 2*(k+1);
+    if ((t = (n & 0xFFFF0000) | (data[n] << 8) | data[n+1]) < top && BITTST(start, t))
+      {
+      c->func[c->nfunc].addr = t;
+      c->func[c->nfunc++].vector = k;
+      }
+    }
+  for (k=0; k<opt->nentry; k++)
+    if (opt->entry[k] < top && BITTST(start, opt->entry[k]))
+      {
+      c->func[c->nfunc].addr = opt->entry[k];
+      c->func[c->nfunc++].vector = ERR;
+      }
+  for (n=0; n<ncall; n++)
+    {
+    c->func[c->nfunc].addr = c->callee[n];
+    c->func[c->nfunc++].vector = ERR;
+    }
+  for (b=c->blk; b<c->blk + c->nblk; b++)
+    for (k=0; k<2; k++)
+      if (b->succ[k] != CYCNONE) b->succ[k] = CycBlock(c, b->succ[k]);
+  free(lead);
+  } // CycBlocks
+
+// Routine entries by address, then vector (the lowest first)
+static int CycFuncOrder(const void* a, const void* b)
+  {
+  const CYCFUNC* x = (const CYCFUNC*)a;
+  const CYCFUNC* y = (const CYCFUNC*)b;
+
+  if (x->addr != y->addr) return x->addr < y->addr ? -1 : 1;
+  if (x->vector != y->vector)
+    return (DWORD)x->vector < (DWORD)y->vector ? -1 : 1; // (ERR last)
+  return 0;
+  } // CycFuncOrder
+
+//-----------------------------------------------------------------------------
+//
+//                          CycRoutines
+//
+// The routines of 'c' from the collected entries, each entry once,
+// with their blocks in reverse postorder; the call sites as routine
+// indexes. 'stack', 'next' and 'order' are scratch of nblk entries,
+// 'stamp' is cleared to 0.
+//
+static void CycRoutines(CYC* c, DWORD* stack, BYTE* next, DWORD* order, DWORD* stamp)
+  {
+  CYCFUNC* f;
+  DWORD i, n, b, s, sp;
+
+  qsort(c->func, c->nfunc, sizeof(CYCFUNC), CycFuncOrder);
+  for (i=0, n=0; i<c->nfunc; i++)
+    if (n == 0 || c->func[i].addr != c->func[n-1].addr) c->func[n++] = c->func[i];
+  c->nfunc = n;
+  for (i=0; i<c->blk[c->nblk].call; i++) c->callee[i] = CycFunc(c, c->callee[i]);
+
+  for (f=c->func; f<c->func + c->nfunc; f++)
+    {
+    f->block = CycBlock(c, f->addr);
+    f->body = c->nbody;
+
+    // Depth first walk, the blocks in postorder to order[]
+    stamp[f->block] = (DWORD)(f - c->func) + 1;
+    stack[0] = f->block;
+    next[0] = 0;
+    for (sp=1, n=0; sp; )
+      {
+      b = stack[sp-1];
+      if (next[sp-1] < 2)
+        {
+        s = c->blk[b].succ[next[sp-1]++];
+        if (s != CYCNONE && stamp[s] != (DWORD)(f - c->func) + 1)
+          {
+          stamp[s] = (DWORD)(f - c->func) + 1;
+          stack[sp] = s;
+          next[sp++] = 0;
+          }
+        }
+      else
+        order[n++] = stack[--sp];
+      }
+
+    f->nbody = n;
+    if (c->nbody + n > c->abody)
+      {
+      while (c->nbody + n > c->abody) c->abody = c->abody ? 2*c->abody : 4096;
+      OutOfMemory(c->body = (DWORD*)realloc(c->body, c->abody * sizeof(DWORD)));
+      }
+    while (n) c->body[c->nbody++] = order[--n];
+    }
+  } // CycRoutines
+
+//-----------------------------------------------------------------------------
+//
+//                          CycCallOrder
+//
+// The routines of 'c' to order[] in postorder of the call graph,
+// callees before their callers. A call to a routine still on the walk
+// flags the caller as recursive. 'stack' and 'at' (next body position
+// and call of each level) are scratch of nfunc entries.
+//
+static void CycCallOrder(CYC* c, DWORD* order, DWORD* stack, DWORD* at)
+  {
+  CYCFUNC* f;
+  DWORD i, g, b, sp, n = 0;
+
+  for (i=0; i<c->nfunc; i++)
+    {
+    if (c->func[i].state) continue;
+    c->func[i].state = 1;
+    stack[0] = i;
+    at[0] = 0;
+    at[1] = c->blk[c->body[c->func[i].body]].call;
+    for (sp=1; sp; )
+      {
+      f = &c->func[stack[sp-1]];
+      if (at[2*sp-2] >= f->nbody)
+        {
+        f->state = 2;
+        order[n++] = stack[--sp];
+        continue;
+        }
+      b = c->body[f->body + at[2*sp-2]];
+      if (at[2*sp-1] == c->blk[b+1].call)       // Next block
+        {
+        if (++at[2*sp-2] < f->nbody) at[2*sp-1] = c->blk[c->body[f->body + at[2*sp-2]]].call;
+        continue;
+        }
+      g = c->callee[at[2*sp-1]++];
+      if (c->func[g].state == 1) f->flags |= CYC_REC;
+      else if (c->func[g].state == 0)
+        {
+        c->func[g].state = 1;
+        stack[sp] = g;
+        at[2*sp] = 0;
+        at[2*sp+1] = c->blk[c->body[c->func[g].body]].call;
+        sp++;
+        }
+      }
+    }
+  } // CycCallOrder
+
+//-----------------------------------------------------------------------------
+//
+//                          CycRoutine
+//
+// Cycle sum, worst path and loops of the routine 'f' of 'c', its
+// callees done. 'pos' holds the position of each block in the body
+// of 'f' ('stamp' marks the body), 'cost', 'dist' and 'tail' are
+// scratch of nbody entries. 'head' marks the loop headers already
+// reported (one report per header for all the routines).
+//
+static void CycRoutine(CYC* c, CYCFUNC* f, DWORD* pos, DWORD* stamp, DWORD* cost, DWORD* dist,
+                       DWORD* tail, BYTE* head)
+  {
+  const DWORD* body = &c->body[f->body];
+  const CYCBLOCK* b;
+  const CYCFUNC* g;
+  DWORD i, j, q, s, mark = (DWORD)(f - c->func) + 1;
+  int k;
+
+  for (i=0; i<f->nbody; i++)
+    {
+    pos[body[i]] = i;
+    stamp[body[i]] = mark;
+    tail[i] = CYCNONE;
+    }
+
+  // The cost of each block: its cycles and the worst of its callees
+  for (i=0; i<f->nbody; i++)
+    {
+    b = &c->blk[body[i]];
+    f->cycles = CycAdd(f->cycles, b->cycles);
+    f->flags |= b->flags;
+    cost[i] = b->cycles;
+    for (j=b->call; j<(b+1)->call; j++)
+      {
+      g = &c->func[c->callee[j]];
+      if (g->state == 3) cost[i] = CycAdd(cost[i], g->worst);
+      else f->flags |= CYC_REC;
+      }
+    }
+
+  // Longest path over the forward edges, the back edges to tail[]
+  for (i=0; i<f->nbody; i++) dist[i] = 0;
+  dist[0] = cost[0];
+  for (i=0; i<f->nbody; i++)
+    {
+    if (dist[i] > f->worst) f->worst = dist[i];
+    for (k=0; k<2; k++)
+      {
+      if ((s = c->blk[body[i]].succ[k]) == CYCNONE || stamp[s] != mark) continue;
+      if ((q = pos[s]) > i)
+        {
+        if (CycAdd(dist[i], cost[q]) > dist[q]) dist[q] = CycAdd(dist[i], cost[q]);
+        }
+      else if (tail[q] == CYCNONE || i > tail[q]) tail[q] = i;
+      }
+    }
+
+  // One iteration of each loop: from the header to the last branch back
+  for (i=0; i<f->nbody; i++)
+    {
+    if (tail[i] == CYCNONE) continue;
+    f->loops++;
+    f->flags |= CYC_LOOP;
+    if (BITTST(head, body[i])) continue;
+    BITSET(head, body[i]);
+
+    for (j=i; j<=tail[i]; j++) dist[j] = 0;
+    dist[i] = cost[i];
+    for (j=i; j<=tail[i]; j++)
+      for (k=0; dist[j] && k<2; k++)
+        if ((s = c->blk[body[j]].succ[k]) != CYCNONE && stamp[s] == mark &&
+            (q = pos[s]) > j && q <= tail[i] && CycAdd(dist[j], cost[q]) > dist[q])
+          dist[q] = CycAdd(dist[j], cost[q]);
+
+    if (c->nloop == c->aloop)
+      {
+      c->aloop = c->aloop ? 2*c->aloop : 256;
+      OutOfMemory(c->loop = (CYCLOOP*)realloc(c->loop, c->aloop * sizeof(CYCLOOP)));
+      }
+    c->loop[c->nloop].head = c->blk[body[i]].addr;
+    c->loop[c->nloop].tail = c->blk[body[tail[i]]].addr;
+    c->loop[c->nloop].cycles = dist[tail[i]] ? dist[tail[i]] : cost[tail[i]]; // (irreducible)
+    c->loop[c->nloop++].func = (DWORD)(f - c->func);
+    }
+  f->state = 3;
+  } // CycRoutine
+
+// Report order: the worst first, then by address
+static int CycWorstOrder(const void* a, const void* b)
+  {
+  const CYCFUNC* x = *(const CYCFUNC* const*)a;
+  const CYCFUNC* y = *(const CYCFUNC* const*)b;
+
+  if (x->worst != y->worst) return x->worst > y->worst ? -1 : 1;
+  return x->addr < y->addr ? -1 : x->addr > y->addr;
+  } // CycWorstOrder
+
+static int CycLoopOrder(const void* a, const void* b)
+  {
+  const CYCLOOP* x = (const CYCLOOP*)a;
+  const CYCLOOP* y = (const CYCLOOP*)b;
+
+  if (x->cycles != y->cycles) return x->cycles > y->cycles ? -1 : 1;
+  return x->head < y->head ? -1 : x->head > y->head;
+  } // CycLoopOrder
+
+// The name of the routine at 'a': its label of 'sym' (NULL = none) or "Lxxxx"
+static char* CycName(char* s, const SYMTAB* sym, DWORD a)
+  {
+  const SYMENT* e;
+
+  if (sym && (e = SymFind(sym, a)) != NULL) return SymName(s, sym, e);
+  *s++ = 'L';
+  return PutAddr(s, a);
+  } // CycName
+
+// One report line of the routine 'f'
+static int CycLine(OUTBUF* ob, const CYCFUNC* f, int cpu)
+  {
+  char line[LINEMAX], *s;
+  int k;
+
+  s = line + sprintf(line, "; %10u %10u %6u %5u  $", (unsigned)f->worst, (unsigned)f->cycles,
+                     (unsigned)f->nbody, (unsigned)f->loops);
+  s = PutAddr(s, f->addr);
+  *s++ = ' ';
+  for (k=0; k<CYCFLAGS; k++) *s++ = f->flags & (1 << k) ? cycFlag[k] : '.';
+  *s++ = ' ';
+  s = CycName(s, ob->sym, f->addr);
+  if (f->vector != ERR) s += sprintf(s, " (%s)", FlowVector(cpu, f->vector));
+  *s++ = '\n';
+  OutMem(ob, line, s - line);
+  return 1;
+  } // CycLine
+
+//-----------------------------------------------------------------------------
+//
+//                          CycImage
+//
+// Cycle budget of the flat image data[0..size-1] ('code' marks the
+// gaps of a hex file) as comment lines to 'ob': the vectored routines,
+// the opt->cycles most expensive routines and loops.
+//
+// Returns the number of source lines produced.
+//
+template<class ISA>
+static int CycImage(OUTBUF* ob, const BYTE* data, DWORD size, const DASMOPT* opt, BYTE* start,
+                    BYTE* code)
+  {
+  CYC c;
+  CYCFUNC** rank;
+  DWORD *stamp, *pos, *scratch, i, n, top, cycles = 0;
+  BYTE *next, *head;
+  char line[LINEMAX], *s;
+  int lines = 0, vectors = 0;
+
+  memset(&c, 0, sizeof(c));
+  if (!FlowTrace(data, size, opt, start, code)) OutOfMemory(NULL);
+  top = size > 2*(DWORD)opt->vectors ? size - 2*opt->vectors : 0;
+  CycBlocks<ISA>(&c, data, size, top, opt, start);
+
+  n = c.nblk > c.nfunc ? c.nblk : c.nfunc;
+  OutOfMemory(stamp = (DWORD*)calloc(2*c.nblk + 1, sizeof(DWORD)));
+  OutOfMemory(scratch = (DWORD*)malloc((4*n + 2) * sizeof(DWORD)));
+  OutOfMemory(next = (BYTE*)malloc(c.nblk + 1));
+  OutOfMemory(head = (BYTE*)calloc(1, c.nblk/8 + 1));
+  OutOfMemory(rank = (CYCFUNC**)malloc((c.nfunc + 1) * sizeof(CYCFUNC*)));
+  pos = stamp + c.nblk;
+
+  CycRoutines(&c, scratch, next, scratch + n, stamp);
+  CycCallOrder(&c, scratch, scratch + n, scratch + 2*n);
+  for (i=0; i<c.nblk; i++) stamp[i] = 0;
+  for (i=0; i<c.nfunc; i++)                     // Callees first
+    CycRoutine(&c, &c.func[scratch[i]], pos, stamp, scratch + n, scratch + 2*n, scratch + 3*n, head);
+  for (i=0; i<c.nblk; i++) cycles = CycAdd(cycles, c.blk[i].cycles);
+
+  for (i=0; i<c.nfunc; i++)
+    {
+    rank[i] = &c.func[i];
+    if (c.func[i].vector != ERR) vectors++;
+    }
+  qsort(rank, c.nfunc, sizeof(CYCFUNC*), CycWorstOrder);
+  if (c.nloop) qsort(c.loop, c.nloop, sizeof(CYCLOOP), CycLoopOrder);
+
+  sprintf(line, "\n; Cycle budget: %u routines, %d vectored, %u blocks, %u loops, %u cycles\n",
+          (unsigned)c.nfunc, vectors, (unsigned)c.nblk, (unsigned)c.nloop, (unsigned)cycles);
+  OutStr(ob, line);
+  OutStr(ob, "; Worst: longest path with the worst of the calls, each loop once\n");
+  OutStr(ob, "; L loop, R recursion, I indexed jmp, C indexed jsr (not counted)\n");
+  lines += 4;
+
+  if (vectors)
+    {
+    OutStr(ob, ";\n; Vectored routines\n;      Worst     Cycles Blocks Loops  Entry Flag Routine\n");
+    lines += 3;
+    for (i=0; i<c.nfunc; i++)
+      if (rank[i]->vector != ERR) lines += CycLine(ob, rank[i], ISA::cpu);
+    }
+
+  if (c.nfunc)
+    {
+    sprintf(line, ";\n; The %u most expensive routines\n"
+                  ";      Worst     Cycles Blocks Loops  Entry Flag Routine\n",
+            (unsigned)(c.nfunc < (DWORD)opt->cycles ? c.nfunc : opt->cycles));
+    OutStr(ob, line);
+    lines += 3;
+    for (i=0; i<c.nfunc && i<(DWORD)opt->cycles; i++) lines += CycLine(ob, rank[i], ISA::cpu);
+    }
+
+  if (c.nloop)
+    {
+    sprintf(line, ";\n; The %u most expensive loops\n"
+                  ";  Iteration   Head   Back Routine\n",
+            (unsigned)(c.nloop < (DWORD)opt->cycles ? c.nloop : opt->cycles));
+    OutStr(ob, line);
+    lines += 3;
+    for (i=0; i<c.nloop && i<(DWORD)opt->cycles; i++)
+      {
+      s = line + sprintf(line, "; %10u  $", (unsigned)c.loop[i].cycles);
+      s = PutAddr(s, c.loop[i].head);
+      s = PutStr(s, "  $");
+      s = PutAddr(s, c.loop[i].tail);
+      *s++ = ' ';
+      s = CycName(s, ob->sym, c.func[c.loop[i].func].addr);
+      *s++ = '\n';
+      OutMem(ob, line, s - line);
+      lines++;
+      }
+    }
+
+  free(rank);
+  free(head);
+  free(next);
+  free(scratch);
+  free(stamp);
+  free(c.loop);
+  free(c.body);
+  free(c.func);
+  free(c.callee);
+  free(c.blk);
+  return lines;
+  } // CycImage
+
+//-----------------------------------------------------------------------------
+//
+//                          CycReport
+//
+// The cycle budget of the image 'im' after the listing in 'ob' (-u).
+// A hex file is analysed in a flat copy, its gaps taken, like -r.
+//
+// Returns the number of source lines produced.
+//
+int CycReport(OUTBUF* ob, IMAGE* im, const DASMOPT* opt)
+  {
+  BYTE *start, *code, *flat = NULL;
+  DWORD pc, g, size = im->size;
+  int lines;
+
+  if (im->kind != HEX_NONE) flat = HexFlat(im);
+  if (im->kind != HEX_NONE ? flat == NULL : (size > IMAGEWINDOW || !ImageWindow(im, 0)))
+    {
+    OutNote(ob, "\nWarning: image too large for -u\n");
+    return 2;
+    }
+
+  OutOfMemory(start = (BYTE*)calloc(2, size/8 + 1));
+  code = start + size/8 + 1;
+  if (flat)                                     // The gaps are taken
+    for (pc=0, g=0; pc<size; pc++)
+      {
+      while (im->seg[g].end <= pc) g++;
+      if (pc < im->seg[g].start) BITSET(code, pc);
+      }
+
+  lines = ISACALL(im->cpu, CycImage, (ob, flat ? flat : im->data, size, opt, start, code));
+  free(start);
+  free(flat);
+  return lines;
+  } // CycReport
+
+//--------------------------end-of-c++-module-----------------------------------
@@ -0,0 +1,343 @@
+// haDASM - Disassembler for Microchip processors
+// dasmdiff.cpp - C++ Developer source file.
+// (c)1990-2023 by helmut altmann
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; see the file COPYING.  If not, write to
+// the Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+// Boston, MA 02111-1307, USA.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <windows.h>
+
+#include "equate.h"
+#include "extern.h"
+#include "dasmisa.h"
+
+// --------------------------------------------
+// Instruction-aligned diff (--diff)
+// --------------------------------------------
+// Both images are decoded by the linear sweep into one token per
+// instruction: a 32 bit FNV-1a hash of its bytes, with the branch
+// displacements and the jmp/jsr operands masked. Code that only moved
+// (a byte inserted before it) gives the same tokens, so a one byte
+// change is one hunk, not a listing that differs from there on.
+//
+// The token sequences are compared by the O(ND) algorithm of Myers in
+// its linear space form (middle snake, divide and conquer), after the
+// common head and tail are taken off. A box whose edit distance
+// exceeds DIFFMAXD is given up as one replaced block, which bounds the
+// time on unrelated images. Tokens and the edit marks are all the
+// memory: 8 bytes and 2 bits per instruction; the hunks are rendered
+// from the image windows again.
+//
+// Output: per hunk a line "@@ -old,n +new,m @@" with the addresses
+// and instruction counts, then the removed lines ("-") and the added
+// lines ("+").
+//
+#define FNV32BASIS  0x811C9DC5
+#define FNV32PRIME  0x01000193
+
+typedef struct tag_DIFFSEQ {
+  IMAGE  im;
+  DWORD* hash;      // Tokens of the instructions
+  DWORD* addr;      // Their addresses
+  DWORD  count;
+  DWORD  alloc;
+  BYTE*  mark;      // Bitmap: instruction removed (old) or added (new)
+} DIFFSEQ;
+
+typedef struct tag_DIFF {
+  const DWORD* a;   // Old tokens
+  const DWORD* b;   // New tokens
+  BYTE*  del;       // Marks of a[]
+  BYTE*  ins;       // Marks of b[]
+  int*   vf;        // Forward and backward furthest x per diagonal
+  int*   vb;
+} DIFF;
+
+//-----------------------------------------------------------------------------
+//
+//                          DiffToken
+//
+// The token of the instruction 'd' at p[0], 'avail' bytes left: the
+// hash of its bytes, without the targets that move with the code.
+//
+template<class ISA>
+static inline DWORD DiffToken(const OPDESC* d, const BYTE* p, DWORD avail)
+  {
+  DWORD h = FNV32BASIS;
+  int i, n = d->len;
+
+  if (d->len > avail)                           // Cut by the end of the image
+    n = avail;
+  else if (d->flow == FC_JUMP || d->flow == FC_CALL)
+    n -= (d->mode == AM_IX) ? 0 : (d->mode == AM_EXT || d->mode == AM_IX2) ? 2 : 1;
+  else if (FlowTarget(d, p, 0) != (DWORD)ERR)
+    n--;                                        // The displacement is the last byte
+  for (i=0; i<n; i++) h = (h ^ p[i]) * FNV32PRIME;
+  return h ^ (d->len - n);                      // (masked bytes)
+  } // DiffToken
+
+//-----------------------------------------------------------------------------
+//
+//                          DiffLoad
+//
+// Decode the image of 's' (opened) into its tokens.
+//
+template<class ISA>
+static void DiffLoad(DIFFSEQ* s)
+  {
+  IMAGE* im = &s->im;
+  const OPDESC* d;
+  const BYTE* p;
+  DWORD pc, end;
+
+  for (pc=0; pc<im->size; )
+    {
+    end = im->base + im->len;
+    if (end < im->lim)                          // Keep a whole instruction in the window
+      end = (end > ISA::maxlen-1) ? end - (ISA::maxlen-1) : 0;
+
+    if (pc < im->base || pc >= end)
+      {
+      if (!ImageWindow(im, pc)) break;
+      if (pc < im->base) pc = im->base;         // A gap of a hex file
+      continue;
+      }
+
+    while (pc < end)
+      {
+      if (s->count == s->alloc)
+        {
+        s->alloc = s->alloc ? 2*s->alloc : 16384;
+        OutOfMemory(s->hash = (DWORD*)realloc(s->hash, s->alloc * sizeof(DWORD)));
+        OutOfMemory(s->addr = (DWORD*)realloc(s->addr, s->alloc * sizeof(DWORD)));
+        }
+      p = &im->data[pc - im->base];
+      d = ISA::Desc(p, im->lim - pc);
+      s->hash[s->count] = DiffToken<ISA>(d, p, im->lim - pc);
+      s->addr[s->count++] = pc;
+      pc += d->len;
+      if (pc > im->lim) pc = im->lim;
+      }
+    } // end for pc
+  } // DiffLoad
+
+//-----------------------------------------------------------------------------
+//
+//                          DiffSnake
+//
+// Find the middle snake of a[0..n-1] and b[0..m-1] (the box does not
+// start or end with equal tokens): the diagonal run (x0,y0)-(x1,y1)
+// in the middle of a shortest edit script.
+//
+// Returns the edit distance D, ERR if it exceeds DIFFMAXD.
+//
+static int DiffSnake(DIFF* df, const DWORD* a, int n, const DWORD* b, int m, int* xy)
+  {
+  int* vf = df->vf + DIFFMAXD + 1;              // v[-d-1..d+1]
+  int* vb = df->vb + DIFFMAXD + 1;
+  int delta = n - m, odd = delta & 1, d, k, x, y, x0, y0;
+
+  vf[1] = 0;
+  vb[1] = 0;
+  for (d=0; d<=(n+m+1)/2 && d<DIFFMAXD; d++)
+    {
+    for (k=-d; k<=d; k+=2)                      // Forward
+      {
+      x = (k == -d || (k != d && vf[k-1] < vf[k+1])) ? vf[k+1] : vf[k-1] + 1;
+      y = x - k;
+      x0 = x; y0 = y;
+      while (x < n && y < m && a[x] == b[y]) { x++; y++; }
+      vf[k] = x;
+      if (odd && delta-k >= -(d-1) && delta-k <= d-1 && vf[k] + vb[delta-k] >= n)
+        {
+        xy[0] = x0; xy[1] = y0; xy[2] = x; xy[3] = y;
+        return 2*d - 1;
+        }
+      }
+    for (k=-d; k<=d; k+=2)                      // Backward: x, y count from the ends
+      {
+      x = (k == -d || (k != d && vb[k-1] < vb[k+1])) ? vb[k+1] : vb[k-1] + 1;
+      y = x - k;
+      x0 = x; y0 = y;
+      while (x < n && y < m && a[n-1-x] == b[m-1-y]) { x++; y++; }
+      vb[k] = x;
+      if (!odd && delta-k >= -d && delta-k <= d && vb[k] + vf[delta-k] >= n)
+        {
+        xy[0] = n - x; xy[1] = m - y; xy[2] = n - x0; xy[3] = m - y0;
+        return 2*d;
+        }
+      }
+    }
+  return ERR;
+  } // DiffSnake
+
+//-----------------------------------------------------------------------------
+//
+//                          DiffBox
+//
+// Mark the removed a[x..x+n-1] and the added b[y..y+m-1] of a shortest
+// edit script of the two.
+//
+static void DiffBox(DIFF* df, DWORD x, int n, DWORD y, int m)
+  {
+  int xy[4], i;
+
+  while (n && m && df->a[x] == df->b[y]) { x++; y++; n--; m--; }          // Common head
+  while (n && m && df->a[x+n-1] == df->b[y+m-1]) { n--; m--; }            // Common tail
+
+  if (n && m && DiffSnake(df, &df->a[x], n, &df->b[y], m, xy) != ERR)
+    {
+    DiffBox(df, x, xy[0], y, xy[1]);
+    DiffBox(df, x + xy[2], n - xy[2], y + xy[3], m - xy[3]);
+    return;
+    }
+  for (i=0; i<n; i++) BITSET(df->del, x+i);     // One side empty, or too far apart
+  for (i=0; i<m; i++) BITSET(df->ins, y+i);
+  } // DiffBox
+
+// Render the listing lines of s->addr[i..j-1] with the prefix 'c'
+template<class ISA>
+static void DiffLines(OUTBUF* ob, DIFFSEQ* s, DWORD i, DWORD j, char c)
+  {
+  char line[LINEMAX], *e;
+  IMAGE* im = &s->im;
+  DWORD pc;
+
+  for (; i<j; i++)
+    {
+    pc = s->addr[i];
+    if (pc < im->base || pc >= im->base + im->len ||
+        (im->base + im->len < im->lim && pc + ISA::maxlen > im->base + im->len))
+      if (!ImageWindow(im, pc) || pc < im->base) continue;
+    line[0] = c;
+    e = DasmRender<ISA>(line + 1, &im->data[pc - im->base], pc, im->lim - pc, NULL, NULL, ob->reg, NULL);
+    *e++ = '\n';
+    OutMem(ob, line, e - line);
+    }
+  } // DiffLines
+
+//-----------------------------------------------------------------------------
+//
+//                          DiffHunks
+//
+// Write the hunks of the marked instructions of 'o' (old) and 'n' (new)
+// to 'ob'. Returns the number of hunks.
+//
+template<class ISA>
+static int DiffHunks(OUTBUF* ob, DIFFSEQ* o, DIFFSEQ* n)
+  {
+  char line[80], *s;
+  DWORD i = 0, j = 0, i1, j1;
+  int hunks = 0;
+
+  while (i < o->count || j < n->count)
+    {
+    if (i < o->count && j < n->count && !BITTST(o->mark, i) && !BITTST(n->mark, j))
+      {
+      i++; j++;                                 // Unchanged
+      continue;
+      }
+    for (i1=i; i1<o->count && BITTST(o->mark, i1); i1++);
+    for (j1=j; j1<n->count && BITTST(n->mark, j1); j1++);
+
+    s = PutStr(line, "@@ -");
+    s = PutAddr(s, i < o->count ? o->addr[i] : o->im.size);
+    s += sprintf(s, ",%u +", (unsigned)(i1 - i));
+    s = PutAddr(s, j < n->count ? n->addr[j] : n->im.size);
+    s += sprintf(s, ",%u @@\n", (unsigned)(j1 - j));
+    OutMem(ob, line, s - line);
+    DiffLines<ISA>(ob, o, i, i1, '-');
+    DiffLines<ISA>(ob, n, j, j1, '+');
+    hunks++;
+    i = i1;
+    j = j1;
+    }
+  return hunks;
+  } // DiffHunks
+
+//-----------------------------------------------------------------------------
+//
+//                          DasmDiff
+//
+// Instruction-aligned diff of the image files 'oldName' and 'newName'
+// (--diff) to 'ob', with the instruction set and the register map
+// (-i) of 'opt'.
+//
+// Returns the number of hunks, ERR if a file can't be opened.
+//
+int DasmDiff(const char* oldName, const char* newName, OUTBUF* ob, const DASMOPT* opt)
+  {
+  char line[64];
+  DIFFSEQ seq[2];
+  DIFF df;
+  DWORD del = 0, ins = 0, i;
+  int k, hunks = 0;
+
+  memset(seq, 0, sizeof(seq));
+  for (k=0; k<2; k++)
+    {
+    if (ImageOpen(&seq[k].im, k ? newName : oldName) == ERR)
+      {
+      OutStr(ob, "Open failed on ");               // Paths of any length
+      OutStr(ob, k ? newName : oldName);
+      OutStr(ob, "\n");
+      if (k) ImageClose(&seq[0].im);
+      free(seq[0].hash);
+      free(seq[0].addr);
+      return ERR;
+      }
+    seq[k].im.cpu = opt->cpu;
+    ISACALL(opt->cpu, DiffLoad, (&seq[k]));
+    OutOfMemory(seq[k].mark = (BYTE*)calloc(1, seq[k].count/8 + 1));
+    }
+
+  df.a = seq[0].hash;
+  df.b = seq[1].hash;
+  df.del = seq[0].mark;
+  df.ins = seq[1].mark;
+  OutOfMemory(df.vf = (int*)malloc((2*DIFFMAXD + 3) * sizeof(int)));
+  OutOfMemory(df.vb = (int*)malloc((2*DIFFMAXD + 3) * sizeof(int)));
+  DiffBox(&df, 0, seq[0].count, 0, seq[1].count);
+  free(df.vf);
+  free(df.vb);
+
+  OutStr(ob, "Diff of ");
+  OutStr(ob, oldName);
+  OutStr(ob, " and ");
+  OutStr(ob, newName);
+  OutStr(ob, "\n\n");
+  ob->reg = opt->reg;
+  hunks = ISACALL(opt->cpu, DiffHunks, (ob, &seq[0], &seq[1]));
+  ob->reg = NULL;
+  for (i=0; i<seq[0].count; i++) if (BITTST(seq[0].mark, i)) del++;
+  for (i=0; i<seq[1].count; i++) if (BITTST(seq[1].mark, i)) ins++;
+  sprintf(line, "\n%d hunks, %u instructions removed, %u added\n", hunks, (unsigned)del, (unsigned)ins);
+  OutStr(ob, line);
+
+  for (k=0; k<2; k++)
+    {
+    ImageClose(&seq[k].im);
+    free(seq[k].hash);
+    free(seq[k].addr);
+    free(seq[k].mark);
+    }
+  return hunks;
+  } // DasmDiff
+
+//--------------------------end-of-c++-module-----------------------------------
@@ -0,0 +1,171 @@
+// haDASM - Disassembler for Microchip processors
+// dasmfile.cpp - C++ Developer source file.
+// (c)1990-2023 by helmut altmann
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; see the file COPYING.  If not, write to
+// the Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+// Boston, MA 02111-1307, USA.
+
+#include <fcntl.h>
+#include <sys\types.h>
+#include <sys\stat.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <io.h>
+#include <windows.h>
+
+#include "equate.h"
+#include "extern.h"
+
+//-----------------------------------------------------------------------------
+//
+//                          ImageOpen
+//
+// Open the binary image file 'name' for windowed read access.
+// The file is memory mapped if possible. Otherwise (e.g. the file
+// can't be mapped) it is read window by window into a buffer of
+// IMAGEWINDOW bytes. Either way the extra memory is constant.
+// S-record and Intel HEX files are loaded into a sparse image
+// (see HexLoad).
+//
+// Returns ERR if the file can't be opened.
+//
+int ImageOpen(IMAGE* im, const char* name)
+  {
+  LARGE_INTEGER li;
+  SYSTEM_INFO si;
+  int kind;
+
+  memset(im, 0, sizeof(IMAGE));
+  if ((kind = HexKind(name)) != HEX_NONE) return HexLoad(im, name, kind);
+  if ((im->fh=open(name, O_RDONLY|O_BINARY)) == ERR) return ERR;
+
+  im->hFile = (HANDLE)_get_osfhandle(im->fh);
+  if (!GetFileSizeEx(im->hFile, &li) || li.QuadPart > 0xFFFFFFFFLL)
+    {
+    close(im->fh);
+    return ERR;
+    }
+  im->size = (DWORD)li.QuadPart;
+  im->lim  = im->size;
+
+  GetSystemInfo(&si);
+  im->gran = si.dwAllocationGranularity;
+
+  if (im->size) im->hMap = CreateFileMapping(im->hFile, NULL, PAGE_READONLY, 0, 0, NULL);
+  return 0;
+  } // ImageOpen
+
+//-----------------------------------------------------------------------------
+//
+//                          ImageWindow
+//
+// Make the image bytes at file offset 'offset' accessible:
+// im->data[0..len-1] holds the file bytes from offset im->base.
+// The window starts at, or a little before, 'offset'. The window of
+// a hex file may start after 'offset' (a gap, see HexWindow).
+//
+// Returns FALSE on a read error.
+//
+BOOL ImageWindow(IMAGE* im, DWORD offset)
+  {
+  DWORD base, len;
+
+  if (im->kind != HEX_NONE) return HexWindow(im, offset);
+  base = offset - offset % im->gran;            // Mapping must be aligned
+  len = im->size - base;
+  if (len > IMAGEWINDOW) len = IMAGEWINDOW;
+
+  if (im->view) UnmapViewOfFile(im->view);
+  im->view = NULL;
+
+  if (im->hMap)
+    {
+    im->view = (BYTE*)MapViewOfFile(im->hMap, FILE_MAP_READ, 0, base, len);
+    if (im->view == NULL && im->shared) return FALSE;
+    if (im->view == NULL)                       // Fall back to read()
+      {
+      CloseHandle(im->hMap);
+      im->hMap = NULL;
+      }
+    }
+
+  if (im->view) im->data = im->view;
+  else if (im->shared) return FALSE;            // (The file handle isn't ours)
+  else
+    {
+    if (im->rdbuf == NULL && (im->rdbuf = (BYTE*)malloc(IMAGEWINDOW)) == NULL)
+      return FALSE;
+    if (_lseeki64(im->fh, base, SEEK_SET) != base) return FALSE;
+    if ((DWORD)read(im->fh, im->rdbuf, len) != len) return FALSE;
+    im->data = im->rdbuf;
+    }
+
+  im->base = base;
+  im->len  = len;
+  return TRUE;
+  } // ImageWindow
+
+//-----------------------------------------------------------------------------
+//
+//                          ImageShare
+//
+// Make 'w' a read-only copy of the open binary image 'im' for another
+// thread (see DasmImagePar): it maps its own views of the file mapping
+// of 'im', nothing is opened again. An image that isn't mapped is
+// shared only if it is read as a whole, in the window of 'im'.
+// Release the copy with ImageClose, 'im' stays open.
+//
+// Returns FALSE if 'im' can't be shared.
+//
+BOOL ImageShare(IMAGE* w, const IMAGE* im)
+  {
+  if (im->kind != HEX_NONE) return FALSE;
+  if (im->hMap == NULL && (im->base != 0 || im->len != im->size)) return FALSE;
+  *w = *im;
+  w->shared = TRUE;
+  w->rdbuf  = NULL;
+  if (im->hMap)
+    {
+    w->view = NULL;
+    w->data = NULL;
+    w->base = w->len = 0;
+    }
+  return TRUE;
+  } // ImageShare
+
+//-----------------------------------------------------------------------------
+//
+//                          ImageClose
+//
+void ImageClose(IMAGE* im)
+  {
+  if (im->shared)                               // Only the views are ours
+    {
+    if (im->view) UnmapViewOfFile(im->view);
+    im->view = NULL;
+    return;
+    }
+  if (im->view) UnmapViewOfFile(im->view);
+  if (im->hMap) CloseHandle(im->hMap);
+  if (im->rdbuf) free(im->rdbuf);
+  if (im->kind != HEX_NONE) HexFree(im);
+  else close(im->fh);
+  im->view  = NULL;
+  im->hMap  = NULL;
+  im->rdbuf = NULL;
+  } // ImageClose
+
+//--------------------------end-of-c++-module-----------------------------------
@@ -0,0 +1,304 @@
+// haDASM - Disassembler for Microchip processors
+// dasmflow.cpp - C++ Developer source file.
+// (c)1990-2023 by helmut altmann
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; see the file COPYING.  If not, write to
+// the Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+// Boston, MA 02111-1307, USA.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <windows.h>
+
+#include "equate.h"
+#include "extern.h"
+#include "dasmisa.h"
+
+// --------------------------------------------
+// Interrupt vectors, top of memory down
+// --------------------------------------------
+static const char* vecName05[] = {"RESET", "SWI", "IRQ", "TIMER", "SCI", "SPI", NULL};
+static const char* vecName08[] = {"RESET", "SWI", "IRQ", "PLL", "TIM1CH0", "TIM1CH1",
+                                  "TIM1OVF", "TIM2CH0", "TIM2CH1", "TIM2OVF", "SPIRX",
+                                  "SPITX", "SCIERR", "SCIRX", "SCITX", "KBD", "ADC",
+                                  "TBM", NULL};
+static const char* vecName11[] = {"RESET", "CLM", "COP", "ILLOP", "SWI", "XIRQ", "IRQ",
+                                  "RTI", "IC1", "IC2", "IC3", "OC1", "OC2", "OC3", "OC4",
+                                  "IC4OC5", "TOF", "PAOVF", "PAI", "SPI", "SCI", NULL};
+static const char* const* vecName[] = {vecName05, vecName08, vecName11};
+
+// Name of the vector k (0 = reset) of the instruction set cpu
+const char* FlowVector(int cpu, int k)
+  {
+  const char* const* names = vecName[cpu];
+  int n;
+
+  for (n=0; names[n] && n<k; n++);
+  return names[n] ? names[n] : "VECTOR";
+  } // FlowVector
+
+//-----------------------------------------------------------------------------
+//
+//                          FlowTrace
+//
+// Recursive descent from the entry points: follow the flow of control
+// through branches, jumps and subroutine calls. The opcodes executed
+// by the simulator (bitmap 'exec', NULL = none) are entry points too.
+// Every reached
+// instruction start is set in the bitmap 'start', all its bytes in
+// 'code'. An instruction start is queued at most once, so each byte is
+// visited at most once. The vector table is never taken for code.
+// Returns FALSE if out of memory.
+//
+// Each instruction set (opt->cpu) has its own instance of the trace.
+//
+typedef struct tag_FLOWSTACK {
+  DWORD* addr;
+  DWORD  count;
+  DWORD  alloc;
+} FLOWSTACK;
+
+static BOOL FlowPush(FLOWSTACK* fs, BYTE* start, DWORD size, DWORD pc)
+  {
+  if (pc >= size || BITTST(start, pc)) return TRUE;
+  if (fs->count == fs->alloc)
+    {
+    fs->alloc = fs->alloc ? 2*fs->alloc : 1024;
+    if ((fs->addr = (DWORD*)realloc(fs->addr, fs->alloc * sizeof(DWORD))) == NULL) return FALSE;
+    }
+  BITSET(start, pc);
+  fs->addr[fs->count++] = pc;
+  return TRUE;
+  } // FlowPush
+
+template<class ISA>
+static BOOL FlowSweep(const BYTE* data, DWORD size, const DASMOPT* opt, BYTE* start, BYTE* code,
+                      const BYTE* exec)
+  {
+  FLOWSTACK fs = {NULL, 0, 0};
+  const OPDESC* d;
+  DWORD pc, v, target, top;
+  BOOL ok = TRUE;
+  int n;
+
+  top = size > 2*(DWORD)opt->vectors ? size - 2*opt->vectors : 0;
+
+  // Seed the work list from the vector table and the -e entries
+  for (n=1; n<=opt->vectors && 2*n <= (int)size; n++)
+    {
+    v = size - 2*n;
+    ok &= FlowPush(&fs, start, top, (v & 0xFFFF0000) | (data[v] << 8) | data[v+1]);
+    }
+  for (n=0; n<opt->nentry; n++) ok &= FlowPush(&fs, start, top, opt->entry[n]);
+  if (exec)
+    for (pc=0; pc<top; pc++)
+      if (BITTST(exec, pc)) ok &= FlowPush(&fs, start, top, pc);
+
+  while (ok && fs.count)
+    {
+    pc = fs.addr[--fs.count];
+    for (;;)
+      {
+      d = ISA::Desc(&data[pc], top - pc);
+
+      // Illegal, truncated or overlapping: not an instruction
+      for (n=0; d->mode != AM_ILL && pc + d->len <= top && n<d->len && !BITTST(code, pc+n); n++);
+      if (n < d->len || d->mode == AM_ILL)
+        {
+        BITCLR(start, pc);
+        break;
+        }
+
+      for (n=0; n<d->len; n++) BITSET(code, pc+n);
+
+      target = FlowTarget(d, &data[pc], pc);
+      if (target != (DWORD)ERR) ok &= FlowPush(&fs, start, top, target);
+      if (d->flow == FC_JUMP || d->flow == FC_RET) break;
+
+      pc += d->len;                             // Fall through
+      if (pc >= top || BITTST(start, pc)) break;
+      BITSET(start, pc);
+      } // end for
+    } // end while
+
+  free(fs.addr);
+  return ok;
+  } // FlowSweep
+
+BOOL FlowTrace(const BYTE* data, DWORD size, const DASMOPT* opt, BYTE* start, BYTE* code)
+  {
+  return ISACALL(opt->cpu, FlowSweep, (data, size, opt, start, code, NULL));
+  } // FlowTrace
+
+// A vector: word aligned to the top of memory
+static inline BOOL FlowIsVector(DWORD size, DWORD vec, DWORD pc)
+  {
+  return pc >= vec && !((size - pc) & 1);
+  } // FlowIsVector
+
+//-----------------------------------------------------------------------------
+//
+//                          DasmImageFlow
+//
+// Control flow guided disassembly (-r) of the image 'im' into 'ob':
+// reached instructions are listed as code, everything else as FCB
+// data (with -f fill runs and strings collapsed), the vectors at the
+// top of memory as FDB. With -x the M68HC05 simulator runs the image
+// first and adds the executed opcodes. A hex file is traced in a flat
+// copy, with its gaps marked as taken so that no instruction reaches
+// into them; the gaps are skipped in the listing.
+//
+// Returns the number of source lines produced.
+//
+template<class ISA>
+static int FlowImage(IMAGE* im, OUTBUF* ob, const DASMOPT* opt)
+  {
+  BYTE *start, *code, *exec = NULL, *flat = NULL;
+  SIMSTATS st;
+  const BYTE* data;
+  DWORD pc, n, g, end, size = im->size, vec;
+  const OPDESC* d;
+  char line[LINEMAX], *s;
+  SYMENT* e;
+  int lines = 0;
+
+  if (im->kind != HEX_NONE) flat = HexFlat(im);
+  if (im->kind != HEX_NONE ? flat == NULL : (size > IMAGEWINDOW || !ImageWindow(im, 0)))
+    {
+    OutNote(ob, "Warning: image too large for -r, linear sweep\n\n");
+    if (ob->sym) SymScan(im, ob->sym, ob->run);
+    if (ob->xref) XrefScan(im, ob->xref, ob->run);
+    DasmRange(im, ob, 0, size, &lines);
+    return lines;
+    }
+  data = flat ? flat : im->data;
+
+  start = (BYTE*)calloc(2, size/8 + 1);
+  if (start == NULL)
+    {
+    OutNote(ob, "Out of memory\n");
+    free(flat);
+    return 0;
+    }
+  code = start + size/8 + 1;
+
+  if (flat)                                     // The gaps are taken
+    for (pc=0, g=0; pc<size; pc++)
+      {
+      while (im->seg[g].end <= pc) g++;
+      if (pc < im->seg[g].start) BITSET(code, pc);
+      }
+
+  if (opt->sim && ISA::cpu == DASM6805_HC05)    // Dynamic code discovery
+    {
+    if ((exec = (BYTE*)calloc(1, size/8 + 1)) == NULL || !SimRun(data, size, opt, exec, &st))
+      OutNote(ob, "Out of memory\n");
+    else
+      fprintf(stderr, "Simulated %u instructions in %u cycles, %u opcode addresses (%s)\n",
+              (unsigned)st.insns, (unsigned)st.cycles, (unsigned)st.addrs, st.stop);
+    }
+
+  if (!FlowSweep<ISA>(data, size, opt, start, code, exec)) OutNote(ob, "Out of memory\n");
+  free(exec);
+
+  // The vector table at the top of memory
+  vec = size > 2*(DWORD)opt->vectors ? size - 2*opt->vectors : 0;
+
+  // Labels: the targets of all reached instructions and of the vectors
+  if (ob->sym)
+    {
+    for (pc=0; pc<size; pc++)
+      if (BITTST(start, pc))
+        {
+        d = ISA::Desc(&data[pc], size - pc);
+        if ((n = FlowTarget(d, &data[pc], pc)) < size) SymAdd(ob->sym, n);
+        }
+    for (pc=vec + ((size - vec) & 1); pc+1<size; pc+=2)
+      SymAdd(ob->sym, (pc & 0xFFFF0000) | (data[pc] << 8) | data[pc+1]);
+    SymSort(ob->sym);
+    for (e=ob->sym->sym; e<ob->sym->sym + ob->sym->count; e++)
+      if (e->addr < size && BITTST(start, e->addr)) e->name |= SYMDEF;
+    if (opt->sig) SigFlow(ob->sym, data, size, start, ISA::cpu, opt->sig);
+    ob->cur = 0;
+    }
+  if (ob->xref) XrefFlow(ob->xref, data, size, start, ISA::cpu);
+
+  StatPhase(ob, STAT_FORMAT);
+  for (pc=0, g=0, end=size; pc<size; )
+    {
+    if (flat)                                   // Skip a gap of the hex file
+      {
+      while (im->seg[g].end <= pc) g++;
+      end = im->seg[g].end;
+      if (pc < im->seg[g].start)
+        {
+        pc = im->seg[g].start;
+        lines += DasmOrg(ob, pc);
+        }
+      }
+
+    if (BITTST(start, pc))
+      {
+      if (ob->sym) lines += DasmLabel(ob, pc);
+      pc += DasmLine<ISA>(ob, &data[pc], pc, size - pc);
+      lines++;
+      }
+    else if (FlowIsVector(size, vec, pc))
+      {
+      n = (pc & 0xFFFF0000) | (data[pc] << 8) | data[pc+1];
+      if (ob->fmt)
+        FmtVector(ob, &data[pc], pc, n, FlowVector(ISA::cpu, (size - pc)/2 - 1));
+      else
+        {
+        s = PutAddr(line, pc);
+        s = PutStr(s, "  \t\t\t\tfdb\t");
+        if (ob->sym && (e = SymFind(ob->sym, n)) != NULL && e->name)
+          s = SymName(s, ob->sym, e);
+        else
+          {
+          *s++ = '$';
+          s = PutHex2(s, data[pc]);
+          s = PutHex2(s, data[pc+1]);
+          }
+        s = PutStr(s, "\t\t; ");
+        s = PutStr(s, FlowVector(ISA::cpu, (size - pc)/2 - 1));
+        *s++ = '\n';
+        OutMem(ob, line, s - line);
+        }
+      if (ob->stats) ob->stats->data += 2;
+      lines++;
+      pc += 2;
+      }
+    else
+      {
+      // Data up to the next instruction or vector
+      for (n=pc+1; n<end && !BITTST(start, n) && !FlowIsVector(size, vec, n); n++);
+      if (ob->run) lines += DasmDataRuns(ob, &data[pc], pc, n - pc);
+      else lines += DasmData(ob, &data[pc], pc, n - pc);
+      pc = n;
+      }
+    } // end for
+
+  free(start);
+  free(flat);
+  return lines;
+  } // FlowImage
+
+int DasmImageFlow(IMAGE* im, OUTBUF* ob, const DASMOPT* opt)
+  {
+  return ISACALL(im->cpu, FlowImage, (im, ob, opt));
+  } // DasmImageFlow
+
+//--------------------------end-of-c++-module-----------------------------------
@@ -0,0 +1,324 @@
+// haDASM - Disassembler for Microchip processors
+// dasmfmt.cpp - C++ Developer source file.
+// (c)1990-2023 by helmut altmann
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; see the file COPYING.  If not, write to
+// the Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+// Boston, MA 02111-1307, USA.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <windows.h>
+
+#include "equate.h"
+#include "extern.h"
+#include "dasmisa.h"
+
+// --------------------------------------------
+// Machine-readable output (-m)
+// --------------------------------------------
+// In place of the listing text the output sink can write one JSON
+// line (-m j) or one fixed size DASMREC (-m b, see dasm6805.h) per
+// listing item. The items come from the same sweep as the listing:
+// DasmLine, DasmData, DasmRun and DasmLabel hand them over to here.
+// The records are written in ascending address order, meanwhile the
+// first record of every page is noted; FmtEnd appends this address
+// index and the DASMRECTAIL, so a consumer can map the file and find
+// any address without parsing (Dasm6805Seek).
+//
+static_assert(sizeof(DASMREC) == 24 && sizeof(DASMRECTAIL) == 32, "dasm6805.h records");
+
+static const char* const fmtKind[] = {"insn", "data", "fill", "text", "vector"};
+
+// JSON string of the 'n' chars at t[0]
+static char* FmtStr(char* s, const char* t, size_t n)
+  {
+  *s++ = '"';
+  while (n--)
+    {
+    if (*t == '"' || *t == '\\') { *s++ = '\\'; *s++ = *t; }
+    else if ((BYTE)*t < SPACE || (BYTE)*t >= 0x7F)
+      {
+      s = PutStr(s, "\\u00");
+      s = PutHex2(s, (BYTE)*t);
+      }
+    else *s++ = *t;
+    t++;
+    }
+  *s++ = '"';
+  return s;
+  } // FmtStr
+
+// JSON string of the 'n' bytes at p[0] in hex
+static char* FmtHex(char* s, const BYTE* p, DWORD n)
+  {
+  *s++ = '"';
+  while (n--) s = PutHex2(s, *p++);
+  *s++ = '"';
+  return s;
+  } // FmtHex
+
+// Start of the JSON line of the item at address pc, with its label
+static char* FmtHead(char* s, OUTBUF* ob, DWORD pc, int kind)
+  {
+  char name[SYMLEN+1];
+
+  s = PutDec(PutStr(s, "{\"addr\":"), pc);
+  s = PutStr(PutStr(PutStr(s, ",\"kind\":\""), fmtKind[kind]), "\"");
+  if (ob->fmt->label && ob->fmt->label->addr == pc)
+    {
+    s = PutStr(s, ",\"label\":");
+    s = FmtStr(s, name, SymName(name, ob->sym, ob->fmt->label) - name);
+    }
+  ob->fmt->label = NULL;
+  return s;
+  } // FmtHead
+
+// Note the first record of every page up to 'page'
+static void FmtIndex(FMTOUT* f, DWORD page)
+  {
+  while (f->nindex <= page)
+    {
+    if (f->nindex == f->alloc)
+      {
+      f->alloc = f->alloc ? 2*f->alloc : 256;
+      OutOfMemory(f->index = (DWORD*)realloc(f->index, f->alloc * sizeof(DWORD)));
+      }
+    f->index[f->nindex++] = f->count;
+    }
+  } // FmtIndex
+
+// Record of the 'n' bytes at p[0] (address pc), no instruction
+static void FmtRecInit(DASMREC* r, int kind, const BYTE* p, DWORD pc, DWORD n)
+  {
+  memset(r, 0, sizeof(DASMREC));
+  r->addr   = pc;
+  r->len    = n;
+  r->target = DASM6805_NOTARGET;
+  r->kind   = (uint8_t)kind;
+  r->mode   = AM_ILL;
+  r->mne    = MNE_ILL;
+  memcpy(r->bytes, p, n < 4 ? n : 4);
+  } // FmtRecInit
+
+static void FmtRec(OUTBUF* ob, DASMREC* r)
+  {
+  FMTOUT* f = ob->fmt;
+
+  FmtIndex(f, (r->addr - f->org) >> DASMREC_SHIFT);
+  if (f->label && f->label->addr == r->addr) r->flags |= DASMREC_LABEL;
+  f->label = NULL;
+  OutMem(ob, (const char*)r, sizeof(DASMREC));
+  f->count++;
+  } // FmtRec
+
+//-----------------------------------------------------------------------------
+//
+//                          FmtInit
+//
+// Switch the output sink 'ob' to the machine-readable format 'kind'
+// (FMT_JSON, FMT_REC), 'f' holds the state until FmtEnd. The index
+// starts at the address 'org' (the lowest address of the image), the
+// instruction set is 'cpu'.
+//
+void FmtInit(OUTBUF* ob, FMTOUT* f, int kind, DWORD org, int cpu)
+  {
+  memset(f, 0, sizeof(FMTOUT));
+  f->kind = kind;
+  f->cpu = cpu;
+  f->org = org;
+  ob->fmt = f;
+  } // FmtInit
+
+//-----------------------------------------------------------------------------
+//
+//                          FmtEnd
+//
+// End of the output of an image of 'size' bytes: the record file gets
+// its address index and tail. 'ob' is back to listing text.
+//
+void FmtEnd(OUTBUF* ob, DWORD size)
+  {
+  FMTOUT* f = ob->fmt;
+  DASMRECTAIL t;
+
+  if (f->kind == FMT_REC)
+    {
+    FmtIndex(f, (size - f->org + (1 << DASMREC_SHIFT) - 1) >> DASMREC_SHIFT);  // Last entry = count
+    OutMem(ob, (const char*)f->index, f->nindex * sizeof(DWORD));
+
+    memset(&t, 0, sizeof(DASMRECTAIL));
+    t.magic   = DASMREC_MAGIC;
+    t.version = DASMREC_VERSION;
+    t.recsize = sizeof(DASMREC);
+    t.count   = f->count;
+    t.nindex  = f->nindex;
+    t.shift   = DASMREC_SHIFT;
+    t.size    = size;
+    t.org     = f->org;
+    t.cpu     = f->cpu;
+    OutMem(ob, (const char*)&t, sizeof(DASMRECTAIL));
+    }
+  free(f->index);
+  f->index = NULL;
+  ob->fmt = NULL;
+  } // FmtEnd
+
+//-----------------------------------------------------------------------------
+//
+//                          FmtLine
+//
+// Machine-readable DasmLine: decode the instruction at p[0] (address
+// pc, 'avail' bytes left) into one record or JSON line. The JSON
+// operand is the one DasmRender writes, with the target names.
+//
+// Returns the number of bytes consumed (1..ISA::maxlen).
+//
+template<class ISA>
+int FmtLine(OUTBUF* ob, const BYTE* p, DWORD pc, DWORD avail)
+  {
+  char line[FMTLINE], text[LINEMAX], *s, *t, *e;
+  DASMINSN in;
+  DASMREC r;
+
+  DasmDecode<ISA>(p, avail < (DWORD)ISA::maxlen ? avail : (DWORD)ISA::maxlen, pc, &in, 1);
+  if (ob->fmt->kind == FMT_REC)
+    {
+    FmtRecInit(&r, DASMREC_INSN, p, pc, in.len);
+    r.target = in.target;
+    r.mode   = in.mode;
+    r.flow   = in.flow;
+    r.mne    = in.mne;
+    r.cycles = in.cycles;
+    r.flags  = in.flags;
+    FmtRec(ob, &r);
+    return in.len;
+    }
+
+  // The operand of the listing line (none on an FCB line)
+  e = DasmRender<ISA>(text, p, pc, in.len, ob->sym ? OutName : NULL, ob->sym, ob->reg, &t);
+  if (in.flags || t == NULL) t = e;
+
+  s = FmtHead(line, ob, pc, DASMREC_INSN);
+  s = PutStr(s, ",\"bytes\":");
+  s = FmtHex(s, in.bytes, in.len);
+  s = PutStr(PutStr(s, ",\"mne\":\""), in.flags ? "---" : mneName[in.mne]);
+  s = PutStr(PutStr(s, "\",\"mode\":\""), in.flags ? "ill" : modeName[in.mode]);
+  s = FmtStr(PutStr(s, "\",\"operand\":"), t, e - t);
+  if (in.target == DASM6805_NOTARGET) s = PutStr(s, ",\"target\":null");
+  else s = PutDec(PutStr(s, ",\"target\":"), in.target);
+  s = PutDec(PutStr(s, ",\"cycles\":"), in.cycles);
+  if (in.flags) s = PutStr(s, ",\"trunc\":true");
+  s = PutStr(s, "}\n");
+  OutMem(ob, line, s - line);
+  return in.len;
+  } // FmtLine
+
+template int FmtLine<Isa6805>(OUTBUF*, const BYTE*, DWORD, DWORD);
+template int FmtLine<IsaHC08>(OUTBUF*, const BYTE*, DWORD, DWORD);
+template int FmtLine<IsaHC11>(OUTBUF*, const BYTE*, DWORD, DWORD);
+
+//-----------------------------------------------------------------------------
+//
+//                          FmtData
+//
+// Machine-readable data item of 'kind' (DASMREC_DATA, _FILL, _TEXT):
+// the 'n' bytes at p[0] (address pc) of one FCB or FCC line.
+//
+void FmtData(OUTBUF* ob, int kind, const BYTE* p, DWORD pc, DWORD n)
+  {
+  char line[FMTLINE], *s;
+  DASMREC r;
+
+  if (ob->fmt->kind == FMT_REC)
+    {
+    FmtRecInit(&r, kind, p, pc, n);
+    FmtRec(ob, &r);
+    return;
+    }
+
+  s = FmtHead(line, ob, pc, kind);
+  if (kind == DASMREC_DATA)
+    {
+    s = PutStr(s, ",\"bytes\":");
+    s = FmtHex(s, p, n);
+    }
+  else
+    {
+    s = PutDec(PutStr(s, ",\"len\":"), n);
+    if (kind == DASMREC_FILL)
+      {
+      s = PutStr(s, ",\"bytes\":");
+      s = FmtHex(s, p, 1);
+      }
+    else
+      {
+      s = PutStr(s, ",\"text\":");
+      s = FmtStr(s, (const char*)p, n);
+      }
+    }
+  s = PutStr(s, "}\n");
+  OutMem(ob, line, s - line);
+  } // FmtData
+
+//-----------------------------------------------------------------------------
+//
+//                          FmtVector
+//
+// Machine-readable FDB of the vector 'vec' at p[0] (address pc),
+// pointing to 'target'.
+//
+void FmtVector(OUTBUF* ob, const BYTE* p, DWORD pc, DWORD target, const char* vec)
+  {
+  char line[FMTLINE], name[SYMLEN+1], *s, *t;
+  DASMREC r;
+
+  if (ob->fmt->kind == FMT_REC)
+    {
+    FmtRecInit(&r, DASMREC_VECTOR, p, pc, 2);
+    r.target = target;
+    FmtRec(ob, &r);
+    return;
+    }
+
+  if (ob->sym == NULL || (t = OutName(name, ob->sym, target)) == NULL)
+    {
+    name[0] = '$';
+    t = PutHex2(PutHex2(&name[1], p[0]), p[1]);
+    }
+
+  s = FmtHead(line, ob, pc, DASMREC_VECTOR);
+  s = PutStr(s, ",\"bytes\":");
+  s = FmtHex(s, p, 2);
+  s = PutStr(s, ",\"operand\":");
+  s = FmtStr(s, name, t - name);
+  s = PutStr(PutDec(PutStr(s, ",\"target\":"), target), ",\"vector\":");
+  s = FmtStr(s, vec, strlen(vec));
+  s = PutStr(s, "}\n");
+  OutMem(ob, line, s - line);
+  } // FmtVector
+
+//-----------------------------------------------------------------------------
+//
+//                          FmtLabel
+//
+// The defined label 'e' goes with the next item (see DasmLabel).
+//
+void FmtLabel(OUTBUF* ob, const SYMENT* e)
+  {
+  ob->fmt->label = e;
+  } // FmtLabel
+
+//--------------------------end-of-c++-module-----------------------------------
@@ -0,0 +1,443 @@
+// haDASM - Disassembler for Microchip processors
+// dasmgrep.cpp - C++ Developer source file.
+// (c)1990-2023 by helmut altmann
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; see the file COPYING.  If not, write to
+// the Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+// Boston, MA 02111-1307, USA.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <windows.h>
+#include <intrin.h>    // _BitScanForward
+
+#if defined(__AVX2__)                           // CL /arch:AVX2
+#include <immintrin.h>
+#define GREPVEC 32
+#elif defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>                          // SSE2 (CL default)
+#define GREPVEC 16
+#endif
+
+#include "equate.h"
+#include "extern.h"
+#include "dasmisa.h"
+
+// --------------------------------------------
+// Instruction pattern search (-g)
+// --------------------------------------------
+// A pattern is a sequence of instructions in listing syntax, separated
+// by ';'. The mnemonic may hold the wildcards '*' and '?', each operand
+// field (between the commas) is one of
+//
+//   *          any field, as the last one also any fields after it
+//   $* #*      any address, any immediate value
+//   $1A?? #$0? a number, '?' is any hex digit (leading zeros don't matter)
+//   x sp 3     the text of the field
+//
+// An instruction without operand matches all the operands, e.g.
+// "brset *,$dd,*; lda $dd" or "jsr $1A3C" or "lda #*; sta $00??".
+//
+// Each pattern is resolved against the opcode tables: the first bytes
+// of the instructions its first mnemonic can match. The image is then
+// scanned for these bytes without disassembling it, up to GREPBYTES
+// different bytes are searched GREPVEC bytes at a time (SSE2, AVX2 if
+// compiled with /arch:AVX2). Only the candidates are decoded and their
+// operands compared. Every byte offset is a candidate, not only the
+// instruction starts of the linear sweep.
+//
+
+//-----------------------------------------------------------------------------
+//
+//                          GrepGlob
+//
+// Does the name s match the wildcard pattern p ('*', '?', any case)?
+//
+static BOOL GrepGlob(const char* p, const char* s)
+  {
+  for (; *p; p++, s++)
+    {
+    if (*p == '*')
+      {
+      for (p++; ; s++)
+        {
+        if (GrepGlob(p, s)) return TRUE;
+        if (*s == 0) return FALSE;
+        }
+      }
+    if (*s == 0 || (*p != '?' && tolower((UCHAR)*p) != tolower((UCHAR)*s))) return FALSE;
+    }
+  return *s == 0;
+  } // GrepGlob
+
+// Parse the operand field s[0..n-1]: '#' and '$' prefix, the rest
+static void GrepSplit(const char* s, int n, BOOL* imm, BOOL* num, const char** rest, int* len)
+  {
+  *imm = *num = FALSE;
+  for (; n && (*s == '#' || *s == '$'); s++, n--)
+    if (*s == '#') *imm = TRUE;
+    else *num = TRUE;
+  *rest = s;
+  *len = n;
+  } // GrepSplit
+
+//-----------------------------------------------------------------------------
+//
+//                          GrepAdd
+//
+// Compile the pattern 'text' into grep->pat[].
+//
+// Returns FALSE if the pattern is bad (unknown mnemonic, too long).
+//
+BOOL GrepAdd(GREP* grep, const char* text)
+  {
+  char buf[GREPTEXT], name[16];
+  GREPPAT* pat;
+  GREPINSN* in;
+  GREPFIELD* f;
+  const char *s, *e, *r;
+  BOOL imm, num;
+  int n, k, m;
+
+  if (grep->count >= GREPMAX || strlen(text) >= GREPTEXT) return FALSE;
+  pat = &grep->pat[grep->count];
+  memset(pat, 0, sizeof(GREPPAT));
+  strcpy(pat->text, text);
+  strcpy(buf, text);
+
+  for (s=buf; *s; )
+    {
+    if (pat->count >= GREPLEN) return FALSE;
+    in = &pat->insn[pat->count++];
+    for (e=s; *e && *e != ';'; e++);            // One instruction: s..e
+
+    while (s < e && isspace((UCHAR)*s)) s++;    // The mnemonic
+    for (n=0; s < e && !isspace((UCHAR)*s); s++)
+      {
+      if (n >= (int)sizeof(name)-1) return FALSE;
+      name[n++] = *s;
+      }
+    name[n] = 0;
+    for (m=0, k=1; k<MNE_COUNT; k++)            // (not MNE_ILL)
+      if ((in->mne[k] = (BYTE)GrepGlob(name, mneName[k])) != 0) m++;
+    if (m == 0) return FALSE;
+
+    while (s < e && isspace((UCHAR)*s)) s++;    // The operand fields
+    in->nfield = (s < e) ? 0 : ERR;
+    while (s < e)
+      {
+      if (in->nfield >= GREPFIELDS) return FALSE;
+      f = &in->field[in->nfield++];
+      for (r=s; r < e && *r != ','; r++);
+      for (n=(int)(r-s); n && isspace((UCHAR)s[n-1]); n--);
+      GrepSplit(s, n, &imm, &num, &s, &n);
+      f->imm = (BYTE)imm;
+      f->num = (BYTE)num;
+      if (n == 1 && *s == '*')
+        f->kind = GREP_ANY;
+      else
+        {
+        for (k=0; k<n && (isxdigit((UCHAR)s[k]) || s[k] == '?'); k++);
+        if (n > 0 && k == n && n <= 8)
+          {
+          f->kind = GREP_NUM;
+          for (k=0; k<n; k++)                   // The leading digits are 0
+            {
+            f->val <<= 4;
+            f->mask <<= 4;
+            if (s[k] == '?') f->mask |= 0x0F;
+            else f->val |= isdigit((UCHAR)s[k]) ? s[k] - '0' : tolower((UCHAR)s[k]) - 'a' + 10;
+            }
+          f->mask = ~f->mask;
+          }
+        else if (n < (int)sizeof(f->text) && !imm && !num)
+          {
+          f->kind = GREP_TEXT;
+          for (k=0; k<n; k++) f->text[k] = (char)tolower((UCHAR)s[k]);
+          }
+        else return FALSE;
+        }
+      s = (r < e) ? r+1 : r;
+      while (s < e && isspace((UCHAR)*s)) s++;
+      }
+    s = *e ? e+1 : e;
+    while (isspace((UCHAR)*s)) s++;
+    }
+
+  if (pat->count == 0) return FALSE;
+  grep->count++;
+  return TRUE;
+  } // GrepAdd
+
+// The first bytes of the instructions of 'in' in the instruction set ISA
+template<class ISA>
+static void GrepFirst(const GREPINSN* in, DWORD* first, DWORD bit)
+  {
+  BYTE p[ISA::maxlen] = {0};
+  const OPDESC* d;
+  int op, m;
+
+  for (op=0; op<256; op++)
+    for (m=0; m<256; m++)                       // Opcode after a prefix byte
+      {
+      p[0] = (BYTE)op;
+      p[1] = (BYTE)m;
+      d = ISA::Desc(p, ISA::maxlen);
+      if (d->mode != AM_ILL && in->mne[d->mne])
+        {
+        first[op] |= bit;
+        break;
+        }
+      }
+  } // GrepFirst
+
+//-----------------------------------------------------------------------------
+//
+//                          GrepCompile
+//
+// Resolve the patterns against the opcode table of the CPU 'cpu':
+// the table of the first bytes, and the list of them for the vector
+// compare if they are few.
+//
+void GrepCompile(GREP* grep, int cpu)
+  {
+  int n;
+
+  grep->cpu = cpu;
+  memset(grep->first, 0, sizeof(grep->first));
+  for (n=0; n<grep->count; n++)
+    ISACALL(cpu, GrepFirst, (&grep->pat[n].insn[0], grep->first, 1UL << n));
+
+  for (grep->nbyte=0, n=0; n<256; n++)
+    if (grep->first[n])
+      {
+      if (grep->nbyte == GREPBYTES)
+        {
+        grep->nbyte = 0;                        // Too many: table lookup only
+        break;
+        }
+      grep->byte[grep->nbyte++] = (BYTE)n;
+      }
+  } // GrepCompile
+
+//-----------------------------------------------------------------------------
+//
+//                          GrepNext
+//
+// Returns the offset of the first candidate byte (grep->first[])
+// in p[i..n-1], n if there is none.
+//
+static DWORD GrepNext(const GREP* grep, const BYTE* p, DWORD i, DWORD n)
+  {
+#ifdef GREPVEC
+  unsigned long bit;
+  unsigned m;
+  int k;
+  if (grep->nbyte)
+    {
+#if GREPVEC == 32
+    __m256i v[GREPBYTES], x, c;
+    for (k=0; k<grep->nbyte; k++) v[k] = _mm256_set1_epi8((char)grep->byte[k]);
+    for (; i+32 <= n; i+=32)
+      {
+      x = _mm256_loadu_si256((const __m256i*)&p[i]);
+      c = _mm256_cmpeq_epi8(x, v[0]);
+      for (k=1; k<grep->nbyte; k++) c = _mm256_or_si256(c, _mm256_cmpeq_epi8(x, v[k]));
+      if ((m = (unsigned)_mm256_movemask_epi8(c)) != 0) { _BitScanForward(&bit, m); return i + bit; }
+      }
+#else
+    __m128i v[GREPBYTES], x, c;
+    for (k=0; k<grep->nbyte; k++) v[k] = _mm_set1_epi8((char)grep->byte[k]);
+    for (; i+16 <= n; i+=16)
+      {
+      x = _mm_loadu_si128((const __m128i*)&p[i]);
+      c = _mm_cmpeq_epi8(x, v[0]);
+      for (k=1; k<grep->nbyte; k++) c = _mm_or_si128(c, _mm_cmpeq_epi8(x, v[k]));
+      if ((m = (unsigned)_mm_movemask_epi8(c)) != 0) { _BitScanForward(&bit, m); return i + bit; }
+      }
+#endif
+    }
+#endif
+  while (i < n && grep->first[p[i]] == 0) i++;
+  return i;
+  } // GrepNext
+
+// Does the operand field s[0..n-1] of the listing match f?
+static BOOL GrepField(const GREPFIELD* f, const char* s, int n)
+  {
+  const char* r;
+  BOOL imm, num;
+  DWORD v = 0;
+  int k;
+
+  GrepSplit(s, n, &imm, &num, &r, &n);
+  switch (f->kind)
+    {
+    case GREP_ANY:
+      return (!f->imm && !f->num) || (imm == (BOOL)f->imm && (imm || num));
+    case GREP_NUM:
+      if (imm != (BOOL)f->imm || n == 0 || n > 8) return FALSE;
+      for (k=0; k<n; k++)
+        {
+        if (!isxdigit((UCHAR)r[k])) return FALSE;
+        v = (v << 4) | (isdigit((UCHAR)r[k]) ? r[k] - '0' : tolower((UCHAR)r[k]) - 'a' + 10);
+        }
+      return (v & f->mask) == f->val;
+    default:
+      if (imm || num || n != (int)strlen(f->text)) return FALSE;
+      for (k=0; k<n; k++) if (tolower((UCHAR)r[k]) != f->text[k]) return FALSE;
+      return TRUE;
+    }
+  } // GrepField
+
+// The mnemonic and operand in the listing line s (after the cycles)
+static const char* GrepInsnText(const char* s)
+  {
+  const char* t = strstr(s, "~\t");
+  return t ? t+2 : s;
+  } // GrepInsnText
+
+//-----------------------------------------------------------------------------
+//
+//                          GrepMatch
+//
+// Does the pattern 'pat' match the instructions at p[0] (address pc,
+// 'avail' bytes left)? The listing text of the instructions is put
+// into s[] ("mne operand; mne operand").
+//
+template<class ISA>
+static BOOL GrepMatch(const GREPPAT* pat, const BYTE* p, DWORD pc, DWORD avail, char* s)
+  {
+  char line[LINEMAX];
+  const char *t, *f, *e;
+  const OPDESC* d;
+  int k, n;
+
+  for (k=0; k<pat->count; k++)
+    {
+    d = ISA::Desc(p, avail);
+    if (d->mode == AM_ILL || d->len > avail || !pat->insn[k].mne[d->mne]) return FALSE;
+
+    *DasmRender<ISA>(line, p, pc, avail, NULL, NULL, NULL, NULL) = 0;
+    t = GrepInsnText(line);
+    if (pat->insn[k].nfield != ERR)
+      {
+      for (f=t; *f && *f != '\t'; f++);         // The operand fields
+      if (*f) f++;
+      for (n=0; n<pat->insn[k].nfield; n++)
+        {
+        if (*f == 0) return FALSE;
+        for (e=f; *e && *e != ','; e++);
+        if (!GrepField(&pat->insn[k].field[n], f, (int)(e-f))) return FALSE;
+        f = *e ? e+1 : e;
+        }
+      n = pat->insn[k].nfield - 1;              // More fields: only after a last "*"
+      if (*f && (n < 0 || pat->insn[k].field[n].kind != GREP_ANY || pat->insn[k].field[n].imm ||
+                 pat->insn[k].field[n].num))
+        return FALSE;
+      }
+
+    if (k) s = PutStr(s, "; ");
+    for (; *t; t++) *s++ = (*t == '\t') ? SPACE : *t;
+    p += d->len;
+    pc += d->len;
+    avail -= d->len;
+    }
+  *s = 0;
+  return TRUE;
+  } // GrepMatch
+
+//-----------------------------------------------------------------------------
+//
+//                          GrepScan
+//
+// Search the image for the patterns, window by window, and list the
+// matches as "name:ADDR:\tinstructions" lines into 'ob'.
+//
+// Returns the number of matches.
+//
+template<class ISA>
+static int GrepScan(IMAGE* im, OUTBUF* ob, const GREP* grep, const char* name)
+  {
+  char text[GREPLEN*LINEMAX], line[MAX_PATH+16];
+  DWORD pc = 0, end, bits, span = 0;
+  int matches = 0, n;
+
+  for (n=0; n<grep->count; n++)                 // Longest match
+    if (span < (DWORD)grep->pat[n].count * ISA::maxlen) span = grep->pat[n].count * ISA::maxlen;
+
+  while (pc < im->size)
+    {
+    end = im->base + im->len;
+    if (end < im->lim)                          // Keep a whole match in the window
+      end = (end > span-1) ? end - (span-1) : 0;
+
+    if (pc < im->base || pc >= end)
+      {
+      if (!ImageWindow(im, pc))
+        {
+        OutNote(ob, "Read error\n");
+        return matches;
+        }
+      if (im->base > pc) pc = im->base;         // A gap of a hex file
+      if (im->len == 0) break;
+      continue;
+      }
+
+    for (;;)
+      {
+      pc = im->base + GrepNext(grep, im->data, pc - im->base, end - im->base);
+      if (pc >= end) break;
+      for (bits=grep->first[im->data[pc - im->base]], n=0; bits; bits >>= 1, n++)
+        if ((bits & 1) && GrepMatch<ISA>(&grep->pat[n], &im->data[pc - im->base], pc,
+                                         im->lim - pc, text))
+          {
+          _snprintf(line, MAX_PATH, "%s:", name);
+          line[MAX_PATH] = 0;
+          strcpy(PutAddr(line + strlen(line), pc), ":\t");
+          OutStr(ob, line);
+          OutStr(ob, text);
+          OutStr(ob, "\n");
+          matches++;
+          }
+      pc++;
+      }
+    }
+  return matches;
+  } // GrepScan
+
+//-----------------------------------------------------------------------------
+//
+//                          GrepFile
+//
+// Search the image file 'name' for the patterns opt->grep, the
+// matches are listed into 'ob'.
+//
+// Returns the number of matches, ERR if the file can't be opened.
+//
+int GrepFile(const char* name, OUTBUF* ob, const DASMOPT* opt)
+  {
+  IMAGE image;
+  int n;
+
+  if (ImageOpen(&image, name) == ERR) return ERR;
+  image.cpu = opt->grep->cpu;
+  n = ISACALL(image.cpu, GrepScan, (&image, ob, opt->grep, name));
+  ImageClose(&image);
+  return n;
+  } // GrepFile
+
+//--------------------------end-of-c++-module-----------------------------------
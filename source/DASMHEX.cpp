@@ -0,0 +1,342 @@
+// haDASM - Disassembler for Microchip processors
+// dasmhex.cpp - C++ Developer source file.
+// (c)1990-2023 by helmut altmann
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; see the file COPYING.  If not, write to
+// the Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+// Boston, MA 02111-1307, USA.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <windows.h>
+#include <shlwapi.h>   // PathFindExtension
+
+#include "equate.h"
+#include "extern.h"
+
+// --------------------------------------------
+// Hex file loaders, sparse image
+// --------------------------------------------
+// Motorola S-records (S1/S2/S3 data) and Intel HEX (data, extended
+// segment and linear address records) are read line by line into a
+// sparse image: pages of PAGESIZE bytes, allocated as the records
+// touch them, each with a bitmap of the bytes loaded. The populated
+// ranges (im->seg) are collected at the end. A window of the image
+// (see HexWindow) never reaches across a gap, so the disassembler
+// lists the ranges at their load addresses and skips the gaps.
+//
+static int HexByte(const char* s)               // Two hex digits, -1 if none
+  {
+  int n, v = 0;
+
+  for (n=0; n<2; n++, s++)
+    {
+    if (*s >= '0' && *s <= '9') v = 16*v + *s - '0';
+    else if (*s >= 'A' && *s <= 'F') v = 16*v + *s - 'A' + 10;
+    else if (*s >= 'a' && *s <= 'f') v = 16*v + *s - 'a' + 10;
+    else return -1;
+    }
+  return v;
+  } // HexByte
+
+// Index of the page at or above address 'addr' (npage if none)
+static DWORD HexSeek(const IMAGE* im, DWORD addr)
+  {
+  DWORD lo = 0, hi = im->npage, m;
+
+  addr -= addr % PAGESIZE;
+  while (lo < hi)
+    {
+    m = (lo + hi) / 2;
+    if (im->page[m]->addr < addr) lo = m + 1;
+    else hi = m;
+    }
+  return lo;
+  } // HexSeek
+
+// The page of address 'addr', allocated if new
+static IMGPAGE* HexPage(IMAGE* im, DWORD addr)
+  {
+  IMGPAGE* pg;
+  DWORD k;
+
+  addr -= addr % PAGESIZE;
+  if (im->npage && im->page[im->npage-1]->addr == addr) return im->page[im->npage-1];
+  if (im->npage && im->page[im->npage-1]->addr < addr) k = im->npage;  // Ascending file
+  else
+    {
+    k = HexSeek(im, addr);
+    if (k < im->npage && im->page[k]->addr == addr) return im->page[k];
+    }
+
+  if (im->npage == im->apage)
+    {
+    im->apage = im->apage ? 2*im->apage : 64;
+    OutOfMemory(im->page = (IMGPAGE**)realloc(im->page, im->apage * sizeof(IMGPAGE*)));
+    }
+  OutOfMemory(pg = (IMGPAGE*)calloc(1, sizeof(IMGPAGE)));
+  pg->addr = addr;
+  memmove(&im->page[k+1], &im->page[k], (im->npage - k) * sizeof(IMGPAGE*));
+  im->page[k] = pg;
+  im->npage++;
+  return pg;
+  } // HexPage
+
+// Load the 'n' bytes at p[0] to address 'addr'
+static void HexStore(IMAGE* im, DWORD addr, const BYTE* p, DWORD n)
+  {
+  IMGPAGE* pg;
+  DWORD i;
+
+  while (n)
+    {
+    pg = HexPage(im, addr);
+    for (i=addr - pg->addr; i<PAGESIZE && n; i++, n--, addr++)
+      {
+      pg->data[i] = *p++;
+      BITSET(pg->used, i);
+      }
+    }
+  } // HexStore
+
+// The populated ranges of the loaded pages
+static void HexSegments(IMAGE* im)
+  {
+  IMGPAGE* pg;
+  IMGSEG* sg = NULL;
+  DWORD k, i, alloc = 0;
+
+  for (k=0; k<im->npage; k++)
+    {
+    pg = im->page[k];
+    for (i=0; i<PAGESIZE; i++)
+      {
+      if (!BITTST(pg->used, i)) continue;
+      if (sg && sg->end == pg->addr + i) { sg->end++; continue; }
+      if (im->nseg == alloc)
+        {
+        alloc = alloc ? 2*alloc : 16;
+        OutOfMemory(im->seg = (IMGSEG*)realloc(im->seg, alloc * sizeof(IMGSEG)));
+        }
+      sg = &im->seg[im->nseg++];
+      sg->start = pg->addr + i;
+      sg->end = sg->start + 1;
+      }
+    }
+  im->size = im->nseg ? im->seg[im->nseg-1].end : 0;
+  } // HexSegments
+
+//-----------------------------------------------------------------------------
+//
+//                          HexRecord
+//
+// Load one line 's' of a hex file of 'kind' (HEX_SREC, HEX_INTEL).
+// 'upper' is the address set by the last Intel HEX extended segment
+// or linear address record.
+//
+// Returns 0, 1 at the end of file record, ERR if the line is bad.
+//
+static int HexRecord(IMAGE* im, const char* s, int kind, DWORD* upper)
+  {
+  BYTE rec[HEXLINE/2];
+  DWORD n, i, addr, sum = 0;
+  int v, type;
+
+  if (*s++ != (kind == HEX_SREC ? 'S' : ':')) return ERR;
+  type = (kind == HEX_SREC) ? *s++ - '0' : 0;
+  if (type < 0 || type > 9) return ERR;
+
+  for (n=0; s[2*n] && s[2*n] != '\n' && s[2*n] != '\r'; n++)
+    {
+    if ((v = HexByte(&s[2*n])) < 0 || n >= sizeof(rec)) return ERR;
+    rec[n] = (BYTE)v;
+    sum += v;
+    }
+
+  if (kind == HEX_SREC)                         // Sn cc aa.. dd.. ss
+    {
+    if (n < 3 || rec[0] != n-1 || (sum & 0xFF) != 0xFF) return ERR;
+    if (type < 1 || type > 3) return (type > 6 && type <= 9) ? 1 : 0;  // Header, count, start
+    for (addr=0, i=1; i<=(DWORD)type+1; i++) addr = (addr << 8) | rec[i];
+    if (i >= n) return ERR;
+    HexStore(im, addr, &rec[i], n-1 - i);
+    return 0;
+    }
+
+  // :ll aaaa tt dd.. cc
+  if (n < 5 || rec[0] != n-5 || (sum & 0xFF) != 0) return ERR;
+  addr = (rec[1] << 8) | rec[2];
+  switch (rec[3])
+    {
+    case 0x00: HexStore(im, *upper + addr, &rec[4], rec[0]); break;
+    case 0x01: return 1;
+    case 0x02: if (rec[0] != 2) return ERR;
+               *upper = ((rec[4] << 8) | rec[5]) << 4;
+               break;
+    case 0x04: if (rec[0] != 2) return ERR;
+               *upper = ((rec[4] << 8) | rec[5]) << 16;
+               break;
+    case 0x03: case 0x05: break;                // Start address
+    default:   return ERR;
+    }
+  return 0;
+  } // HexRecord
+
+//-----------------------------------------------------------------------------
+//
+//                          HexKind
+//
+// Hex file kind of the file 'name' by its extension:
+// .s19 .s28 .s37 .srec .mot are S-records, .hex .ihx Intel HEX.
+//
+int HexKind(const char* name)
+  {
+  static const char* const srec[] = {".s19", ".s28", ".s37", ".srec", ".mot"};
+  static const char* const intel[] = {".hex", ".ihx"};
+  const char* ext = PathFindExtensionA(name);
+  int n;
+
+  for (n=0; n<(int)(sizeof(srec)/sizeof(srec[0])); n++) if (!_stricmp(ext, srec[n])) return HEX_SREC;
+  for (n=0; n<(int)(sizeof(intel)/sizeof(intel[0])); n++) if (!_stricmp(ext, intel[n])) return HEX_INTEL;
+  return HEX_NONE;
+  } // HexKind
+
+//-----------------------------------------------------------------------------
+//
+//                          HexLoad
+//
+// Read the hex file 'name' of 'kind' into the sparse image 'im'
+// (cleared by ImageOpen). A bad line is reported on stderr.
+//
+// Returns ERR if the file can't be opened or has a bad line.
+//
+int HexLoad(IMAGE* im, const char* name, int kind)
+  {
+  char line[HEXLINE+2], *s;
+  DWORD upper = 0, n = 0;
+  FILE* fp;
+  int r = 0;
+
+  if ((fp = fopen(name, "r")) == NULL) return ERR;
+  im->kind = kind;
+  im->fh = ERR;
+  while (r == 0 && fgets(line, sizeof(line), fp))
+    {
+    n++;
+    for (s=line; *s == SPACE || *s == '\t'; s++);
+    if (*s == '\n' || *s == '\r' || *s == 0) continue;
+    if ((r = HexRecord(im, s, kind, &upper)) == ERR)
+      fprintf(stderr, "Bad record in line %u of %s\n", (unsigned)n, name);
+    }
+  fclose(fp);
+
+  HexSegments(im);
+  if (r == ERR) HexFree(im);
+  return r == ERR ? ERR : 0;
+  } // HexLoad
+
+//-----------------------------------------------------------------------------
+//
+//                          HexWindow
+//
+// ImageWindow of a sparse image: the window starts at address 'addr',
+// or at the start of the next populated range if addr is in a gap,
+// and ends at the end of its range (im->lim) at the latest. After the
+// last range the window is empty at address size. The window buffer
+// holds the longest range (at most IMAGEWINDOW), so a small hex file
+// costs a small buffer.
+//
+// Returns FALSE if out of memory.
+//
+BOOL HexWindow(IMAGE* im, DWORD addr)
+  {
+  const IMGPAGE* pg;
+  DWORD lo = 0, hi = im->nseg, m, a, end, n = 1;
+
+  while (lo < hi)                               // First range ending above addr
+    {
+    m = (lo + hi) / 2;
+    if (im->seg[m].end <= addr) lo = m + 1;
+    else hi = m;
+    }
+  if (im->rdbuf == NULL)
+    {
+    for (a=0; a<im->nseg; a++)
+      if (im->seg[a].end - im->seg[a].start > n) n = im->seg[a].end - im->seg[a].start;
+    if ((im->rdbuf = (BYTE*)malloc(n < IMAGEWINDOW ? n : IMAGEWINDOW)) == NULL) return FALSE;
+    }
+  im->data = im->rdbuf;
+  if (lo >= im->nseg)
+    {
+    im->base = im->lim = im->size;
+    im->len = 0;
+    return TRUE;
+    }
+
+  im->base = addr > im->seg[lo].start ? addr : im->seg[lo].start;
+  im->lim = im->seg[lo].end;
+  im->len = im->lim - im->base;
+  if (im->len > IMAGEWINDOW) im->len = IMAGEWINDOW;
+
+  for (a=im->base, end=im->base + im->len; a<end; a+=m)
+    {
+    pg = im->page[HexSeek(im, a)];
+    m = pg->addr + PAGESIZE - a;
+    if (m > end - a) m = end - a;
+    memcpy(im->rdbuf + (a - im->base), &pg->data[a - pg->addr], m);
+    }
+  return TRUE;
+  } // HexWindow
+
+//-----------------------------------------------------------------------------
+//
+//                          HexFlat
+//
+// Flat copy of the sparse image from address 0 to size, the gaps
+// zero filled (for -r). Free it with free().
+//
+// Returns NULL if the image is larger than IMAGEWINDOW or out of memory.
+//
+BYTE* HexFlat(IMAGE* im)
+  {
+  BYTE* p;
+  DWORD k, n;
+
+  if (im->size > IMAGEWINDOW || (p = (BYTE*)calloc(1, im->size + 1)) == NULL) return NULL;
+  for (k=0; k<im->npage; k++)
+    {
+    n = im->size - im->page[k]->addr;
+    memcpy(&p[im->page[k]->addr], im->page[k]->data, n < PAGESIZE ? n : PAGESIZE);
+    }
+  return p;
+  } // HexFlat
+
+//-----------------------------------------------------------------------------
+//
+//                          HexFree
+//
+void HexFree(IMAGE* im)
+  {
+  DWORD k;
+
+  for (k=0; k<im->npage; k++) free(im->page[k]);
+  free(im->page);
+  free(im->seg);
+  im->page = NULL;
+  im->seg  = NULL;
+  im->npage = im->apage = im->nseg = 0;
+  } // HexFree
+
+//--------------------------end-of-c++-module-----------------------------------
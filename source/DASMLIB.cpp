@@ -0,0 +1,559 @@
+// haDASM - Disassembler for Microchip processors
+// dasmlib.cpp - C++ Developer source file.
+// (c)1990-2023 by helmut altmann
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; see the file COPYING.  If not, write to
+// the Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+// Boston, MA 02111-1307, USA.
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <windows.h>
+
+#include "equate.h"
+#include "extern.h"
+#include "dasmisa.h"
+
+// --------------------------------------------
+// M68HC05 decoder library (DASM6805.lib)
+// --------------------------------------------
+// Decoder and formatter of the disassembler, also built as a static
+// library with the C ABI of dasm6805.h. Everything here works on the
+// caller's buffers and the constant tables only (dasmtab.cpp): no
+// globals, no allocations, re-entrant and thread-safe.
+//
+static_assert(DASM6805_LINEMAX == LINEMAX && DASM6805_NAMEMAX == SYMLEN, "dasm6805.h limits");
+
+// --------------------------------------------
+// Hex lookup table: two ASCII digits per byte
+// --------------------------------------------
+typedef struct tag_HEXTAB {
+  char h[256][2];
+} HEXTAB;
+
+constexpr HEXTAB MakeHexTab()
+  {
+  HEXTAB t = {};
+  for (int n=0; n<256; n++)
+    {
+    t.h[n][0] = "0123456789ABCDEF"[n >> 4];
+    t.h[n][1] = "0123456789ABCDEF"[n & 0x0F];
+    }
+  return t;
+  } // MakeHexTab
+
+constexpr HEXTAB hexTab = MakeHexTab();
+
+static_assert(hexTab.h[0xA5][0] == 'A' && hexTab.h[0xA5][1] == '5', "hexTab[]");
+
+// Render helpers: write into the line buffer, return the new end pointer
+char* PutHex2(char* p, unsigned v)
+  {
+  p[0] = hexTab.h[v & 0xFF][0];
+  p[1] = hexTab.h[v & 0xFF][1];
+  return p+2;
+  }
+
+static inline char* PutHex3(char* p, unsigned v)  // "%03X" of a byte
+  {
+  *p++ = '0';
+  return PutHex2(p, v);
+  }
+
+static inline char* PutHex4(char* p, unsigned v)  // "%04X" of a WORD
+  {
+  p = PutHex2(p, v >> 8);
+  return PutHex2(p, v);
+  }
+
+char* PutAddr(char* p, DWORD v)                  // "%04X" of a 32bit address
+  {
+  int n = 5;
+
+  if (v <= 0xFFFF) return PutHex4(p, v);
+  while (n < 8 && (v >> (4*n))) n++;
+  while (n--) *p++ = "0123456789ABCDEF"[(v >> (4*n)) & 0x0F];
+  return p;
+  }
+
+static inline char* PutFcb(char* p, unsigned v)   // "'%c'" or "$%02X"
+  {
+  if (v >= SPACE && v < 0x7F)
+    {
+    *p++ = '\''; *p++ = (char)v; *p++ = '\'';
+    }
+  else
+    {
+    *p++ = '$';
+    p = PutHex2(p, v);
+    }
+  return p;
+  }
+
+char* PutStr(char* p, const char* s)
+  {
+  while (*s) *p++ = *s++;
+  return p;
+  }
+
+char* PutDec(char* p, DWORD v)                   // "%u"
+  {
+  char t[10];
+  int n = 0;
+
+  do t[n++] = (char)('0' + v % 10); while (v /= 10);
+  while (n) *p++ = t[--n];
+  return p;
+  }
+
+// Operand bytes of each addressing mode, at the end of the instruction
+constexpr unsigned char modeLen[AM_COUNT] = {
+  0, 0, 1, 1, 2, 1, 0, 1, 2, 1, 2,            // ILL INH IMM DIR EXT REL IX IX1 IX2 BSC BTB
+  2, 1, 2, 2, 2, 1, 1,                        // IMM16 SP1 SP2 DD IMD DIXP IXPD
+  2, 2, 1, 1, 2, 2, 2,                        // DREL IREL IXREL IXPREL IX1REL IX1PREL SP1REL
+  1, 2, 2, 2, 3, 3, 3                         // IY1 BSCM BSCX BSCY BTBM BTBX BTBY
+  };
+
+//-----------------------------------------------------------------------------
+//
+//                          FlowTarget
+//
+// Address of the branch or jump target of the instruction 'd' at p[0]
+// (address pc), or ERR if it is not known statically (indexed jmp/jsr).
+// The relative offset is always the last byte of the instruction.
+//
+DWORD FlowTarget(const OPDESC* d, const BYTE* p, DWORD pc)
+  {
+  switch (d->mode)
+    {
+    case AM_REL:    case AM_BTB:    case AM_DREL:   case AM_IREL:
+    case AM_IXREL:  case AM_IXPREL: case AM_IX1REL: case AM_IX1PREL:
+    case AM_SP1REL: case AM_BTBM:   case AM_BTBX:   case AM_BTBY:
+      return BRANCHTARGET(pc, d->len, p[d->len-1]);
+    case AM_DIR: if (d->flow == FC_JUMP || d->flow == FC_CALL) return (pc & 0xFFFF0000) | p[d->len-1];
+                 break;
+    case AM_EXT: if (d->flow == FC_JUMP || d->flow == FC_CALL)
+                   return (pc & 0xFFFF0000) | (p[d->len-2] << 8) | p[d->len-1];
+                 break;
+    }
+  return (DWORD)ERR;
+  } // FlowTarget
+
+// The branch target 'l' of a relative mode: its name or "$hhhh"
+static inline char* PutTarget(char* s, DWORD l, DASMNAMEPROC name, void* ctx)
+  {
+  char* t;
+
+  if (name && (t = name(s, ctx, l)) != NULL) return t;
+  *s++ = '$';
+  return PutAddr(s, l);
+  } // PutTarget
+
+// Register of the map 'reg' at the data address 'a', NULL = none.
+// A built-in map is a perfect hash (probe 0): one slot, one compare.
+static inline const REGSLOT* RegFind(const REGMAP* reg, DWORD a)
+  {
+  const REGSLOT* r;
+  DWORD i = REGHASH(a, reg->mul, reg->bits);
+  int n;
+
+  for (n=0; ; n++)
+    {
+    r = &reg->slot[i];
+    if (r->addr == a) return r;
+    if (r->addr == REGNONE || n >= reg->probe) return NULL;
+    i = (i + 1) & ((1u << reg->bits) - 1);
+    }
+  } // RegFind
+
+// The data address 'a' ('len' operand bytes): the register name in
+// place of the "$" before s[], or "$0dd" / "$hhhh"
+static inline char* PutData(char* s, DWORD a, int len, const REGMAP* reg)
+  {
+  const REGSLOT* r;
+
+  if (reg && (r = RegFind(reg, a)) != NULL) return PutStr(s-1, r->name);
+  return len == 2 ? PutHex4(s, a) : PutHex3(s, a);
+  } // PutData
+
+// Bit n of the direct address 'a' (bset, brclr, ..): the bit name in
+// place of the "n,$" before s[], then the register name
+static inline char* PutBit(char* s, int n, DWORD a, const REGMAP* reg)
+  {
+  const REGSLOT* r;
+
+  if (reg == NULL || (r = RegFind(reg, a)) == NULL) return PutHex3(s, a);
+  if (r->bit[n])
+    {
+    s = PutStr(s-3, r->bit[n]);
+    *s++ = ',';
+    }
+  else s--;
+  return PutStr(s, r->name);
+  } // PutBit
+
+//-----------------------------------------------------------------------------
+//
+//                          DasmRender
+//
+// Render the instruction at p[0] (address pc) as one listing line
+// (without the '\n') to s[], at most LINEMAX-2 chars. The format is:
+//
+//   "%04X  %02X "  address & opcode, operand bytes, cycles, mnemonic
+//
+// 'avail' is the number of bytes left at p[0]. An instruction
+// straddling the end of the image is listed as FCB of the bytes left.
+// If 'name' is given it is asked for the names of the branch and
+// jump targets. With a register map 'reg' (-i) the data addresses
+// of the I/O registers are shown by name, a named bit of brset, bclr,
+// .. by its name too ("bset TE,SCCR2"). The listing text of the
+// opcode (ISA::Text) ends with the constant start of the operand,
+// the rest follows the mode. If 'operand' is given it gets the start
+// of the operand in s[] (the end for none), NULL for an FCB line.
+//
+// Returns the new end pointer.
+//
+template<class ISA>
+char* DasmRender(char* s, const BYTE* p, DWORD pc, DWORD avail, DASMNAMEPROC name, void* ctx,
+                 const REGMAP* reg, char** operand)
+  {
+  const OPDESC* d;
+  const BYTE* o;
+  const char* m;
+  char* t;
+  int op, n;
+
+  if (operand) *operand = NULL;
+  op = p[0];                                    // get instruction mnemonic index
+  d = ISA::Desc(p, avail);                      // get instruction descriptor
+
+  s = PutAddr(s, pc);                           // print address & instruction opcode
+  *s++ = SPACE; *s++ = SPACE;
+  s = PutHex2(s, op);
+  *s++ = SPACE;
+
+  // Odd last bytes left - indeterminable instruction
+  if (d->len > avail)
+    {
+    if (avail > 1) s = PutHex2(s, p[1]);
+    s = PutStr(s, "\t\t\t---\t\t\t; FCB  ");
+    for (n=0; n<(int)avail; n++)
+      {
+      if (n) { *s++ = ','; *s++ = SPACE; }
+      s = PutFcb(s, p[n]);
+      }
+    return s;
+    }
+
+  for (n=1; n<d->len; n++)                      // print operand bytes
+    {
+    if (n > 1) *s++ = SPACE;
+    s = PutHex2(s, p[n]);
+    }
+  if (d->len == 1) *s++ = '\t';
+  if (d->len <= 2) *s++ = '\t';
+  t = s;
+  m = ISA::Text(d);
+  s = PutStr(s, m);                             // print mnemonics
+  if (operand && d->mode != AM_ILL)             // After the TAB of the mnemonic
+    *operand = (d->mode == AM_INH) ? s : t + (strrchr(m, '\t') + 1 - m);
+
+  o = p + d->len - modeLen[d->mode];            // operand
+  switch (d->mode)
+    {
+    case AM_ILL:
+      s = PutStr(s, "\t\t\t; FCB  ");
+      s = PutFcb(s, op);
+      break;
+
+    case AM_DIR:
+    case AM_EXT:
+    case AM_IX1:
+    case AM_IX2:
+      if (name && (d->flow == FC_JUMP || d->flow == FC_CALL) &&
+          (t = name(s-1, ctx, FlowTarget(d, p, pc))) != NULL)
+        s = t;                                  // label in place of "$hhhh"
+      else if (reg && (d->mode == AM_DIR || d->mode == AM_EXT) &&
+               d->flow != FC_JUMP && d->flow != FC_CALL)
+        s = PutData(s, modeLen[d->mode] == 2 ? o[0] << 8 | o[1] : o[0], modeLen[d->mode], reg);
+      else if (modeLen[d->mode] == 2)
+        s = PutHex4(s, o[0] << 8 | o[1]);       // print 16bit location address
+      else
+        s = PutHex3(s, o[0]);                   // direct addressing mode
+      if (d->mode == AM_IX1 || d->mode == AM_IX2) { *s++ = ','; *s++ = 'x'; }
+      break;
+
+    case AM_REL:                                // relative branches
+      s = PutTarget(s-1, FlowTarget(d, p, pc), name, ctx);
+      break;
+    case AM_IMM:                                // immediate addressing mode
+      s = PutHex2(s, o[0]);
+      break;
+    case AM_IMM16:
+      s = PutHex4(s, o[0] << 8 | o[1]);
+      break;
+    case AM_BSC:                                // n,dd
+      s = PutBit(s, (op >> 1) & 7, o[0], reg);
+      break;
+    case AM_IXPD:                               // x+,dd
+      s = PutData(s, o[0], 1, reg);
+      break;
+    case AM_BTB:                                // n,dd,rr
+      s = PutBit(s, (op >> 1) & 7, o[0], reg);
+      *s++ = ',';
+      s = PutTarget(s, FlowTarget(d, p, pc), name, ctx);
+      break;
+    case AM_DREL:                               // dd,rr
+      s = PutData(s, o[0], 1, reg);
+      *s++ = ',';
+      s = PutTarget(s, FlowTarget(d, p, pc), name, ctx);
+      break;
+    case AM_IREL:                               // #ii,rr
+      s = PutHex2(s, o[0]);
+      *s++ = ',';
+      s = PutTarget(s, FlowTarget(d, p, pc), name, ctx);
+      break;
+    case AM_IXREL:                              // ,x,rr
+    case AM_IXPREL:                             // ,x+,rr
+      s = PutTarget(s, FlowTarget(d, p, pc), name, ctx);
+      break;
+    case AM_IX1REL:                             // ff,x,rr
+    case AM_IX1PREL:                            // ff,x+,rr
+    case AM_SP1REL:                             // ff,sp,rr
+      s = PutHex3(s, o[0]);
+      s = PutStr(s, d->mode == AM_IX1REL ? ",x," : d->mode == AM_IX1PREL ? ",x+," : ",sp,");
+      s = PutTarget(s, FlowTarget(d, p, pc), name, ctx);
+      break;
+    case AM_SP1:                                // ff,sp
+      s = PutHex3(s, o[0]);
+      s = PutStr(s, ",sp");
+      break;
+    case AM_SP2:                                // ee ff,sp
+      s = PutHex4(s, o[0] << 8 | o[1]);
+      s = PutStr(s, ",sp");
+      break;
+    case AM_DD:                                 // dd,dd
+      s = PutData(s, o[0], 1, reg);
+      s = PutStr(s, ",$");
+      s = PutData(s, o[1], 1, reg);
+      break;
+    case AM_IMD:                                // #ii,dd
+      s = PutHex2(s, o[0]);
+      s = PutStr(s, ",$");
+      s = PutData(s, o[1], 1, reg);
+      break;
+    case AM_DIXP:                               // dd,x+
+      s = PutData(s, o[0], 1, reg);
+      s = PutStr(s, ",x+");
+      break;
+    case AM_IY1:                                // ff,y
+      if (name && (d->flow == FC_JUMP || d->flow == FC_CALL) &&
+          (t = name(s-1, ctx, FlowTarget(d, p, pc))) != NULL)
+        s = t;
+      else
+        s = PutHex3(s, o[0]);
+      s = PutStr(s, ",y");
+      break;
+    case AM_BSCM:                               // dd,#mm
+    case AM_BSCX:                               // ff,x,#mm
+    case AM_BSCY:                               // ff,y,#mm
+    case AM_BTBM:                               // dd,#mm,rr
+    case AM_BTBX:                               // ff,x,#mm,rr
+    case AM_BTBY:                               // ff,y,#mm,rr
+      if (d->mode == AM_BSCM || d->mode == AM_BTBM) s = PutData(s, o[0], 1, reg);
+      else s = PutHex3(s, o[0]);
+      if (d->mode == AM_BSCX || d->mode == AM_BTBX) s = PutStr(s, ",x");
+      if (d->mode == AM_BSCY || d->mode == AM_BTBY) s = PutStr(s, ",y");
+      s = PutStr(s, ",#$");
+      s = PutHex2(s, o[1]);
+      if (modeLen[d->mode] == 3)
+        {
+        *s++ = ',';
+        s = PutTarget(s, FlowTarget(d, p, pc), name, ctx);
+        }
+      break;
+    } // end switch
+
+  return s;
+  } // DasmRender
+
+template char* DasmRender<Isa6805>(char*, const BYTE*, DWORD, DWORD, DASMNAMEPROC, void*, const REGMAP*, char**);
+template char* DasmRender<IsaHC08>(char*, const BYTE*, DWORD, DWORD, DASMNAMEPROC, void*, const REGMAP*, char**);
+template char* DasmRender<IsaHC11>(char*, const BYTE*, DWORD, DWORD, DASMNAMEPROC, void*, const REGMAP*, char**);
+
+//-----------------------------------------------------------------------------
+//
+//                          DasmDecode
+//
+// Linear sweep decode of the n bytes p[0..n-1] (p[0] at address 'base')
+// into at most 'cap' instruction records out[]. An instruction cut off
+// by the end of the buffer gets the flag DASM6805_TRUNC and the length
+// of the bytes left.
+//
+// Returns the number k of records filled.
+//
+template<class ISA>
+size_t DasmDecode(const BYTE* p, size_t n, DWORD base, DASMINSN* out, size_t cap)
+  {
+  const OPDESC* d;
+  DASMINSN* r;
+  size_t pos = 0, k;
+  int i;
+
+  for (k=0; k<cap && pos<n; k++)
+    {
+    d = ISA::Desc(&p[pos], (DWORD)(n - pos));
+    r = &out[k];
+
+    r->addr   = base + (uint32_t)pos;
+    r->mode   = d->mode;
+    r->flow   = d->flow;
+    r->mne    = d->mne;
+    r->cycles = d->cycles;
+    r->flags  = 0;
+    r->cpu    = ISA::cpu;
+    r->len    = d->len;
+    if (d->len > n - pos)
+      {
+      r->len = (uint8_t)(n - pos);
+      r->flags = DASM6805_TRUNC;
+      }
+
+    for (i=0; i<DASM6805_INSNMAX; i++) r->bytes[i] = i < r->len ? p[pos+i] : 0;
+    r->target = r->flags ? DASM6805_NOTARGET : FlowTarget(d, r->bytes, r->addr);
+
+    pos += r->len;
+    }
+  return k;
+  } // DasmDecode
+
+template size_t DasmDecode<Isa6805>(const BYTE*, size_t, DWORD, DASMINSN*, size_t);
+template size_t DasmDecode<IsaHC08>(const BYTE*, size_t, DWORD, DASMINSN*, size_t);
+template size_t DasmDecode<IsaHC11>(const BYTE*, size_t, DWORD, DASMINSN*, size_t);
+
+//-----------------------------------------------------------------------------
+//
+//                          Dasm6805Decode
+//
+// Linear sweep decode of the n bytes p[0..n-1] (p[0] at address 'base')
+// into at most 'cap' instruction records out[]. An instruction cut off
+// by the end of the buffer gets the flag DASM6805_TRUNC and the length
+// of the bytes left. The bytes decoded are out[k-1].addr + out[k-1].len
+// - base, so a caller can continue with the next buffer from there.
+//
+// Returns the number k of records filled.
+//
+extern "C" size_t Dasm6805Decode(const uint8_t* p, size_t n, uint32_t base, DASMINSN* out, size_t cap)
+  {
+  return DasmDecode<Isa6805>(p, n, base, out, cap);
+  } // Dasm6805Decode
+
+//-----------------------------------------------------------------------------
+//
+//                          Dasm6805DecodeCpu
+//
+// Dasm6805Decode for the instruction set 'cpu' (DASM6805_HC05, _HC08,
+// _HC11). Returns 0 for an unknown cpu.
+//
+extern "C" size_t Dasm6805DecodeCpu(unsigned cpu, const uint8_t* p, size_t n, uint32_t base,
+                                    DASMINSN* out, size_t cap)
+  {
+  if (cpu > DASM6805_HC11) return 0;
+  return ISACALL(cpu, DasmDecode, (p, n, base, out, cap));
+  } // Dasm6805DecodeCpu
+
+//-----------------------------------------------------------------------------
+//
+//                          Dasm6805Format
+//
+// Format the instruction record 'in' as a listing line, exactly as in
+// the disassembler listing (without the '\n'), into buf[0..size-1].
+// 'name' (NULL = none) may supply names for the branch and jump
+// targets, 'ctx' is passed on to it.
+//
+// Returns the length of the line (like snprintf, the line is cut off
+// if it does not fit, size DASM6805_LINEMAX always fits).
+//
+extern "C" size_t Dasm6805Format(const DASMINSN* in, char* buf, size_t size, DASMNAMEPROC name, void* ctx)
+  {
+  char line[LINEMAX];
+  size_t n, m;
+
+  n = ISACALL(in->cpu, DasmRender, (line, in->bytes, in->addr, in->len, name, ctx, NULL, NULL)) - line;
+  if (size)
+    {
+    m = n < size ? n : size-1;
+    memcpy(buf, line, m);
+    buf[m] = 0;
+    }
+  return n;
+  } // Dasm6805Format
+
+//-----------------------------------------------------------------------------
+//
+//                          Dasm6805Mnemonic
+//
+// Returns the name of the mnemonic identifier MNE_xxx, NULL if unknown.
+//
+extern "C" const char* Dasm6805Mnemonic(unsigned mne)
+  {
+  return mne < MNE_COUNT ? mneName[mne] : NULL;
+  } // Dasm6805Mnemonic
+
+//-----------------------------------------------------------------------------
+//
+//                          Dasm6805Seek
+//
+// Look up the address 'addr' in the record file (-m b) mapped at
+// file[0..n-1]: the page index gives the records starting in the page
+// of addr, the one before them may reach into the page.
+//
+// Returns the record of the item covering addr, NULL if there is none
+// or the file is not a record file.
+//
+extern "C" const DASMREC* Dasm6805Seek(const void* file, size_t n, uint32_t addr)
+  {
+  const DASMREC* rec = (const DASMREC*)file;
+  const DASMRECTAIL* t;
+  const uint32_t* index;
+  uint32_t page, lo, hi, m;
+
+  if (n < sizeof(DASMRECTAIL) || n % sizeof(uint32_t)) return NULL;   // The tail aligned as the records
+  t = (const DASMRECTAIL*)((const char*)file + n - sizeof(DASMRECTAIL));
+  if (t->magic != DASMREC_MAGIC || t->version != DASMREC_VERSION || t->recsize != sizeof(DASMREC) ||
+      t->shift > 31 || t->nindex == 0 ||
+      (unsigned long long)t->count * sizeof(DASMREC) + (unsigned long long)t->nindex * sizeof(uint32_t) +
+      sizeof(DASMRECTAIL) != n)
+    return NULL;
+  index = (const uint32_t*)(rec + t->count);
+
+  if (addr < t->org) return NULL;
+  page = (addr - t->org) >> t->shift;
+  if (page >= t->nindex - 1) return NULL;
+  hi = index[page+1];
+  lo = index[page] ? index[page] - 1 : 0;
+  if (hi > t->count || lo >= hi) return NULL;
+
+  while (hi - lo > 1)                           // Last record at or below addr
+    {
+    m = (lo + hi) / 2;
+    if (rec[m].addr <= addr) lo = m;
+    else hi = m;
+    }
+  return (rec[lo].addr <= addr && addr - rec[lo].addr < rec[lo].len) ? &rec[lo] : NULL;
+  } // Dasm6805Seek
+
+//--------------------------end-of-c++-module-----------------------------------
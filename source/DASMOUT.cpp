@@ -0,0 +1,412 @@
+// haDASM - Disassembler for Microchip processors
+// dasmout.cpp - C++ Developer source file.
+// (c)1990-2023 by helmut altmann
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; see the file COPYING.  If not, write to
+// the Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+// Boston, MA 02111-1307, USA.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <windows.h>
+
+#include "equate.h"
+#include "extern.h"
+#include "dasmisa.h"
+
+//-----------------------------------------------------------------------------
+//
+//                          OutOfMemory
+//
+// Checked allocation: exit if 'p' (the result of malloc, calloc or
+// realloc) is NULL. The message goes to stderr, stdout may be a
+// listing or a record file.
+//
+void OutOfMemory(void* p)
+  {
+  if (p != NULL) return;
+  fputs("Out of memory\n", stderr);
+  exit(1);
+  } // OutOfMemory
+
+// DASMNAMEPROC of the listing: label of the target 'addr' (ctx = SYMTAB)
+char* OutName(char* s, void* ctx, uint32_t addr)
+  {
+  const SYMENT* e = SymFind((const SYMTAB*)ctx, addr);
+  return (e && e->name) ? SymName(s, (const SYMTAB*)ctx, e) : NULL;
+  } // OutName
+
+//-----------------------------------------------------------------------------
+//
+//                          OutInit
+//
+// Initialize the output sink 'ob' to write blocks of OUTBUFSIZE to 'fp'.
+// With fp == NULL the listing text is collected in memory (ob->buf).
+//
+void OutInit(OUTBUF* ob, FILE* fp)
+  {
+  OutOfMemory(ob->buf = (char*)malloc(OUTBUFSIZE));
+  ob->size = OUTBUFSIZE;
+  ob->len  = 0;
+  ob->fp   = fp;
+  ob->sym  = NULL;
+  ob->cur  = 0;
+  ob->run  = NULL;
+  ob->fmt  = NULL;
+  ob->stats = NULL;
+  ob->xref = NULL;
+  ob->reg  = NULL;
+  } // OutInit
+
+//-----------------------------------------------------------------------------
+//
+//                          OutFlush
+//
+// Write the buffered listing text with one single fwrite
+// (the write phase of --stats).
+//
+void OutFlush(OUTBUF* ob)
+  {
+  int phase;
+
+  if (ob->fp == NULL) return;                   // Memory sink keeps the text
+  if (ob->len == 0) return;
+  if (ob->stats)
+    {
+    phase = ob->stats->phase;
+    StatPhase(ob, STAT_WRITE);
+    fwrite(ob->buf, 1, ob->len, ob->fp);
+    StatPhase(ob, phase);
+    ob->stats->out += ob->len;
+    }
+  else fwrite(ob->buf, 1, ob->len, ob->fp);
+  ob->len = 0;
+  } // OutFlush
+
+//-----------------------------------------------------------------------------
+//
+//                          OutRoom
+//
+// Make room for at least LINEMAX more chars: write the buffer,
+// or let a memory sink grow.
+//
+static void OutRoom(OUTBUF* ob)
+  {
+  if (ob->fp) OutFlush(ob);
+  else
+    {
+    ob->size *= 2;
+    OutOfMemory(ob->buf = (char*)realloc(ob->buf, ob->size));
+    }
+  } // OutRoom
+
+//-----------------------------------------------------------------------------
+//
+//                          OutFree
+//
+void OutFree(OUTBUF* ob)
+  {
+  OutFlush(ob);
+  free(ob->buf);
+  ob->buf = NULL;
+  } // OutFree
+
+//-----------------------------------------------------------------------------
+//
+//                          OutMem
+//
+// Copy 'n' chars of text of any length into the output sink.
+//
+void OutMem(OUTBUF* ob, const char* s, size_t n)
+  {
+  while (n)
+    {
+    size_t m = ob->size - ob->len;
+    if (m == 0) { OutRoom(ob); continue; }
+    if (m > n) m = n;
+    memcpy(ob->buf + ob->len, s, m);
+    ob->len += m; s += m; n -= m;
+    }
+  } // OutMem
+
+//-----------------------------------------------------------------------------
+//
+//                          OutStr
+//
+void OutStr(OUTBUF* ob, const char* s)
+  {
+  OutMem(ob, s, strlen(s));
+  } // OutStr
+
+//-----------------------------------------------------------------------------
+//
+//                          OutNote
+//
+// A note or warning line 's' of the disassembler: part of the listing
+// text, but it goes to stderr beside machine-readable output.
+//
+void OutNote(OUTBUF* ob, const char* s)
+  {
+  if (ob->fmt) fputs(s, stderr);
+  else OutStr(ob, s);
+  } // OutNote
+
+//-----------------------------------------------------------------------------
+//
+//                          DasmLine
+//
+// Disassemble the instruction at p[0] (address pc) into one listing
+// line (see DasmRender) and append it to the output sink 'ob'.
+// 'avail' is the number of image bytes left at p[0].
+// With a symbol table (ob->sym) the known targets are shown by name,
+// with a register map (ob->reg) the I/O registers.
+// Machine-readable output gets a record instead (see FmtLine).
+// The instruction is counted in ob->stats (--stats), its direct page
+// accesses are noted with their counts of ob->xref (-a).
+//
+// Returns the number of bytes consumed (1..ISA::maxlen).
+//
+template<class ISA>
+int DasmLine(OUTBUF* ob, const BYTE* p, DWORD pc, DWORD avail)
+  {
+  const OPDESC* d = ISA::Desc(p, avail);
+  char* s;
+  int n;
+
+  n = d->len > avail ? avail : d->len;
+  if (ob->stats)
+    {
+    ob->stats->op[ISA::Index(d)]++;
+    ob->stats->mode[d->mode]++;
+    ob->stats->code += n;
+    }
+
+  if (ob->fmt) return FmtLine<ISA>(ob, p, pc, avail);
+  if (ob->size - ob->len < LINEMAX) OutRoom(ob);
+  s = DasmRender<ISA>(ob->buf + ob->len, p, pc, avail, ob->sym ? OutName : NULL, ob->sym, ob->reg, NULL);
+  if (ob->xref) s = XrefNote<ISA>(s, ob->xref, p, avail);
+
+  // For the sake of legibility:
+  // Insert a blank line after unconditional BRAs, JMPs, RTS and RTI
+  if (n == d->len && (d->flow == FC_JUMP || d->flow == FC_RET)) *s++ = '\n';
+
+  *s++ = '\n';
+  ob->len = s - ob->buf;
+  return n;
+  } // DasmLine
+
+template int DasmLine<Isa6805>(OUTBUF*, const BYTE*, DWORD, DWORD);
+template int DasmLine<IsaHC08>(OUTBUF*, const BYTE*, DWORD, DWORD);
+template int DasmLine<IsaHC11>(OUTBUF*, const BYTE*, DWORD, DWORD);
+
+//-----------------------------------------------------------------------------
+//
+//                          DasmLabel
+//
+// Label line "name:" ahead of the instruction at address pc, if pc is
+// a defined symbol of ob->sym. The listing runs upwards, so does the
+// cursor ob->cur (set with SymSeek when the listing starts).
+//
+// Returns the number of source lines produced (0 or 1).
+//
+int DasmLabel(OUTBUF* ob, DWORD pc)
+  {
+  const SYMTAB* st = ob->sym;
+  const SYMENT* e;
+  char* s;
+
+  while (ob->cur < st->count && st->sym[ob->cur].addr < pc) ob->cur++;
+  if (ob->cur >= st->count) return 0;
+  e = &st->sym[ob->cur];
+  if (e->addr != pc || !(e->name & SYMDEF)) return 0;
+  if (ob->fmt)                                  // Goes with the next record
+    {
+    FmtLabel(ob, e);
+    return 0;
+    }
+
+  if (ob->size - ob->len < LINEMAX) OutRoom(ob);
+  s = SymName(ob->buf + ob->len, ob->sym, e);
+  *s++ = ':';
+  *s++ = '\n';
+  ob->len = s - ob->buf;
+  return 1;
+  } // DasmLabel
+
+//-----------------------------------------------------------------------------
+//
+//                          DasmOrg
+//
+// Origin line of the populated range of a hex file at address pc,
+// after a gap.
+//
+// Returns the number of source lines produced (0 or 1).
+//
+int DasmOrg(OUTBUF* ob, DWORD pc)
+  {
+  char* s;
+
+  if (ob->fmt) return 0;                        // The records have addresses
+  if (ob->size - ob->len < LINEMAX) OutRoom(ob);
+  s = ob->buf + ob->len;
+  if (ob->len < 2 || ob->buf[ob->len-2] != '\n') *s++ = '\n';  // One blank line
+  s = PutAddr(s, pc);
+  s = PutStr(s, "  \t\t\t\torg\t$");
+  s = PutAddr(s, pc);
+  *s++ = '\n';
+  ob->len = s - ob->buf;
+  return 1;
+  } // DasmOrg
+
+//-----------------------------------------------------------------------------
+//
+//                          DasmData
+//
+// List the 'n' data bytes at p[0] (address pc) as FCB lines
+// of up to 8 bytes each.
+//
+// Returns the number of source lines produced.
+//
+int DasmData(OUTBUF* ob, const BYTE* p, DWORD pc, DWORD n)
+  {
+  DWORD m, i;
+  int lines = 0;
+  char* s;
+
+  if (ob->stats) ob->stats->data += n;
+  while (n)
+    {
+    m = n > 8 ? 8 : n;
+    if (ob->fmt)                                // One record per FCB line
+      {
+      FmtData(ob, DASMREC_DATA, p, pc, m);
+      lines++;
+      p += m; pc += m; n -= m;
+      continue;
+      }
+
+    if (ob->size - ob->len < LINEMAX) OutRoom(ob);
+    s = ob->buf + ob->len;
+
+    s = PutAddr(s, pc);
+    s = PutStr(s, "  \t\t\t\tfcb\t");
+    for (i=0; i<m; i++)
+      {
+      if (i) *s++ = ',';
+      *s++ = '$';
+      s = PutHex2(s, p[i]);
+      }
+    *s++ = '\n';
+
+    ob->len = s - ob->buf;
+    lines++;
+    p += m; pc += m; n -= m;
+    }
+  return lines;
+  } // DasmData
+
+//-----------------------------------------------------------------------------
+//
+//                          DasmRun
+//
+// List the 'n' bytes at p[0] (address pc) of the fill run or string
+// 'r' (see dasmrun.cpp): a run as one line "fcb n dup $xx", a string
+// as FCC lines of up to TEXTLINE chars.
+//
+// Returns the number of source lines produced.
+//
+int DasmRun(OUTBUF* ob, const RUNENT* r, const BYTE* p, DWORD pc, DWORD n)
+  {
+  DWORD m, i;
+  int lines = 0;
+  char* s;
+
+  if (ob->stats) ob->stats->data += n;
+  while (n)
+    {
+    if (ob->fmt)                                // One record per line
+      {
+      m = (r->kind == RUN_FILL || n <= TEXTLINE) ? n : TEXTLINE;
+      FmtData(ob, r->kind == RUN_FILL ? DASMREC_FILL : DASMREC_TEXT, p, pc, m);
+      lines++;
+      p += m; pc += m; n -= m;
+      continue;
+      }
+
+    if (ob->size - ob->len < LINEMAX) OutRoom(ob);
+    s = ob->buf + ob->len;
+
+    s = PutAddr(s, pc);
+    if (r->kind == RUN_FILL)
+      {
+      m = n;
+      s = PutStr(s, "  \t\t\t\tfcb\t");
+      s = PutDec(s, m);
+      s = PutStr(s, " dup $");
+      s = PutHex2(s, r->fill);
+      s = PutStr(s, "\t\t; ..");
+      s = PutAddr(s, pc + m - 1);
+      }
+    else
+      {
+      m = n > TEXTLINE ? TEXTLINE : n;
+      s = PutStr(s, "  \t\t\t\tfcc\t\"");
+      for (i=0; i<m; i++) *s++ = (char)p[i];
+      *s++ = '"';
+      }
+    *s++ = '\n';
+
+    ob->len = s - ob->buf;
+    lines++;
+    p += m; pc += m; n -= m;
+    }
+  return lines;
+  } // DasmRun
+
+//-----------------------------------------------------------------------------
+//
+//                          DasmDataRuns
+//
+// Like DasmData, but the fill runs and strings of ob->run within the
+// 'n' data bytes at p[0] (address pc) are listed with DasmRun.
+//
+// Returns the number of source lines produced.
+//
+int DasmDataRuns(OUTBUF* ob, const BYTE* p, DWORD pc, DWORD n)
+  {
+  const RUNENT* r;
+  DWORD k, m;
+  int lines = 0;
+
+  for (k=RunSeek(ob->run, pc); n; p += m, pc += m, n -= m)
+    {
+    r = k < ob->run->count ? &ob->run->run[k] : NULL;
+    if (r && r->addr <= pc)
+      {
+      m = r->addr + r->len - pc;
+      if (m > n) m = n;
+      lines += DasmRun(ob, r, p, pc, m);
+      k++;
+      }
+    else
+      {
+      m = (r && r->addr - pc < n) ? r->addr - pc : n;
+      lines += DasmData(ob, p, pc, m);
+      }
+    }
+  return lines;
+  } // DasmDataRuns
+
+//--------------------------end-of-c++-module-----------------------------------
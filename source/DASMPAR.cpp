@@ -0,0 +1,284 @@
+// haDASM - Disassembler for Microchip processors
+// dasmpar.cpp - C++ Developer source file.
+// (c)1990-2023 by helmut altmann
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; see the file COPYING.  If not, write to
+// the Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+// Boston, MA 02111-1307, USA.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <windows.h>
+
+#include <thread>
+
+#include "equate.h"
+#include "extern.h"
+#include "dasmisa.h"
+
+// --------------------------------------------
+// Parallel linear sweep
+// --------------------------------------------
+// The image is split into chunks which are disassembled concurrently,
+// each into its own memory listing. A worker starts PARMARGIN bytes
+// before its chunk: the variable length M68HC05 instructions mostly
+// fall into step with the serial sweep within a few instructions, so
+// its first instruction in the chunk is almost always where the
+// serial sweep would be. The first PARSYNC instruction starts of each
+// chunk are kept, the chunk listing begins after them. When the
+// listings are stitched together the serial sweep continues from the
+// end of the previous chunk until it meets one of these starts, and
+// on to the chunk listing; from there on both sweeps are identical.
+// So the statistics (--stats) count each listed line once.
+//
+typedef struct tag_PARPART {
+  DWORD  start;             // Chunk [start, stop)
+  DWORD  stop;
+  DWORD  rest;              // Address of the first line in out
+  DWORD  end;               // Address following the last instruction
+  int    lines;             // Source lines in out
+  int    nsync;             // Entries in sync[], 0 = failed
+  DWORD  sync[PARSYNC];     // First instruction starts of the chunk
+  OUTBUF out;               // Listing of the chunk, from rest on
+  DASMSTATS stats;          // Its counters (--stats)
+} PARPART;
+
+typedef struct tag_PARRUN {
+  const IMAGE* im;          // Image, shared by the workers (ImageShare)
+  SYMTAB* sym;              // Labels, NULL = none
+  const RUNTAB* runs;       // Fill runs and strings, NULL = none
+  int stats;                // TRUE: count the chunks (--stats)
+  XREF* xref;               // Direct page accesses, NULL = none
+  const REGMAP* reg;        // Register names, NULL = none
+  PARPART* part;            // Chunks of the current round
+} PARRUN;
+
+// Skip the instructions from 'pc' up to 'stop' without listing them
+template<class ISA>
+static DWORD ParSkip(const IMAGE* im, DWORD pc, DWORD stop)
+  {
+  while (pc < stop) pc += ISA::Desc(&im->data[pc - im->base], im->base + im->len - pc)->len;
+  return pc;
+  } // ParSkip
+
+//-----------------------------------------------------------------------------
+//
+//                          ParJob
+//
+// Disassemble chunk 'job' of the current round into memory. The
+// lines of the instruction starts kept are left to the stitching.
+//
+static void ParJob(void* ctx, int job)
+  {
+  PARRUN* run = (PARRUN*)ctx;
+  PARPART* pp = &run->part[job];
+  IMAGE im;
+  DWORD pc;
+
+  OutInit(&pp->out, NULL);
+  pp->out.sym = run->sym;
+  pp->out.run = run->runs;
+  pp->out.xref = run->xref;
+  pp->out.reg = run->reg;
+  if (run->stats) StatInit(&pp->stats, run->im->cpu);
+  pp->lines = 0;
+  pp->nsync = 0;
+  if (!ImageShare(&im, run->im)) return;
+
+  pc = pp->start > PARMARGIN ? pp->start - PARMARGIN : 0;
+  if ((pc >= im.base && pc < im.base + im.len) || ImageWindow(&im, pc))
+    {
+    // Skip the instructions before the chunk without listing them
+    pc = ISACALL(im.cpu, ParSkip, (&im, pc, pp->start));
+
+    // Keep the first instruction starts for the resynchronisation
+    while (pp->nsync < PARSYNC && pc < pp->stop)
+      {
+      pp->sync[pp->nsync++] = pc;
+      pc = DasmRange(&im, &pp->out, pc, pc+1, &pp->lines);
+      }
+    pp->out.len = 0;                            // (Listed by the stitching)
+    pp->lines = 0;
+    pp->rest = pc;
+    if (run->stats) pp->out.stats = &pp->stats;
+    pp->end = DasmRange(&im, &pp->out, pc, pp->stop, &pp->lines);
+    }
+  ImageClose(&im);
+  } // ParJob
+
+//-----------------------------------------------------------------------------
+//
+//                          DasmImagePar
+//
+// Parallel linear sweep disassembly of the image 'im' into 'ob'. The
+// listing and the statistics (--stats) are identical to the ones of
+// DasmRange(im, ob, 0, size). The workers share 'im' (see ImageShare).
+// The chunks are done in rounds of a few per thread, which keeps the
+// memory bounded for images of any size.
+//
+// Returns the number of source lines produced.
+//
+int DasmImagePar(IMAGE* im, OUTBUF* ob, const DASMOPT* opt)
+  {
+  DWORD nchunk, first, e = 0;
+  int threads, round, n, j, m, lines = 0;
+  PARPART* pp;
+  PARRUN run;
+
+  threads = opt->threads > 0 ? opt->threads : std::thread::hardware_concurrency();
+  if (threads <= 0) threads = 1;
+  round = 4*threads;
+
+  nchunk = (im->size + opt->chunk - 1) / opt->chunk;
+  if (im->hMap == NULL && im->size <= IMAGEWINDOW) ImageWindow(im, 0);  // Read as a whole
+  run.im = im;
+  run.sym = ob->sym;
+  run.runs = ob->run;
+  run.stats = ob->stats != NULL;
+  run.xref = ob->xref;
+  run.reg = ob->reg;
+  run.part = new PARPART[round];
+
+  for (first=0; first<nchunk; first+=round)
+    {
+    n = (nchunk - first < (DWORD)round) ? nchunk - first : round;
+    for (j=0; j<n; j++)
+      {
+      run.part[j].start = (first+j) * opt->chunk;
+      run.part[j].stop  = (first+j+1 == nchunk) ? im->size : run.part[j].start + opt->chunk;
+      }
+
+    PoolRun(n, threads, ParJob, &run);
+
+    // -------- Stitch the chunks together --------
+    //
+    for (j=0; j<n; j++)
+      {
+      pp = &run.part[j];
+      m = 0;
+      for (;;)
+        {
+        while (m < pp->nsync && pp->sync[m] < e) m++;
+        if (m >= pp->nsync || pp->sync[m] == e) break;
+        e = DasmRange(im, ob, e, e+1, &lines);  // One more serial instruction
+        }
+
+      if (m < pp->nsync)                        // In step: take over the chunk
+        {
+        e = DasmRange(im, ob, e, pp->rest, &lines);
+        OutMem(ob, pp->out.buf, pp->out.len);
+        lines += pp->lines;
+        e = pp->end;
+        if (ob->stats) StatAdd(ob->stats, &pp->stats);
+        }
+      else                                      // Out of step (or failed)
+        e = DasmRange(im, ob, e, pp->stop, &lines);
+      OutFree(&pp->out);
+      } // end for j
+    } // end for first
+
+  delete[] run.part;
+  return lines;
+  } // DasmImagePar
+
+//-----------------------------------------------------------------------------
+//
+//                          DasmVerify
+//
+// Self test of the parallel sweep: the listing of file 'name' is made
+// serially and in parallel with several (mostly tiny) chunk sizes and
+// compared byte by byte (with options -l, -f including the labels,
+// the fill runs and strings), and so are the counters of --stats.
+//
+// Returns the number of mismatches (ERR if the file can't be opened).
+//
+int DasmVerify(const char* name, const DASMOPT* opt)
+  {
+  static const DWORD chunk[] = {PARMARGIN+1, 61, 1000, 4099, PARCHUNK};
+  OUTBUF ser, par;
+  DASMSTATS sst, pst;
+  DASMOPT o = *opt;
+  SYMTAB sym;
+  RUNTAB runs;
+  IMAGE im;
+  int n, lser, lpar, errors = 0;
+  size_t i;
+
+  if (ImageOpen(&im, name) == ERR)
+    {
+    printf("Open failed on %s\n", name);
+    return ERR;
+    }
+  im.cpu = opt->cpu;
+  if (im.kind != HEX_NONE)                      // (Listed serially)
+    {
+    printf("Parallel sweep of %s: not for hex files\n", name);
+    ImageClose(&im);
+    return ERR;
+    }
+
+  if (opt->fill) RunScan(&im, &runs);
+  if (opt->labels)
+    {
+    SymCopy(&sym, opt->user);
+    SymScan(&im, &sym, opt->fill ? &runs : NULL);
+    }
+
+  OutInit(&ser, NULL);
+  if (opt->labels) ser.sym = &sym;
+  if (opt->fill) ser.run = &runs;
+  ser.reg = opt->reg;
+  StatInit(&sst, im.cpu);
+  ser.stats = &sst;
+  lser = 0;
+  DasmRange(&im, &ser, 0, im.size, &lser);
+
+  for (n=0; n<(int)(sizeof(chunk)/sizeof(chunk[0])); n++)
+    {
+    o.chunk = chunk[n];
+    OutInit(&par, NULL);
+    par.sym = ser.sym;
+    par.run = ser.run;
+    par.reg = ser.reg;
+    StatInit(&pst, im.cpu);
+    par.stats = &pst;
+    lpar = DasmImagePar(&im, &par, &o);
+
+    for (i=0; i<ser.len && i<par.len && ser.buf[i] == par.buf[i]; i++);
+    printf("Parallel sweep of %s, %u chunks of %u bytes: ", name,
+           (unsigned)((im.size + o.chunk - 1) / o.chunk), (unsigned)o.chunk);
+    if (lser != lpar || ser.len != par.len || i != ser.len)
+      {
+      printf("MISMATCH at listing offset %u\n", (unsigned)i);
+      errors++;
+      }
+    else if (sst.code != pst.code || sst.data != pst.data || memcmp(sst.op, pst.op, sizeof(sst.op)) ||
+             memcmp(sst.mode, pst.mode, sizeof(sst.mode)))
+      {
+      printf("MISMATCH of the statistics\n");
+      errors++;
+      }
+    else printf("%d lines identical\n", lpar);
+    OutFree(&par);
+    }
+
+  OutFree(&ser);
+  if (opt->labels) SymFree(&sym);
+  if (opt->fill) RunFree(&runs);
+  ImageClose(&im);
+  return errors;
+  } // DasmVerify
+
+//--------------------------end-of-c++-module-----------------------------------
@@ -0,0 +1,365 @@
+// haDASM - Disassembler for Microchip processors
+// dasmpipe.cpp - C++ Developer source file.
+// (c)1990-2023 by helmut altmann
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; see the file COPYING.  If not, write to
+// the Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+// Boston, MA 02111-1307, USA.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <io.h>
+#include <windows.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "equate.h"
+#include "extern.h"
+#include "dasmisa.h"
+
+// --------------------------------------------
+// Streaming listing of stdin (-)
+// --------------------------------------------
+// An image from a pipe (zcat dump.bin.gz | dasm -) has no size and
+// can't be mapped. It is listed in a linear sweep by three stages
+// that overlap:
+//
+//   read     stdin into chunks of up to PIPECHUNK bytes (any short
+//            read is passed on as it is)
+//   decode   the chunks into blocks of DASMINSN records (DasmDecode)
+//   format   the records into listing lines and write them
+//
+// Each stage runs on its own thread (decode on the caller's), joined
+// by two single-producer/single-consumer rings of PIPESLOTS slots.
+// A ring is a pair of counters, the producer only writes 'head', the
+// consumer only 'tail', so it needs no lock. A stage that has to wait
+// yields PIPESPIN times, then it sleeps a little. The memory is the
+// slots and the listing buffer, whatever the size of the input.
+//
+// An instruction is only decoded with ISA::maxlen bytes at hand (or at
+// the end of the input), just like the window of DasmSweep: the bytes
+// of an instruction cut by the end of a chunk are carried over to the
+// next one. A record keeps all these bytes, the listing line of a
+// lone prefix byte depends on the byte after it. The listing is the
+// same as the one of the image file.
+// The format stage writes the listing whenever it runs out of
+// records, so the output follows the input as it comes.
+//
+typedef struct tag_PIPERING {
+  std::atomic<DWORD> head;        // Slots filled by the producer
+  char pad[64 - sizeof(DWORD)];   // One cache line per counter
+  std::atomic<DWORD> tail;        // Slots taken by the consumer
+} PIPERING;
+
+typedef struct tag_PIPEIN {
+  DWORD  len;                     // Bytes read, 0 = end of the input
+  BYTE   data[PIPECHUNK];
+} PIPEIN;
+
+typedef struct tag_PIPEBLOCK {
+  DWORD  count;                   // Records, 0 = end of the input
+  DASMINSN rec[PIPEREC];          // bytes[] up to avail[] (not only len)
+  BYTE   avail[PIPEREC];          // Bytes at hand of rec[], up to ISA::maxlen
+} PIPEBLOCK;
+
+typedef struct tag_PIPE {
+  int    fd;                      // Input
+  DWORD  read;                    // Largest read
+  OUTBUF* ob;                     // Listing
+  PIPERING in;                    // read -> decode
+  PIPERING out;                   // decode -> format
+  PIPEIN* chunk;                  // Slots of 'in'
+  PIPEBLOCK* block;               // Slots of 'out'
+  DWORD  size;                    // Bytes decoded
+  int    lines;                   // Source lines produced
+  int    error;                   // TRUE: read error
+} PIPE;
+
+static void PipeWait(int* spin)
+  {
+  if (++*spin < PIPESPIN) std::this_thread::yield();
+  else std::this_thread::sleep_for(std::chrono::microseconds(100));
+  } // PipeWait
+
+// Producer: the free slot of ring 'r' (waits for one)
+static DWORD PipeFree(PIPERING* r)
+  {
+  DWORD h = r->head.load(std::memory_order_relaxed);
+  int spin = 0;
+
+  while (h - r->tail.load(std::memory_order_acquire) == PIPESLOTS) PipeWait(&spin);
+  return h % PIPESLOTS;
+  } // PipeFree
+
+// Producer: pass the slot on
+static void PipePut(PIPERING* r)
+  {
+  r->head.store(r->head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  } // PipePut
+
+// Consumer: the next filled slot of ring 'r', ERR if there is none yet
+static int PipeTry(PIPERING* r)
+  {
+  DWORD t = r->tail.load(std::memory_order_relaxed);
+
+  if (t == r->head.load(std::memory_order_acquire)) return ERR;
+  return t % PIPESLOTS;
+  } // PipeTry
+
+// Consumer: the next filled slot of ring 'r' (waits for one)
+static int PipeGet(PIPERING* r)
+  {
+  int slot, spin = 0;
+
+  while ((slot = PipeTry(r)) == ERR) PipeWait(&spin);
+  return slot;
+  } // PipeGet
+
+// Consumer: the slot is free again
+static void PipeDone(PIPERING* r)
+  {
+  r->tail.store(r->tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+  } // PipeDone
+
+//-----------------------------------------------------------------------------
+//
+//                          PipeRead
+//
+// Read stage: the input into the chunks of pp->in, up to the end of
+// the input (or a read error), which is passed on as an empty chunk.
+//
+static void PipeRead(PIPE* pp)
+  {
+  PIPEIN* c;
+  int n;
+
+  do
+    {
+    c = &pp->chunk[PipeFree(&pp->in)];
+    if ((n = read(pp->fd, c->data, pp->read)) < 0)
+      {
+      pp->error = TRUE;
+      n = 0;
+      }
+    c->len = n;
+    PipePut(&pp->in);
+    } while (n);
+  } // PipeRead
+
+//-----------------------------------------------------------------------------
+//
+//                          PipeDecode
+//
+// Decode stage: the chunks of pp->in into the record blocks of
+// pp->out. A block is passed on when it is full or the chunk is done,
+// an empty block ends the listing.
+//
+template<class ISA>
+static void PipeDecode(PIPE* pp)
+  {
+  BYTE join[ISA::maxlen];                       // An instruction across the chunks
+  const PIPEIN* c;
+  PIPEBLOCK* b;
+  DWORD pc = 0, k = 0, pos, n, m, i;
+  BOOL end;
+
+  b = &pp->block[PipeFree(&pp->out)];
+  b->count = 0;
+  do
+    {
+    c = &pp->chunk[PipeGet(&pp->in)];
+    n = c->len;
+    end = n == 0;
+    pos = 0;
+
+    // The instruction cut by the end of the last chunk, with the end
+    // of the input the rest of it (a short one)
+    while (k && (pos < n || end))
+      {
+      while (k < ISA::maxlen && pos < n) join[k++] = c->data[pos++];
+      if (k < ISA::maxlen && !end) break;       // Still too short
+      if (b->count == PIPEREC)
+        {
+        PipePut(&pp->out);
+        b = &pp->block[PipeFree(&pp->out)];
+        b->count = 0;
+        }
+      DasmDecode<ISA>(join, k, pc, &b->rec[b->count], 1);
+      memcpy(b->rec[b->count].bytes, join, k);
+      b->avail[b->count] = (BYTE)k;
+      m = b->rec[b->count++].len;
+      memmove(join, &join[m], k - m);
+      k -= m;
+      pc += m;
+      }
+
+    // The whole instructions of the chunk
+    while (k == 0 && pos + ISA::maxlen <= n)
+      {
+      if (b->count == PIPEREC)
+        {
+        PipePut(&pp->out);
+        b = &pp->block[PipeFree(&pp->out)];
+        b->count = 0;
+        }
+      m = (DWORD)DasmDecode<ISA>(&c->data[pos], n - pos, pc, &b->rec[b->count], PIPEREC - b->count);
+      for (i=0; i<m && b->rec[b->count].addr - pc + ISA::maxlen <= n - pos; i++)
+        {
+        memcpy(b->rec[b->count].bytes, &c->data[pos + b->rec[b->count].addr - pc], ISA::maxlen);
+        b->avail[b->count++] = ISA::maxlen;
+        }
+      if (i < m)
+        {
+        pos += b->rec[b->count].addr - pc;
+        pc = b->rec[b->count].addr;
+        break;
+        }
+      pos += b->rec[b->count-1].addr + b->rec[b->count-1].len - pc;
+      pc = b->rec[b->count-1].addr + b->rec[b->count-1].len;
+      }
+    while (pos < n) join[k++] = c->data[pos++]; // Less than ISA::maxlen
+    PipeDone(&pp->in);
+
+    if (b->count)                               // Output follows input
+      {
+      PipePut(&pp->out);
+      b = &pp->block[PipeFree(&pp->out)];
+      b->count = 0;
+      }
+    } while (!end);
+
+  PipePut(&pp->out);                            // The empty block
+  pp->size = pc;
+  } // PipeDecode
+
+//-----------------------------------------------------------------------------
+//
+//                          PipeFormat
+//
+// Format stage: the records of pp->out into listing lines (as DasmLine
+// does), counted in ob->stats (--stats). The listing is written
+// whenever there is no block to be formatted.
+//
+template<class ISA>
+static void PipeFormat(PIPE* pp)
+  {
+  OUTBUF* ob = pp->ob;
+  const PIPEBLOCK* b;
+  const DASMINSN* r;
+  const OPDESC* d;
+  char line[LINEMAX], *s;
+  int slot, spin;
+  DWORD i;
+
+  StatPhase(ob, STAT_FORMAT);
+  for (;;)
+    {
+    if ((slot = PipeTry(&pp->out)) == ERR)
+      {
+      if (ob->fp && ob->len)                    // Idle: write what there is
+        {
+        OutFlush(ob);
+        fflush(ob->fp);
+        }
+      spin = 0;
+      while ((slot = PipeTry(&pp->out)) == ERR) PipeWait(&spin);
+      }
+    b = &pp->block[slot];
+    if (b->count == 0) break;
+
+    for (i=0, r=b->rec; i<b->count; i++, r++)
+      {
+      if (ob->stats)
+        {
+        d = ISA::Desc(r->bytes, b->avail[i]);
+        ob->stats->op[ISA::Index(d)]++;
+        ob->stats->mode[d->mode]++;
+        ob->stats->code += r->len;
+        }
+      s = DasmRender<ISA>(line, r->bytes, r->addr, b->avail[i], NULL, NULL, ob->reg, NULL);
+
+      // For the sake of legibility:
+      // Insert a blank line after unconditional BRAs, JMPs, RTS and RTI
+      if (!(r->flags & DASM6805_TRUNC) && (r->flow == FC_JUMP || r->flow == FC_RET)) *s++ = '\n';
+
+      *s++ = '\n';
+      OutMem(ob, line, s - line);
+      }
+    pp->lines += b->count;
+    PipeDone(&pp->out);
+    }
+  PipeDone(&pp->out);
+  StatPhase(ob, STAT_NONE);
+  } // PipeFormat
+
+template<class ISA>
+static void PipeRun(PIPE* pp)
+  {
+  std::thread reader(PipeRead, pp);
+  std::thread writer(PipeFormat<ISA>, pp);
+
+  PipeDecode<ISA>(pp);
+  reader.join();
+  writer.join();
+  } // PipeRun
+
+//-----------------------------------------------------------------------------
+//
+//                          DasmStream
+//
+// Complete listing of the image read from 'fd' (stdin) into 'ob':
+// heading, linear sweep disassembly and the trailing statistics
+// lines, the same as DasmFile gives for the image file. The listing
+// is written while the image is read (see above).
+//
+// Returns ERR on a read error.
+//
+int DasmStream(int fd, OUTBUF* ob, const DASMOPT* opt)
+  {
+  char line[LINEMAX];
+  PIPE pp;
+
+  pp.fd    = fd;
+  pp.read  = opt->chunk < PIPECHUNK ? opt->chunk : PIPECHUNK;
+  pp.ob    = ob;
+  pp.size  = 0;
+  pp.lines = 0;
+  pp.error = FALSE;
+  pp.in.head = pp.in.tail = 0;
+  pp.out.head = pp.out.tail = 0;
+  OutOfMemory(pp.chunk = (PIPEIN*)malloc(PIPESLOTS * sizeof(PIPEIN)));
+  OutOfMemory(pp.block = (PIPEBLOCK*)malloc(PIPESLOTS * sizeof(PIPEBLOCK)));
+
+  OutStr(ob, "Disassembly of STDIN\n\n");
+  ob->reg = opt->reg;
+  ISACALL(opt->cpu, PipeRun, (&pp));
+  ob->reg = NULL;
+  free(pp.chunk);
+  free(pp.block);
+  if (ob->stats) ob->stats->files++;
+
+  if (pp.error) OutNote(ob, "Read error\n");
+  OutStr(ob, "\n");
+  if (opt->cpu == DASM6805_HC05 && pp.size > ROMSIZE)
+    OutStr(ob, "Warning: STDIN exceeds M68HC05 ROM-Size\n");
+
+  sprintf(line, "%d Source lines produced\n", pp.lines);
+  OutStr(ob, line);
+  return pp.error ? ERR : 0;
+  } // DasmStream
+
+//--------------------------end-of-c++-module-----------------------------------
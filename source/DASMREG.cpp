@@ -0,0 +1,422 @@
+// haDASM - Disassembler for Microchip processors
+// dasmreg.cpp - C++ Developer source file.
+// (c)1990-2023 by helmut altmann
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; see the file COPYING.  If not, write to
+// the Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+// Boston, MA 02111-1307, USA.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <windows.h>
+
+#include "equate.h"
+#include "extern.h"
+
+// --------------------------------------------
+// Register maps of the derivatives (-i)
+// --------------------------------------------
+// The I/O registers of an MC68HC705 part sit at fixed addresses, the
+// listing shows them by name: "lda $013" becomes "lda TSR", a named
+// bit of the bit instructions is shown by name too: "brset 5,$013,.."
+// becomes "brset TOF,TSR,..".
+//
+// A register map is an open-addressed table of 1 << bits slots, the
+// home slot of an address is REGHASH (multiplicative hash, the top
+// bits of addr * mul), collisions go to the next free slot. The maps
+// of the built-in derivatives are perfect hash tables generated at
+// compile time: MakeRegTab() tries the multipliers until no two
+// registers share a slot, so a lookup is one slot and one compare
+// (probe 0), hit or miss. A map file is loaded into a table of the
+// same form with linear probing, its probe is the longest probe
+// sequence of its registers.
+//
+// Map file: one register per line, ';' starts a comment line,
+// the names of bit 7..0 (or '-') are optional:
+//
+//   name [equ] [$]hexaddr [b7 b6 b5 b4 b3 b2 b1 b0]
+//
+#define REGMUL      0x9E3779B1 // First multiplier tried (Fibonacci hashing)
+#define REGTRIES    65536     // Multipliers tried by MakeRegTab
+
+// The bits of a register in datasheet order: bit 7 first
+#define REGB(b7,b6,b5,b4,b3,b2,b1,b0) {b0, b1, b2, b3, b4, b5, b6, b7}
+
+typedef struct tag_REGTAB {
+  DWORD  mul;       // Multiplier of the perfect hash, 0 = none found
+  REGSLOT slot[1 << REGPARTBITS];
+} REGTAB;
+
+typedef struct tag_REGPART {
+  const char* name; // Derivative (without "MC68HC")
+  const REGTAB* tab;
+  DWORD  count;     // Registers
+} REGPART;
+
+typedef struct tag_REGLINE {
+  DWORD  addr;
+  DWORD  name;      // Offsets into the pool, 0 = none
+  DWORD  bit[REGBITS];
+  int    nr;        // Line number
+} REGLINE;
+
+// ---------------------------------------------------
+// MC68HC705C8A: SCI, SPI, 16 bit timer, COP
+// ---------------------------------------------------
+constexpr REGSLOT def705C8A[] = {
+  {0x00, "PORTA", {}},  {0x01, "PORTB", {}},  {0x02, "PORTC", {}},  {0x03, "PORTD", {}},
+  {0x04, "DDRA", {}},   {0x05, "DDRB", {}},   {0x06, "DDRC", {}},
+  {0x0A, "SPCR",  REGB("SPIE", "SPE", 0, "MSTR", "CPOL", "CPHA", "SPR1", "SPR0")},
+  {0x0B, "SPSR",  REGB("SPIF", "WCOL", 0, "MODF", 0, 0, 0, 0)},
+  {0x0C, "SPDR",  {}},
+  {0x0D, "BAUD",  REGB(0, 0, "SCP1", "SCP0", 0, "SCR2", "SCR1", "SCR0")},
+  {0x0E, "SCCR1", REGB("R8", "T8", 0, "M", "WAKE", 0, 0, 0)},
+  {0x0F, "SCCR2", REGB("TIE", "TCIE", "RIE", "ILIE", "TE", "RE", "RWU", "SBK")},
+  {0x10, "SCSR",  REGB("TDRE", "TC", "RDRF", "IDLE", "OR", "NF", "FE", 0)},
+  {0x11, "SCDR",  {}},
+  {0x12, "TCR",   REGB("ICIE", "OCIE", "TOIE", 0, 0, 0, "IEDG", "OLVL")},
+  {0x13, "TSR",   REGB("ICF", "OCF", "TOF", 0, 0, 0, 0, 0)},
+  {0x14, "ICRH", {}},   {0x15, "ICRL", {}},   {0x16, "OCRH", {}},   {0x17, "OCRL", {}},
+  {0x18, "TRH", {}},    {0x19, "TRL", {}},    {0x1A, "ATRH", {}},   {0x1B, "ATRL", {}},
+  {0x1C, "PROG",  REGB(0, 0, 0, 0, 0, "LAT", 0, "PGM")},
+  {0x1D, "COPRST", {}},
+  {0x1E, "COPCR", REGB(0, 0, 0, "COPF", "CME", "COPE", "CM1", "CM0")},
+  {0x1FDF, "OPTION", {}},
+  };
+
+// ---------------------------------------------------
+// MC68HC705J1A: 15 bit timer with real time interrupt
+// ---------------------------------------------------
+constexpr REGSLOT def705J1A[] = {
+  {0x00, "PORTA", {}},  {0x01, "PORTB", {}},  {0x04, "DDRA", {}},   {0x05, "DDRB", {}},
+  {0x08, "TSCR",  REGB("TOF", "RTIF", "TOIE", "RTIE", "TOFR", "RTIFR", "RT1", "RT0")},
+  {0x09, "TCR",   {}},
+  {0x0A, "ISCR",  REGB("IRQE", 0, 0, 0, "IRQF", 0, "IRQR", 0)},
+  {0x10, "PDRA", {}},   {0x11, "PDRB", {}},
+  {0x18, "EPROG", REGB(0, 0, 0, 0, 0, "ELAT", "MPGM", "EPGM")},
+  {0x07F0, "COPR", REGB(0, 0, 0, 0, 0, 0, 0, "COPC")},
+  {0x07F1, "MOR",  REGB("SOSCD", "EPMSEC", "OSCRES", "SWAIT", "SWPDI", "PIRQ", "LEVEL", "COPEN")},
+  };
+
+// ---------------------------------------------------
+// MC68HC705P9: SIOP, 16 bit timer, A/D converter
+// ---------------------------------------------------
+constexpr REGSLOT def705P9[] = {
+  {0x00, "PORTA", {}},  {0x01, "PORTB", {}},  {0x02, "PORTC", {}},  {0x03, "PORTD", {}},
+  {0x04, "DDRA", {}},   {0x05, "DDRB", {}},   {0x06, "DDRC", {}},   {0x07, "DDRD", {}},
+  {0x0A, "SCR",   REGB(0, "SPE", 0, "MSTR", 0, 0, 0, 0)},
+  {0x0B, "SSR",   REGB("SPIF", "DCOL", 0, 0, 0, 0, 0, 0)},
+  {0x0C, "SDR",   {}},
+  {0x12, "TCR",   REGB("ICIE", "OCIE", "TOIE", 0, 0, 0, "IEDG", "OLVL")},
+  {0x13, "TSR",   REGB("ICF", "OCF", "TOF", 0, 0, 0, 0, 0)},
+  {0x14, "ICRH", {}},   {0x15, "ICRL", {}},   {0x16, "OCRH", {}},   {0x17, "OCRL", {}},
+  {0x18, "TRH", {}},    {0x19, "TRL", {}},    {0x1A, "ATRH", {}},   {0x1B, "ATRL", {}},
+  {0x1C, "EPROG", {}},
+  {0x1D, "ADDR",  {}},
+  {0x1E, "ADSCR", REGB("CC", "ADRC", "ADON", 0, 0, "CH2", "CH1", "CH0")},
+  {0x1FF0, "COPR", REGB(0, 0, 0, 0, 0, 0, 0, "COPC")},
+  };
+
+//-----------------------------------------------------------------------------
+//
+//                          MakeRegTab
+//
+// Compile time generator of the perfect hash table of the registers
+// def[]: the first multiplier (from REGMUL on) that puts each register
+// into a slot of its own. mul = 0 if there is none.
+//
+template<size_t N>
+constexpr REGTAB MakeRegTab(const REGSLOT (&def)[N])
+  {
+  static_assert(2*N <= (1 << REGPARTBITS), "REGPARTBITS too small");
+  REGTAB t = {};
+  DWORD mul = 0, i = 0;
+  size_t k = 0;
+
+  for (mul=REGMUL; mul!=REGMUL + 2*REGTRIES; mul+=2)
+    {
+    for (i=0; i<(1 << REGPARTBITS); i++) t.slot[i].addr = REGNONE;
+    for (k=0; k<N; k++)
+      {
+      i = REGHASH(def[k].addr, mul, REGPARTBITS);
+      if (t.slot[i].addr != REGNONE) break;   // Collision: next multiplier
+      t.slot[i] = def[k];
+      }
+    if (k == N)
+      {
+      t.mul = mul;
+      return t;
+      }
+    }
+  t.mul = 0;
+  return t;
+  } // MakeRegTab
+
+constexpr int RegLen(const char* s)
+  {
+  int n = 0;
+  while (s[n]) n++;
+  return n;
+  } // RegLen
+
+// Every register of def[] is in its home slot of 't', the names fit
+template<size_t N>
+constexpr bool CheckRegTab(const REGTAB& t, const REGSLOT (&def)[N])
+  {
+  if (t.mul == 0) return false;
+  for (size_t k=0; k<N; k++)
+    {
+    if (t.slot[REGHASH(def[k].addr, t.mul, REGPARTBITS)].addr != def[k].addr) return false;
+    if (RegLen(def[k].name) > REGNAMELEN) return false;
+    for (int b=0; b<REGBITS; b++)
+      if (def[k].bit[b] && RegLen(def[k].bit[b]) > REGNAMELEN) return false;
+    }
+  return true;
+  } // CheckRegTab
+
+constexpr REGTAB reg705C8A = MakeRegTab(def705C8A);
+constexpr REGTAB reg705J1A = MakeRegTab(def705J1A);
+constexpr REGTAB reg705P9  = MakeRegTab(def705P9);
+
+static_assert(CheckRegTab(reg705C8A, def705C8A), "reg705C8A: no perfect hash");
+static_assert(CheckRegTab(reg705J1A, def705J1A), "reg705J1A: no perfect hash");
+static_assert(CheckRegTab(reg705P9, def705P9), "reg705P9: no perfect hash");
+
+#define REGCOUNT(def) (DWORD)(sizeof(def)/sizeof(def[0]))
+
+static const REGPART regPart[] = {
+  {"705C8A", &reg705C8A, REGCOUNT(def705C8A)},
+  {"705J1A", &reg705J1A, REGCOUNT(def705J1A)},
+  {"705P9",  &reg705P9,  REGCOUNT(def705P9)},
+  };
+
+static inline unsigned long long RegMix(unsigned long long h, const char* s)
+  {
+  if (s) while (*s) h = (h ^ (BYTE)*s++) * FNVPRIME;
+  return (h ^ 0xFF) * FNVPRIME;                 // (Ends the name)
+  } // RegMix
+
+// FNV-1a of the registers of 'm', part of the listing cache keys (-k)
+static unsigned long long RegKey(const REGMAP* m)
+  {
+  unsigned long long h = FNVBASIS;
+  const REGSLOT* r;
+  DWORD i;
+  int b;
+
+  for (i=0; i<(1u << m->bits); i++)
+    {
+    r = &m->slot[i];
+    if (r->addr == REGNONE) continue;
+    h = (h ^ (r->addr & 0xFF)) * FNVPRIME;
+    h = (h ^ (r->addr >> 8)) * FNVPRIME;
+    h = RegMix(h, r->name);
+    for (b=0; b<REGBITS; b++) h = RegMix(h, r->bit[b]);
+    }
+  return h;
+  } // RegKey
+
+// Append the name s[0..n-1] to the pool of a map file, return its offset
+static DWORD RegPool(char** pool, DWORD* len, DWORD* alloc, const char* s, int n)
+  {
+  DWORD off = *len;
+
+  if (*len + n + 1 > *alloc)
+    {
+    *alloc = 2 * (*alloc + n + 1);
+    OutOfMemory(*pool = (char*)realloc(*pool, *alloc));
+    }
+  memcpy(*pool + off, s, n);
+  (*pool)[off + n] = 0;
+  *len += n + 1;
+  return off;
+  } // RegPool
+
+// The next name of the line at p[]: its length, 0 = none, ERR = bad
+static int RegName(char** p)
+  {
+  char* s;
+
+  while (isspace((UCHAR)**p)) (*p)++;
+  s = *p;
+  if (*s == 0 || *s == ';') return 0;
+  while (**p && !isspace((UCHAR)**p)) (*p)++;
+  if (*p - s > REGNAMELEN || !(isalpha((UCHAR)s[0]) || s[0] == '_' || (s[0] == '-' && *p - s == 1)))
+    return ERR;
+  return (int)(*p - s);
+  } // RegName
+
+//-----------------------------------------------------------------------------
+//
+//                          RegLoad
+//
+// Load the register map file 'fname' into 'm' (see above).
+//
+// Returns the number of bad lines, ERR if the file can't be opened.
+//
+static int RegLoad(REGMAP* m, const char* fname)
+  {
+  char line[256], *p, *q, *name;
+  REGLINE* reg = NULL;
+  REGSLOT* r;
+  DWORD count = 0, alloc = 0, poolLen = 0, poolAlloc = 0, mask, i, k;
+  int nr = 0, errors = 0, n, b, probe;
+  FILE* fp;
+
+  if ((fp = fopen(fname, "r")) == NULL) return ERR;
+  RegPool(&m->pool, &poolLen, &poolAlloc, "", 0);  // Offset 0: no name
+
+  while (fgets(line, sizeof(line), fp))
+    {
+    nr++;
+    for (p=line; isspace((UCHAR)*p); p++);
+    if (*p == 0 || *p == ';') continue;         // Empty or comment line
+
+    if (count == alloc)
+      {
+      alloc = alloc ? 2*alloc : 64;
+      OutOfMemory(reg = (REGLINE*)realloc(reg, alloc * sizeof(REGLINE)));
+      }
+    memset(&reg[count], 0, sizeof(REGLINE));
+    reg[count].nr = nr;
+
+    name = p;
+    n = RegName(&p);
+    while (isspace((UCHAR)*p)) p++;
+    if (tolower(p[0]) == 'e' && tolower(p[1]) == 'q' && tolower(p[2]) == 'u' && isspace((UCHAR)p[3]))
+      for (p+=3; isspace((UCHAR)*p); p++);
+    if (*p == '$') p++;
+    else if (p[0] == '0' && tolower(p[1]) == 'x') p += 2;
+    reg[count].addr = strtoul(p, &q, 16);
+    if (n <= 0 || *name == '-' || q == p || reg[count].addr > 0xFFFF || (*q && !isspace((UCHAR)*q)))
+      {
+      fprintf(stderr, "%s(%d): bad register line\n", fname, nr);
+      errors++;
+      continue;
+      }
+    reg[count].name = RegPool(&m->pool, &poolLen, &poolAlloc, name, n);
+
+    for (b=REGBITS-1; b>=0; b--)                // Bit 7 first
+      {
+      if ((n = RegName(&q)) <= 0) break;
+      if (q[-n] != '-') reg[count].bit[b] = RegPool(&m->pool, &poolLen, &poolAlloc, q - n, n);
+      }
+    if (n == ERR || (b >= 0 && b < REGBITS-1) || (b < 0 && RegName(&q) != 0))
+      {                                         // Not none or all 8 of them
+      fprintf(stderr, "%s(%d): bad register line\n", fname, nr);
+      errors++;
+      continue;
+      }
+    count++;
+    }
+  fclose(fp);
+
+  for (m->bits=1; (1u << m->bits) < 2*count && m->bits < REGMAXBITS; m->bits++);
+  if (count == 0 || 2*count > (1u << m->bits))
+    {
+    fprintf(stderr, "%s: %s registers\n", fname, count ? "too many" : "no");
+    errors++;
+    }
+  if (errors)
+    {
+    free(reg);
+    free(m->pool);
+    m->pool = NULL;
+    return errors;
+    }
+
+  // Open addressing with linear probing, home slot REGHASH
+  mask = (1u << m->bits) - 1;
+  OutOfMemory(m->alloc = (REGSLOT*)calloc(mask + 1, sizeof(REGSLOT)));
+  for (i=0; i<=mask; i++) m->alloc[i].addr = REGNONE;
+  m->mul = REGMUL;
+  m->probe = 0;
+  for (k=0; k<count; k++)
+    {
+    i = REGHASH(reg[k].addr, m->mul, m->bits);
+    for (probe=0; m->alloc[i].addr != REGNONE && m->alloc[i].addr != reg[k].addr; probe++)
+      i = (i + 1) & mask;
+    r = &m->alloc[i];
+    if (r->addr == reg[k].addr)
+      {
+      fprintf(stderr, "%s(%d): register $%04X defined twice\n", fname, reg[k].nr, (unsigned)reg[k].addr);
+      errors++;
+      continue;
+      }
+    if (probe > m->probe) m->probe = probe;
+    r->addr = reg[k].addr;
+    r->name = m->pool + reg[k].name;
+    for (b=0; b<REGBITS; b++) r->bit[b] = reg[k].bit[b] ? m->pool + reg[k].bit[b] : NULL;
+    }
+  free(reg);
+
+  m->slot = m->alloc;
+  m->count = count;
+  m->part = fname;
+  if (errors) RegClose(m);
+  return errors;
+  } // RegLoad
+
+//-----------------------------------------------------------------------------
+//
+//                          RegOpen
+//
+// The register map of the derivative 'arg' (option -i), one of the
+// built-in ones (e.g. "705c8a" or "MC68HC705C8A") or a map file.
+//
+// Returns the number of bad lines of the file, ERR if it can't be
+// opened.
+//
+int RegOpen(REGMAP* m, const char* arg)
+  {
+  const char* p = arg;
+  int k, errors = 0;
+
+  memset(m, 0, sizeof(REGMAP));
+  if (_strnicmp(p, "MC", 2) == 0) p += 2;
+  if (_strnicmp(p, "68HC", 4) == 0) p += 4;
+  for (k=0; k<(int)(sizeof(regPart)/sizeof(regPart[0])); k++)
+    if (_stricmp(p, regPart[k].name) == 0) break;
+
+  if (k < (int)(sizeof(regPart)/sizeof(regPart[0])))
+    {
+    m->slot  = regPart[k].tab->slot;
+    m->mul   = regPart[k].tab->mul;
+    m->bits  = REGPARTBITS;
+    m->probe = 0;                               // Perfect hash
+    m->count = regPart[k].count;
+    m->part  = regPart[k].name;
+    }
+  else if ((errors = RegLoad(m, arg)) != 0) return errors;
+
+  m->key = RegKey(m);
+  return 0;
+  } // RegOpen
+
+//-----------------------------------------------------------------------------
+//
+//                          RegClose
+//
+// Free the register map 'm' (a map file).
+//
+void RegClose(REGMAP* m)
+  {
+  free(m->alloc);
+  free(m->pool);
+  memset(m, 0, sizeof(REGMAP));
+  } // RegClose
+
+//--------------------------end-of-c++-module-----------------------------------
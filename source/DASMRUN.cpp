@@ -0,0 +1,237 @@
+// haDASM - Disassembler for Microchip processors
+// dasmrun.cpp - C++ Developer source file.
+// (c)1990-2023 by helmut altmann
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; see the file COPYING.  If not, write to
+// the Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+// Boston, MA 02111-1307, USA.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <windows.h>
+#include <intrin.h>    // _BitScanForward
+
+#if defined(__AVX2__)                           // CL /arch:AVX2
+#include <immintrin.h>
+#define RUNVEC  32
+#elif defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>                          // SSE2 (CL default)
+#define RUNVEC  16
+#endif
+
+#include "equate.h"
+#include "extern.h"
+
+// --------------------------------------------
+// Fill runs and ASCII strings (-f)
+// --------------------------------------------
+// Erased EPROM ($FF) and zero padding would be listed as thousands of
+// "stx ,x" or "brset 0,.." lines. A pre-pass finds the runs of one
+// byte value (at least RUNMIN) and the printable ASCII strings (at
+// least TEXTMIN) of the image and keeps them in one ascending table.
+// The listing shows a run as one "fcb n dup $xx" line and a string as
+// "fcc" lines; instructions never overlap a region. The byte compares
+// are done RUNVEC bytes at a time with SSE2 (AVX2 if compiled with
+// /arch:AVX2), the tail and other compilers fall back to plain C.
+//
+#define RUNTEXT(c)  ((c) >= SPACE && (c) < 0x7F && (c) != '"')
+
+//-----------------------------------------------------------------------------
+//
+//                          RunFill
+//
+// Returns the length of the run of p[0] in p[0..n-1] (n > 0).
+//
+DWORD RunFill(const BYTE* p, DWORD n)
+  {
+  DWORD i = 1;
+
+  if (n < 2 || p[1] != p[0]) return 1;          // The common case in code
+#ifdef RUNVEC
+  unsigned long bit;
+  unsigned m;
+#if RUNVEC == 32
+  const __m256i v = _mm256_set1_epi8((char)p[0]);
+  for (; i+32 <= n; i+=32)
+    {
+    m = ~(unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i*)&p[i]), v));
+    if (m) { _BitScanForward(&bit, m); return i + bit; }
+    }
+#else
+  const __m128i v = _mm_set1_epi8((char)p[0]);
+  for (; i+16 <= n; i+=16)
+    {
+    m = ~(unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_loadu_si128((const __m128i*)&p[i]), v)) & 0xFFFF;
+    if (m) { _BitScanForward(&bit, m); return i + bit; }
+    }
+#endif
+#endif
+  while (i < n && p[i] == p[0]) i++;
+  return i;
+  } // RunFill
+
+//-----------------------------------------------------------------------------
+//
+//                          RunText
+//
+// Returns the number of printable ASCII chars (without '"', the FCC
+// delimiter) at the start of p[0..n-1].
+//
+DWORD RunText(const BYTE* p, DWORD n)
+  {
+  DWORD i = 0;
+
+  if (n < TEXTMIN || !RUNTEXT(p[0])) return 0;
+#ifdef RUNVEC
+  unsigned long bit;
+  unsigned m;
+#if RUNVEC == 32
+  const __m256i lo = _mm256_set1_epi8(SPACE-1), hi = _mm256_set1_epi8(0x7F), dq = _mm256_set1_epi8('"');
+  __m256i x;
+  for (; i+32 <= n; i+=32)
+    {
+    x = _mm256_loadu_si256((const __m256i*)&p[i]);  // Signed: $80..$FF are < SPACE
+    x = _mm256_andnot_si256(_mm256_cmpeq_epi8(x, dq),
+                            _mm256_and_si256(_mm256_cmpgt_epi8(x, lo), _mm256_cmpgt_epi8(hi, x)));
+    m = ~(unsigned)_mm256_movemask_epi8(x);
+    if (m) { _BitScanForward(&bit, m); return i + bit; }
+    }
+#else
+  const __m128i lo = _mm_set1_epi8(SPACE-1), hi = _mm_set1_epi8(0x7F), dq = _mm_set1_epi8('"');
+  __m128i x;
+  for (; i+16 <= n; i+=16)
+    {
+    x = _mm_loadu_si128((const __m128i*)&p[i]);     // Signed: $80..$FF are < SPACE
+    x = _mm_andnot_si128(_mm_cmpeq_epi8(x, dq),
+                         _mm_and_si128(_mm_cmpgt_epi8(x, lo), _mm_cmplt_epi8(x, hi)));
+    m = ~(unsigned)_mm_movemask_epi8(x) & 0xFFFF;
+    if (m) { _BitScanForward(&bit, m); return i + bit; }
+    }
+#endif
+#endif
+  while (i < n && RUNTEXT(p[i])) i++;
+  return i;
+  } // RunText
+
+// A string, not code that happens to be printable: 3/4 letters, digits or blanks
+static BOOL RunIsText(const BYTE* p, DWORD n)
+  {
+  DWORD i, k = 0;
+
+  for (i=0; i<n; i++) if (isalnum(p[i]) || p[i] == SPACE) k++;
+  return 4*k >= 3*n;
+  } // RunIsText
+
+static void RunAdd(RUNTAB* rt, DWORD addr, DWORD len, int kind, BYTE fill)
+  {
+  RUNENT* e = rt->count ? &rt->run[rt->count-1] : NULL;
+
+  // A fill run going on in the next window
+  if (e && kind == RUN_FILL && e->kind == RUN_FILL && e->fill == fill && e->addr + e->len == addr)
+    {
+    e->len += len;
+    return;
+    }
+  if (rt->count == rt->alloc)
+    {
+    rt->alloc = rt->alloc ? 2*rt->alloc : 256;
+    OutOfMemory(rt->run = (RUNENT*)realloc(rt->run, rt->alloc * sizeof(RUNENT)));
+    }
+  e = &rt->run[rt->count++];
+  e->addr = addr;
+  e->len  = len;
+  e->kind = (BYTE)kind;
+  e->fill = fill;
+  } // RunAdd
+
+//-----------------------------------------------------------------------------
+//
+//                          RunScan
+//
+// Pre-pass over the image 'im': collect its fill runs and strings in
+// 'rt' (free it with RunFree). A run or string cut off by the end of
+// a window is scanned again from its start in the next window, so
+// the table does not depend on the window size.
+//
+void RunScan(IMAGE* im, RUNTAB* rt)
+  {
+  const BYTE* p;
+  DWORD pc, i, n, r, t;
+  BOOL more;
+
+  memset(rt, 0, sizeof(RUNTAB));
+  for (pc=0; pc<im->size; )
+    {
+    if (!ImageWindow(im, pc)) break;
+    if (pc < im->base) pc = im->base;           // A gap of a hex file
+    p = im->data;
+    n = im->len;
+    more = im->base + n < im->lim;              // The range goes on
+    for (i=pc - im->base; i<n; )
+      {
+      r = RunFill(&p[i], n - i);
+      t = RunText(&p[i], n - i);
+      if (t > TEXTMAX) t = TEXTMAX;
+      if (more && i + (r > t ? r : t) == n && r < RUNMIN && t < TEXTMAX) break;
+
+      if (r >= RUNMIN || (rt->count && rt->run[rt->count-1].addr + rt->run[rt->count-1].len == im->base + i &&
+                          rt->run[rt->count-1].kind == RUN_FILL && rt->run[rt->count-1].fill == p[i]))
+        {
+        RunAdd(rt, im->base + i, r, RUN_FILL, p[i]);
+        i += r;
+        }
+      else
+        {
+        // No run or string starts inside a shorter one (but a run may start in a string)
+        if (t >= TEXTMIN && RunIsText(&p[i], t)) RunAdd(rt, im->base + i, t, RUN_TEXT, 0);
+        i += r > t ? r : t;
+        }
+      } // end for i
+    pc = im->base + i;
+    } // end for pc
+  } // RunScan
+
+//-----------------------------------------------------------------------------
+//
+//                          RunFree
+//
+void RunFree(RUNTAB* rt)
+  {
+  free(rt->run);
+  memset(rt, 0, sizeof(RUNTAB));
+  } // RunFree
+
+//-----------------------------------------------------------------------------
+//
+//                          RunSeek
+//
+// Returns the index of the first region that ends above address 'addr'
+// (count if there is none).
+//
+DWORD RunSeek(const RUNTAB* rt, DWORD addr)
+  {
+  DWORD lo = 0, hi = rt->count, m;
+
+  while (lo < hi)
+    {
+    m = (lo + hi) / 2;
+    if (rt->run[m].addr + rt->run[m].len <= addr) lo = m + 1;
+    else hi = m;
+    }
+  return lo;
+  } // RunSeek
+
+//--------------------------end-of-c++-module-----------------------------------
@@ -0,0 +1,506 @@
+// haDASM - Disassembler for Microchip processors
+// dasmsig.cpp - C++ Developer source file.
+// (c)1990-2023 by helmut altmann
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; see the file COPYING.  If not, write to
+// the Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+// Boston, MA 02111-1307, USA.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <io.h>
+#include <fcntl.h>
+#include <windows.h>
+
+#include "equate.h"
+#include "extern.h"
+#include "dasmisa.h"
+
+// --------------------------------------------
+// Function fingerprints (-n, -w)
+// --------------------------------------------
+// A function starts at the target of a jsr or bsr and ends with the
+// first rts or rti after it (in address order, at most SIGMAXLEN
+// bytes). Its fingerprint is the FNV-1a hash of the opcodes and
+// addressing modes, with the operands that hold an address masked:
+// immediate values, index offsets and branch displacements are kept,
+// direct, extended and 16 bit immediate operands are not. The same
+// library routine linked to another address of another image has the
+// same fingerprint.
+//
+// Option -w writes the fingerprints of the functions that start at a
+// user symbol (-s) of the images to a signature file, option -n labels
+// the functions of the listing whose fingerprint is in the file with
+// the name of the signature (the second match of a name gets "_2"...).
+//
+// Signature file: SIGHDR, the SIGENTs sorted by hash, the bucket
+// index (like the one of the symbol table), then the names. It is
+// mapped as it is and shared by all the jobs of a batch; a lookup is
+// one bucket of about one entry.
+//
+// Operand bytes that are kept in the hash, bit 0 = the last byte
+static const BYTE sigKeep[AM_COUNT] = {
+  0, 0, 1, 0, 0, 1, 0, 1, 0, 0, 1,              // ILL INH IMM DIR EXT REL IX IX1 IX2 BSC BTB
+  0, 1, 3, 0, 2, 0, 0,                          // IMM16 SP1 SP2 DD IMD DIXP IXPD
+  1, 3, 1, 1, 3, 3, 3,                          // DREL IREL IXREL IXPREL IX1REL IX1PREL SP1REL
+  1, 1, 3, 3, 3, 7, 7                           // IY1 BSCM BSCX BSCY BTBM BTBX BTBY
+  };
+
+typedef struct tag_SIGMATCH {
+  DWORD  addr;      // Function
+  DWORD  ent;       // Its signature, index into SIGINDEX.ent[]
+} SIGMATCH;
+
+typedef struct tag_SIGSRC {
+  IMAGE* im;        // Linear sweep: the image windows
+  const BYTE* data; // -r: the whole image data[0..size-1]
+  DWORD  size;
+} SIGSRC;
+
+static inline unsigned long long SigMix(unsigned long long h, BYTE b)
+  {
+  return (h ^ b) * FNVPRIME;
+  } // SigMix
+
+//-----------------------------------------------------------------------------
+//
+//                          SigHash
+//
+// Fingerprint the function at p[0], 'avail' bytes left: its hash to
+// *h, its length to *len. Returns FALSE if it is no function (an
+// illegal opcode, no rts or rti, fewer than SIGMININSN instructions).
+//
+template<class ISA>
+static BOOL SigHash(const BYTE* p, DWORD avail, unsigned long long* h, DWORD* len)
+  {
+  const OPDESC* d;
+  DWORD off = 0;
+  int op, nop, i, n = 0;
+
+  *h = FNVBASIS;
+  while (off < avail && off < SIGMAXLEN)
+    {
+    d = ISA::Desc(&p[off], avail - off);
+    if (d->mode == AM_ILL || d->len > avail - off) return FALSE;
+    op = ISA::Index(d);
+    nop = d->len - ((op >> 8) ? 2 : 1);         // Operand bytes after the prefix and opcode
+    *h = SigMix(SigMix(SigMix(*h, (BYTE)op), (BYTE)(op >> 8)), d->mode);
+    for (i=0; i<nop; i++)
+      if (sigKeep[d->mode] & (1 << i)) *h = SigMix(*h, p[off + d->len-1 - i]);
+    off += d->len;
+    n++;
+    if (d->flow == FC_RET)
+      {
+      *len = off;
+      return n >= SIGMININSN;
+      }
+    }
+  return FALSE;
+  } // SigHash
+
+// The image bytes at 'pc' and their number to *avail, NULL if there are none
+static const BYTE* SigAt(SIGSRC* src, DWORD pc, DWORD* avail)
+  {
+  IMAGE* im = src->im;
+
+  if (im == NULL)
+    {
+    *avail = src->size - pc;
+    return pc < src->size ? &src->data[pc] : NULL;
+    }
+  if (pc < im->base || pc >= im->base + im->len ||
+      (im->base + im->len < im->lim && im->base + im->len - pc < SIGMAXLEN))
+    if (!ImageWindow(im, pc) || pc < im->base || pc >= im->base + im->len) return NULL;
+  *avail = im->base + im->len - pc;
+  return &im->data[pc - im->base];
+  } // SigAt
+
+// Ascending signature, then ascending address
+static int SigCompare(const void* a, const void* b)
+  {
+  const SIGMATCH* x = (const SIGMATCH*)a;
+  const SIGMATCH* y = (const SIGMATCH*)b;
+
+  if (x->ent != y->ent) return x->ent < y->ent ? -1 : 1;
+  return x->addr < y->addr ? -1 : x->addr > y->addr;
+  } // SigCompare
+
+//-----------------------------------------------------------------------------
+//
+//                          SigLabel
+//
+// Fingerprint the functions at the call targets 'calls' (sorted) and
+// give the labels of 'st' that match the index 'x' their names. The
+// labels that are no instruction start or have a user name are left.
+//
+template<class ISA>
+static void SigLabel(SIGSRC* src, SYMTAB* st, const SYMTAB* calls, const SIGINDEX* x)
+  {
+  char name[SYMLEN+16];
+  const SIGENT* f;
+  const BYTE* p;
+  SIGMATCH* m;
+  SYMENT* e;
+  unsigned long long h;
+  DWORD i, n = 0, len, avail, k = 0;
+
+  if (calls->count == 0) return;
+  OutOfMemory(m = (SIGMATCH*)malloc(calls->count * sizeof(SIGMATCH)));
+  for (i=0; i<calls->count; i++)
+    {
+    e = SymFind(st, calls->sym[i].addr);
+    if (e == NULL || !(e->name & SYMDEF) || (e->name & ~SYMDEF)) continue;
+    if ((p = SigAt(src, e->addr, &avail)) == NULL) continue;
+    if (SigHash<ISA>(p, avail, &h, &len) && (f = SigFind(x, h, len)) != NULL && f->name < x->poolLen)
+      {
+      m[n].addr = e->addr;
+      m[n++].ent = (DWORD)(f - x->ent);
+      }
+    }
+
+  qsort(m, n, sizeof(SIGMATCH), SigCompare);    // The same function twice: name_2
+  for (i=0; i<n; i++)
+    {
+    k = (i && m[i].ent == m[i-1].ent) ? k+1 : 1;
+    strncpy(name, &x->pool[x->ent[m[i].ent].name], SYMLEN);
+    name[SYMLEN] = 0;
+    if (k > 1) sprintf(name + strlen(name), "_%u", (unsigned)k);
+    SymFind(st, m[i].addr)->name |= SymPool(st, name, (int)strlen(name));
+    }
+  free(m);
+  } // SigLabel
+
+//-----------------------------------------------------------------------------
+//
+//                          SigScan
+//
+// Label the known functions of the linear sweep listing of the image
+// 'im' in 'st' (after SymScan), with the signatures 'x'. The fill runs
+// and strings 'rt' (NULL = none) are skipped like in the listing.
+//
+template<class ISA>
+static void SigSweep(IMAGE* im, SYMTAB* st, const RUNTAB* rt, const SIGINDEX* x)
+  {
+  const OPDESC* d;
+  const BYTE* p;
+  SYMTAB calls;
+  SIGSRC src;
+  DWORD pc, end, lim, target, k = 0;
+
+  SymInit(&calls);
+  for (pc=0; pc<im->size; )
+    {
+    end = im->base + im->len;
+    if (end < im->lim)                          // Keep a whole instruction in the window
+      end = (end > ISA::maxlen-1) ? end - (ISA::maxlen-1) : 0;
+
+    if (pc < im->base || pc >= end)
+      {
+      if (!ImageWindow(im, pc)) break;
+      if (pc < im->base) pc = im->base;         // A gap of a hex file
+      continue;
+      }
+
+    while (pc < end)
+      {
+      p = &im->data[pc - im->base];
+      lim = im->lim;
+      if (rt)
+        {
+        while (k < rt->count && rt->run[k].addr + rt->run[k].len <= pc) k++;
+        if (k < rt->count && rt->run[k].addr <= pc)
+          {
+          pc = rt->run[k].addr + rt->run[k].len;  // Fill run or string
+          continue;
+          }
+        if (k < rt->count) lim = rt->run[k].addr;
+        }
+
+      d = ISA::Desc(p, lim - pc);
+      if (d->flow == FC_CALL && pc + d->len <= lim && (target = FlowTarget(d, p, pc)) < im->size)
+        SymAdd(&calls, target);
+      pc += d->len;
+      if (pc > lim) pc = lim;
+      }
+    } // end for pc
+  SymSort(&calls);
+
+  src.im = im;
+  src.data = NULL;
+  src.size = im->size;
+  SigLabel<ISA>(&src, st, &calls, x);
+  SymFree(&calls);
+  } // SigSweep
+
+void SigScan(IMAGE* im, SYMTAB* st, const RUNTAB* rt, const SIGINDEX* x)
+  {
+  ISACALL(im->cpu, SigSweep, (im, st, rt, x));
+  } // SigScan
+
+//-----------------------------------------------------------------------------
+//
+//                          SigFlow
+//
+// Label the known functions reached by the flow trace (-r) in 'st':
+// the call targets of the instructions of the bitmap 'start' of the
+// image data[0..size-1].
+//
+template<class ISA>
+static void SigCode(SYMTAB* st, const BYTE* data, DWORD size, const BYTE* start, const SIGINDEX* x)
+  {
+  const OPDESC* d;
+  SYMTAB calls;
+  SIGSRC src;
+  DWORD pc, target;
+
+  SymInit(&calls);
+  for (pc=0; pc<size; pc++)
+    if (BITTST(start, pc))
+      {
+      d = ISA::Desc(&data[pc], size - pc);
+      if (d->flow == FC_CALL && (target = FlowTarget(d, &data[pc], pc)) < size) SymAdd(&calls, target);
+      }
+  SymSort(&calls);
+
+  src.im = NULL;
+  src.data = data;
+  src.size = size;
+  SigLabel<ISA>(&src, st, &calls, x);
+  SymFree(&calls);
+  } // SigCode
+
+void SigFlow(SYMTAB* st, const BYTE* data, DWORD size, const BYTE* start, int cpu, const SIGINDEX* x)
+  {
+  ISACALL(cpu, SigCode, (st, data, size, start, x));
+  } // SigFlow
+
+//-----------------------------------------------------------------------------
+//
+//                          SigFind
+//
+// The signature of the function with the hash 'h' and 'len' bytes in
+// the index 'x', NULL if it is unknown.
+//
+const SIGENT* SigFind(const SIGINDEX* x, unsigned long long h, DWORD len)
+  {
+  DWORD b = x->bits ? (DWORD)(h >> (64 - x->bits)) : 0, i;
+
+  for (i=x->bucket[b]; i<x->bucket[b+1]; i++)
+    if (x->ent[i].hash == h && x->ent[i].len == len) return &x->ent[i];
+  return NULL;
+  } // SigFind
+
+//-----------------------------------------------------------------------------
+//
+//                          SigOpen
+//
+// Map the signature file 'name' into 'x'.
+// Returns ERR if it can't be opened, 1 if it is no signature file.
+//
+int SigOpen(SIGINDEX* x, const char* name)
+  {
+  LARGE_INTEGER li;
+  const SIGHDR* hdr;
+  unsigned long long need;
+
+  memset(x, 0, sizeof(SIGINDEX));
+  if ((x->fh=open(name, O_RDONLY|O_BINARY)) == ERR) return ERR;
+  if (!GetFileSizeEx((HANDLE)_get_osfhandle(x->fh), &li) || li.QuadPart < (LONGLONG)sizeof(SIGHDR) ||
+      (x->hMap = CreateFileMapping((HANDLE)_get_osfhandle(x->fh), NULL, PAGE_READONLY, 0, 0, NULL)) == NULL ||
+      (x->view = (BYTE*)MapViewOfFile(x->hMap, FILE_MAP_READ, 0, 0, 0)) == NULL)
+    {
+    SigClose(x);
+    return 1;
+    }
+
+  hdr = (const SIGHDR*)x->view;
+  need = sizeof(SIGHDR) + (unsigned long long)hdr->count * sizeof(SIGENT) +
+         (hdr->bits <= SIGMAXBITS ? ((1ULL << hdr->bits) + 1) * sizeof(DWORD) : 0) + hdr->poolLen;
+  if (hdr->magic != SIGMAGIC || hdr->version != SIGVERSION || hdr->bits > SIGMAXBITS ||
+      need != (unsigned long long)li.QuadPart)
+    {
+    SigClose(x);
+    return 1;
+    }
+  x->count   = hdr->count;
+  x->bits    = hdr->bits;
+  x->poolLen = hdr->poolLen;
+  x->ent     = (const SIGENT*)(x->view + sizeof(SIGHDR));
+  x->bucket  = (const DWORD*)(x->ent + x->count);
+  x->pool    = (const char*)(x->bucket + (1 << x->bits) + 1);
+  if (x->bucket[1 << x->bits] != x->count)
+    {
+    SigClose(x);
+    return 1;
+    }
+  return 0;
+  } // SigOpen
+
+//-----------------------------------------------------------------------------
+//
+//                          SigClose
+//
+void SigClose(SIGINDEX* x)
+  {
+  if (x->view) UnmapViewOfFile(x->view);
+  if (x->hMap) CloseHandle(x->hMap);
+  if (x->fh > 0) close(x->fh);
+  memset(x, 0, sizeof(SIGINDEX));
+  } // SigClose
+
+// ---------------------------------------------------
+// Writing a signature file (-w)
+// ---------------------------------------------------
+typedef struct tag_SIGBUILD {
+  SIGENT* ent;      // Signatures, unsorted
+  DWORD  count;
+  DWORD  alloc;
+  DWORD  order;     // Running number, the first of equal signatures wins
+  DWORD* seq;       // seq[i] = order of ent[i]
+  SYMTAB names;     // Their names (the string pool only)
+} SIGBUILD;
+
+static SIGBUILD* sigSort;                       // qsort context
+
+static void SigAdd(SIGBUILD* b, unsigned long long h, DWORD len, const char* name)
+  {
+  if (b->count == b->alloc)
+    {
+    b->alloc = b->alloc ? 2*b->alloc : 1024;
+    OutOfMemory(b->ent = (SIGENT*)realloc(b->ent, b->alloc * sizeof(SIGENT)));
+    OutOfMemory(b->seq = (DWORD*)realloc(b->seq, b->alloc * sizeof(DWORD)));
+    }
+  b->ent[b->count].hash = h;
+  b->ent[b->count].len  = len;
+  b->ent[b->count].name = SymPool(&b->names, name, (int)strlen(name));
+  b->seq[b->count++] = b->order++;
+  } // SigAdd
+
+// Ascending hash and length, then the order of SigAdd (index array)
+static int SigOrder(const void* a, const void* c)
+  {
+  const SIGENT* x = &sigSort->ent[*(const DWORD*)a];
+  const SIGENT* y = &sigSort->ent[*(const DWORD*)c];
+
+  if (x->hash != y->hash) return x->hash < y->hash ? -1 : 1;
+  if (x->len != y->len) return x->len < y->len ? -1 : 1;
+  return sigSort->seq[*(const DWORD*)a] < sigSort->seq[*(const DWORD*)c] ? -1 : 1;
+  } // SigOrder
+
+// The functions at the user symbols of the image 'im'
+template<class ISA>
+static void SigImage(IMAGE* im, SIGBUILD* b, const SYMTAB* user)
+  {
+  unsigned long long h;
+  const BYTE* p;
+  SIGSRC src;
+  DWORD i, len, avail;
+
+  src.im = im;
+  src.data = NULL;
+  src.size = im->size;
+  for (i=0; i<user->count; i++)
+    if ((user->sym[i].name & ~SYMDEF) && user->sym[i].addr < im->size &&
+        (p = SigAt(&src, user->sym[i].addr, &avail)) != NULL && SigHash<ISA>(p, avail, &h, &len))
+      SigAdd(b, h, len, &user->pool[user->sym[i].name & ~SYMDEF]);
+  } // SigImage
+
+//-----------------------------------------------------------------------------
+//
+//                          SigBuild
+//
+// Write the signature file 'name' of the images of the batch 'bat':
+// the fingerprints of the functions at the user symbols (-s), plus the
+// signatures 'x' of -n (NULL = none, closed here: the file may be the
+// same). Of equal fingerprints the first one is kept.
+//
+// Returns the number of signatures written, ERR on error.
+//
+int SigBuild(const char* name, const BATCH* bat, SIGINDEX* x)
+  {
+  const DASMOPT* opt = bat->opt;
+  SIGBUILD b;
+  SIGHDR hdr;
+  IMAGE im;
+  SIGENT* out;
+  DWORD* idx;
+  DWORD* bucket;
+  DWORD i, n, k;
+  FILE* fp;
+  int f, bits, ok;
+
+  memset(&b, 0, sizeof(SIGBUILD));
+  SymInit(&b.names);
+  if (x)                                        // The signatures of -n first
+    for (i=0; i<x->count; i++)
+      if (x->ent[i].name < x->poolLen) SigAdd(&b, x->ent[i].hash, x->ent[i].len, &x->pool[x->ent[i].name]);
+
+  for (f=0; f<bat->count; f++)
+    {
+    if (ImageOpen(&im, bat->name[f]) == ERR)
+      {
+      fprintf(stderr, "Open failed on %s\n", bat->name[f]);
+      continue;
+      }
+    im.cpu = opt->cpu;
+    if (opt->user) ISACALL(im.cpu, SigImage, (&im, &b, opt->user));
+    ImageClose(&im);
+    }
+
+  // Sort, drop the duplicates, bucket index: about one entry per bucket
+  OutOfMemory(idx = (DWORD*)malloc((b.count ? b.count : 1) * sizeof(DWORD)));
+  OutOfMemory(out = (SIGENT*)malloc((b.count ? b.count : 1) * sizeof(SIGENT)));
+  for (i=0; i<b.count; i++) idx[i] = i;
+  sigSort = &b;
+  qsort(idx, b.count, sizeof(DWORD), SigOrder);
+  for (i=0, n=0; i<b.count; i++)
+    if (n == 0 || b.ent[idx[i]].hash != out[n-1].hash || b.ent[idx[i]].len != out[n-1].len)
+      out[n++] = b.ent[idx[i]];
+  for (bits=0; bits<SIGMAXBITS && (1UL << bits) < n; bits++);
+  OutOfMemory(bucket = (DWORD*)malloc(((1 << bits) + 1) * sizeof(DWORD)));
+  for (i=0, k=0; i<=(1UL << bits); i++)
+    {
+    while (k < n && (bits ? (DWORD)(out[k].hash >> (64 - bits)) : 0) < i) k++;
+    bucket[i] = k;
+    }
+
+  memset(&hdr, 0, sizeof(SIGHDR));
+  hdr.magic   = SIGMAGIC;
+  hdr.version = SIGVERSION;
+  hdr.count   = n;
+  hdr.bits    = bits;
+  hdr.poolLen = b.names.poolLen;
+  if (x) SigClose(x);
+  ok = (fp = fopen(name, "wb")) != NULL;
+  if (ok)
+    {
+    ok = fwrite(&hdr, sizeof(SIGHDR), 1, fp) == 1 &&
+         fwrite(out, sizeof(SIGENT), n, fp) == n &&
+         fwrite(bucket, sizeof(DWORD), (1 << bits) + 1, fp) == (size_t)(1 << bits) + 1 &&
+         fwrite(b.names.pool, 1, b.names.poolLen, fp) == b.names.poolLen;
+    if (fclose(fp)) ok = FALSE;
+    }
+  if (!ok) printf("Write failed on %s\n", name);
+
+  free(bucket);
+  free(out);
+  free(idx);
+  free(b.ent);
+  free(b.seq);
+  SymFree(&b.names);
+  return ok ? (int)n : ERR;
+  } // SigBuild
+
+//--------------------------end-of-c++-module-----------------------------------
@@ -0,0 +1,283 @@
+// haDASM - Disassembler for Microchip processors
+// dasmsim.cpp - C++ Developer source file.
+// (c)1990-2023 by helmut altmann
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; see the file COPYING.  If not, write to
+// the Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+// Boston, MA 02111-1307, USA.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <windows.h>
+
+#include "equate.h"
+#include "extern.h"
+
+// --------------------------------------------
+// M68HC05 instruction set simulator (-x)
+// --------------------------------------------
+// The recursive descent of -r can't follow the indexed jumps and calls
+// (jmp ,x  jsr $ee,x), the jump tables behind them are listed as data.
+// The simulator runs the image from the reset vector for a number of
+// cycles and marks the address of every opcode it executes; -r takes
+// them as more entry points.
+//
+// The CPU is decoded with the opcode table of the disassembler
+// (opDesc6805[]): the addressing mode gives the effective address, the
+// mnemonic the operation, the table the cycles. The registers are
+// locals of SimRun, the dispatch is a switch the compiler turns into
+// a jump table (CL has no computed goto).
+//
+// The 64K address space is a memory map of RAM, I/O and ROM (-y).
+// ROM is the image and ignores writes, I/O reads give pseudo-random
+// values (so that polling loops take both ways), writes are ignored.
+// Images larger than 64K are run in the bank of the reset vector.
+// The run ends after the cycles, on an illegal opcode, STOP or WAIT.
+//
+#define SIMVEC(n)   (size >= 2*(n) ? (data[size-2*(n)] << 8) | data[size-2*(n)+1] : 0) // Vector n (1 = reset)
+
+// Memory access by the map
+#define RD(p)       (kind[p] == SIM_IO ? (BYTE)SimRand(&rnd) : mem[p])
+#define WR(p,v)     { if (kind[p] == SIM_RAM) mem[p] = (BYTE)(v); }
+#define PUSH(v)     { WR(sp, v); sp = 0xC0 | ((sp - 1) & 0x3F); }
+#define PULL()      (sp = 0xC0 | ((sp + 1) & 0x3F), mem[sp])
+#define NZ(r)       { n = (r) & 0x80; z = ((r) & 0xFF) == 0; }
+
+static inline DWORD SimRand(DWORD* s)  // xorshift32
+  {
+  *s ^= *s << 13;
+  *s ^= *s >> 17;
+  *s ^= *s << 5;
+  return *s;
+  } // SimRand
+
+//-----------------------------------------------------------------------------
+//
+//                          SimMap
+//
+// Add the areas of the memory map 'spec' to 'map':
+//   io:0000-001F,ram:0050-00FF,rom:0100-1FFF
+// A later area overrides an earlier one, addresses outside all of
+// them are ROM.
+//
+// Returns FALSE if the spec is bad.
+//
+BOOL SimMap(SIMMAP* map, const char* spec)
+  {
+  const char* s = spec;
+  SIMAREA* a;
+  char* e;
+
+  while (*s)
+    {
+    if (map->count >= SIMAREAS) return FALSE;
+    a = &map->area[map->count];
+    if (_strnicmp(s, "io:", 3) == 0) { a->kind = SIM_IO; s += 3; }
+    else if (_strnicmp(s, "ram:", 4) == 0) { a->kind = SIM_RAM; s += 4; }
+    else if (_strnicmp(s, "rom:", 4) == 0) { a->kind = SIM_ROM; s += 4; }
+    else return FALSE;
+    a->lo = strtoul(s, &e, 16);
+    if (e == s || *e != '-') return FALSE;
+    s = e + 1;
+    a->hi = strtoul(s, &e, 16);
+    if (e == s || a->hi < a->lo || a->hi > 0xFFFF || (*e && *e != ',')) return FALSE;
+    map->count++;
+    s = *e ? e+1 : e;
+    }
+  return TRUE;
+  } // SimMap
+
+//-----------------------------------------------------------------------------
+//
+//                          SimRun
+//
+// Run the M68HC05 image data[0..size-1] from its reset vector for
+// opt->sim cycles. The address of every executed opcode is set in the
+// bitmap 'exec' (one bit per image byte). The counts go to *st.
+//
+// Returns FALSE if out of memory.
+//
+BOOL SimRun(const BYTE* data, DWORD size, const DASMOPT* opt, BYTE* exec, SIMSTATS* st)
+  {
+  static const SIMMAP defmap = {{{0x0000, 0x001F, SIM_IO}, {0x0050, 0x00FF, SIM_RAM}}, 2};
+  const SIMMAP* map = opt->map ? opt->map : &defmap;
+  const OPDESC* d;
+  BYTE *mem, *kind;
+  DWORD bank, len, cycles = 0, insns = 0, rnd = 0x6805, ea = 0;
+  unsigned pc, a = 0, x = 0, sp = 0xFF, m, r, op;
+  int c = 0, z = 0, n = 0, h = 0, i = 1, k;
+
+  memset(st, 0, sizeof(SIMSTATS));
+  if (size < 2) return TRUE;
+  if ((mem = (BYTE*)calloc(2, 0x10000)) == NULL) return FALSE;
+  kind = mem + 0x10000;
+
+  bank = (size - 2) & 0xFFFF0000;               // The bank of the reset vector
+  len = size - bank < 0x10000 ? size - bank : 0x10000;
+  memcpy(mem, &data[bank], len);
+  for (k=0; k<map->count; k++)
+    memset(&kind[map->area[k].lo], map->area[k].kind, map->area[k].hi - map->area[k].lo + 1);
+
+  pc = SIMVEC(1);
+  st->stop = "cycles";
+  while (cycles < opt->sim)
+    {
+    if (bank + pc < size) BITSET(exec, bank + pc);
+    op = mem[pc];
+    d = &opDesc6805[op];
+    cycles += d->cycles;
+    insns++;
+
+    switch (d->mode)                            // The effective address
+      {
+      case AM_IMM: ea = (pc + 1) & 0xFFFF; break;
+      case AM_DIR:
+      case AM_BSC:
+      case AM_BTB: ea = mem[(pc + 1) & 0xFFFF]; break;
+      case AM_EXT: ea = (mem[(pc + 1) & 0xFFFF] << 8) | mem[(pc + 2) & 0xFFFF]; break;
+      case AM_IX:  ea = x; break;
+      case AM_IX1: ea = x + mem[(pc + 1) & 0xFFFF]; break;
+      case AM_IX2: ea = (x + ((mem[(pc + 1) & 0xFFFF] << 8) | mem[(pc + 2) & 0xFFFF])) & 0xFFFF; break;
+      case AM_ILL: st->stop = "illegal opcode";
+                   goto done;
+      }
+    pc = (pc + d->len) & 0xFFFF;                // The next instruction
+
+    switch (d->mne)
+      {
+      // Bit manipulation
+      case MNE_BRSET:
+      case MNE_BRCLR:
+        c = (RD(ea) >> ((op >> 1) & 7)) & 1;
+        if (c == (d->mne == MNE_BRSET)) pc = (pc + (signed char)mem[(pc - 1) & 0xFFFF]) & 0xFFFF;
+        break;
+      case MNE_BSET: m = RD(ea); WR(ea, m | (1 << ((op >> 1) & 7))); break;
+      case MNE_BCLR: m = RD(ea); WR(ea, m & ~(1 << ((op >> 1) & 7))); break;
+
+      // Branches
+      case MNE_BRA:  r = 1;          goto branch;
+      case MNE_BRN:  r = 0;          goto branch;
+      case MNE_BHI:  r = !(c | z);   goto branch;
+      case MNE_BLS:  r = c | z;      goto branch;
+      case MNE_BCC:  r = !c;         goto branch;
+      case MNE_BCS:  r = c;          goto branch;
+      case MNE_BNE:  r = !z;         goto branch;
+      case MNE_BEQ:  r = z;          goto branch;
+      case MNE_BHCC: r = !h;         goto branch;
+      case MNE_BHCS: r = h;          goto branch;
+      case MNE_BPL:  r = !n;         goto branch;
+      case MNE_BMI:  r = n;          goto branch;
+      case MNE_BMC:  r = !i;         goto branch;
+      case MNE_BMS:  r = i;          goto branch;
+      case MNE_BIL:  r = SimRand(&rnd) & 1; goto branch;   // The IRQ pin
+      case MNE_BIH:  r = SimRand(&rnd) & 1; goto branch;
+      case MNE_BSR:
+        PUSH(pc); PUSH(pc >> 8);
+        r = 1;
+      branch:
+        if (r) pc = (pc + (signed char)mem[(pc - 1) & 0xFFFF]) & 0xFFFF;
+        break;
+
+      // Read-modify-write: memory, A and X
+      case MNE_NEG:  m = RD(ea); r = (0 - m) & 0xFF; c = r != 0; NZ(r); WR(ea, r); break;
+      case MNE_NEGA: a = (0 - a) & 0xFF; c = a != 0; NZ(a); break;
+      case MNE_NEGX: x = (0 - x) & 0xFF; c = x != 0; NZ(x); break;
+      case MNE_COM:  r = ~RD(ea) & 0xFF; c = 1; NZ(r); WR(ea, r); break;
+      case MNE_COMA: a = ~a & 0xFF; c = 1; NZ(a); break;
+      case MNE_COMX: x = ~x & 0xFF; c = 1; NZ(x); break;
+      case MNE_LSR:  m = RD(ea); c = m & 1; r = m >> 1; NZ(r); WR(ea, r); break;
+      case MNE_LSRA: c = a & 1; a >>= 1; NZ(a); break;
+      case MNE_LSRX: c = x & 1; x >>= 1; NZ(x); break;
+      case MNE_ROR:  m = RD(ea); r = (c << 7) | (m >> 1); c = m & 1; NZ(r); WR(ea, r); break;
+      case MNE_RORA: r = (c << 7) | (a >> 1); c = a & 1; a = r; NZ(a); break;
+      case MNE_RORX: r = (c << 7) | (x >> 1); c = x & 1; x = r; NZ(x); break;
+      case MNE_ASR:  m = RD(ea); c = m & 1; r = (m & 0x80) | (m >> 1); NZ(r); WR(ea, r); break;
+      case MNE_ASRA: c = a & 1; a = (a & 0x80) | (a >> 1); NZ(a); break;
+      case MNE_ASRX: c = x & 1; x = (x & 0x80) | (x >> 1); NZ(x); break;
+      case MNE_LSL:  m = RD(ea); c = m >> 7; r = (m << 1) & 0xFF; NZ(r); WR(ea, r); break;
+      case MNE_LSLA: c = a >> 7; a = (a << 1) & 0xFF; NZ(a); break;
+      case MNE_LSLX: c = x >> 7; x = (x << 1) & 0xFF; NZ(x); break;
+      case MNE_ROL:  m = RD(ea); r = ((m << 1) | c) & 0xFF; c = m >> 7; NZ(r); WR(ea, r); break;
+      case MNE_ROLA: r = ((a << 1) | c) & 0xFF; c = a >> 7; a = r; NZ(a); break;
+      case MNE_ROLX: r = ((x << 1) | c) & 0xFF; c = x >> 7; x = r; NZ(x); break;
+      case MNE_DEC:  r = (RD(ea) - 1) & 0xFF; NZ(r); WR(ea, r); break;
+      case MNE_DECA: a = (a - 1) & 0xFF; NZ(a); break;
+      case MNE_DECX: x = (x - 1) & 0xFF; NZ(x); break;
+      case MNE_INC:  r = (RD(ea) + 1) & 0xFF; NZ(r); WR(ea, r); break;
+      case MNE_INCA: a = (a + 1) & 0xFF; NZ(a); break;
+      case MNE_INCX: x = (x + 1) & 0xFF; NZ(x); break;
+      case MNE_TST:  r = RD(ea); NZ(r); break;
+      case MNE_TSTA: NZ(a); break;
+      case MNE_TSTX: NZ(x); break;
+      case MNE_CLR:  WR(ea, 0); n = 0; z = 1; break;
+      case MNE_CLRA: a = 0; n = 0; z = 1; break;
+      case MNE_CLRX: x = 0; n = 0; z = 1; break;
+
+      // Inherent
+      case MNE_MUL:  r = a * x; a = r & 0xFF; x = r >> 8; h = c = 0; break;
+      case MNE_RTI:
+        r = PULL();                             // CCR: 111HINZC
+        h = (r >> 4) & 1; i = (r >> 3) & 1; n = (r >> 2) & 1; z = (r >> 1) & 1; c = r & 1;
+        a = PULL(); x = PULL();
+        pc = PULL() << 8; pc |= PULL();
+        break;
+      case MNE_RTS:  pc = PULL() << 8; pc |= PULL(); break;
+      case MNE_SWI:
+        PUSH(pc); PUSH(pc >> 8); PUSH(x); PUSH(a);
+        PUSH(0xE0 | (h << 4) | (i << 3) | (n ? 4 : 0) | (z << 1) | c);
+        i = 1;
+        pc = SIMVEC(2);
+        break;
+      case MNE_STOP: st->stop = "stop"; goto done;
+      case MNE_WAIT: st->stop = "wait"; goto done;
+      case MNE_TAX:  x = a; break;
+      case MNE_TXA:  a = x; break;
+      case MNE_CLC:  c = 0; break;
+      case MNE_SEC:  c = 1; break;
+      case MNE_CLI:  i = 0; break;
+      case MNE_SEI:  i = 1; break;
+      case MNE_RSP:  sp = 0xFF; break;
+      case MNE_NOP:  break;
+
+      // Register and memory
+      case MNE_SUB:  m = RD(ea); r = a - m; c = r > 0xFF; a = r & 0xFF; NZ(a); break;
+      case MNE_CMP:  m = RD(ea); r = a - m; c = r > 0xFF; NZ(r); break;
+      case MNE_SBC:  m = RD(ea); r = a - m - c; c = r > 0xFF; a = r & 0xFF; NZ(a); break;
+      case MNE_CPX:  m = RD(ea); r = x - m; c = r > 0xFF; NZ(r); break;
+      case MNE_AND:  a &= RD(ea); NZ(a); break;
+      case MNE_BIT:  r = a & RD(ea); NZ(r); break;
+      case MNE_LDA:  a = RD(ea); NZ(a); break;
+      case MNE_STA:  WR(ea, a); NZ(a); break;
+      case MNE_EOR:  a ^= RD(ea); NZ(a); break;
+      case MNE_ADC:  m = RD(ea); r = a + m + c; h = ((a ^ m ^ r) >> 4) & 1; c = r > 0xFF; a = r & 0xFF; NZ(a); break;
+      case MNE_ORA:  a |= RD(ea); NZ(a); break;
+      case MNE_ADD:  m = RD(ea); r = a + m; h = ((a ^ m ^ r) >> 4) & 1; c = r > 0xFF; a = r & 0xFF; NZ(a); break;
+      case MNE_JMP:  pc = ea; break;
+      case MNE_JSR:  PUSH(pc); PUSH(pc >> 8); pc = ea; break;
+      case MNE_LDX:  x = RD(ea); NZ(x); break;
+      case MNE_STX:  WR(ea, x); NZ(x); break;
+      } // end switch
+    } // end while
+
+done:
+  st->cycles = cycles;
+  st->insns = insns;
+  for (pc=0; pc<len; pc++) if (BITTST(exec, bank + pc)) st->addrs++;
+  free(mem);
+  return TRUE;
+  } // SimRun
+
+//--------------------------end-of-c++-module-----------------------------------
@@ -0,0 +1,431 @@
+// haDASM - Disassembler for Microchip processors
+// dasmsrv.cpp - C++ Developer source file.
+// (c)1990-2023 by helmut altmann
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; see the file COPYING.  If not, write to
+// the Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+// Boston, MA 02111-1307, USA.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <windows.h>
+
+#include "equate.h"
+#include "extern.h"
+
+// --------------------------------------------
+// Query server (-q)
+// --------------------------------------------
+// The image is opened once, then address windows of its linear sweep
+// listing are served on request, one query per line on stdin:
+//
+//   l addr [n]   n lines from the item at 'addr' on (scrolling forward)
+//   b addr [n]   n lines before the item at 'addr' (scrolling back)
+//   a addr [n]   n lines around the item at 'addr'
+//   x r|w|t dd   the instructions that read, write or bit test the
+//                direct page address 'dd' (hex or a name of -s)
+//   s            statistics
+//   q            quit
+//
+// 'addr' is hex ($ or 0x optional), n defaults to SRVLINES. The answer
+// is the listing lines, then a line ".". A bad query gets "? ..." and
+// ".". Any pipe or socket relay can sit in front of stdin/stdout.
+//
+// The listing is cut into pages of about SRVPAGE image bytes, each
+// starting at an item (instruction, fill run or string). The index of
+// the page starts is built lazily: it grows by sweeping page after
+// page only as far as the queries reach, so a page is found by a
+// binary search. The rendered pages are held in an LRU cache of
+// SRVCACHE pages. Concatenated, the pages are the listing of DasmFile.
+// The direct page cross-reference is built by the first x query (or
+// at the start with -a, which notes the accesses on the lines).
+//
+typedef struct tag_SRVINDEX {
+  DWORD  start;             // First item of the page
+  int    blank;             // TRUE: the listing before ends with a blank line
+  int    slot;              // Cache slot of the text, ERR = not cached
+} SRVINDEX;
+
+typedef struct tag_SRVSLOT {
+  DWORD  page;              // Index entry of the text
+  DWORD  used;              // LRU stamp, 0 = free
+  char*  text;              // Listing text of the page
+  size_t alloc;             // Allocated chars of text
+  DWORD* line;              // Offsets of its lines in text[]
+  DWORD  nline;             // Number of lines
+  DWORD  aline;             // Allocated entries of line[]
+} SRVSLOT;
+
+typedef struct tag_SERVER {
+  IMAGE  im;
+  SYMTAB sym;
+  RUNTAB runs;
+  XREF   xref;              // Direct page accesses, valid if xref.from
+  OUTBUF ob;                // Render buffer, with the labels and runs
+  SRVINDEX* index;          // index[0..npage]: index[npage].start = end
+  DWORD  npage;             // Pages known so far
+  DWORD  alloc;             // Allocated entries of index[]
+  SRVSLOT slot[SRVCACHE];
+  DWORD  clock;             // LRU time
+  DWORD  hits, misses;
+  FILE*  out;               // The answers
+} SERVER;
+
+//-----------------------------------------------------------------------------
+//
+//                          SrvRender
+//
+// Render page k of the index into a cache slot, the least recently
+// used one. Page npage (the next one) is swept for the first time,
+// which appends its end to the index. Returns the slot.
+//
+static SRVSLOT* SrvRender(SERVER* srv, DWORD k)
+  {
+  SRVINDEX* x = &srv->index[k];
+  SRVSLOT* sl = &srv->slot[0];
+  DWORD end, n, g;
+  size_t i;
+  int lines = 0;
+
+  for (n=1; n<SRVCACHE && sl->used; n++)        // A free slot or the oldest one
+    if (srv->slot[n].used < sl->used) sl = &srv->slot[n];
+  if (sl->used) srv->index[sl->page].slot = ERR;
+
+  // The listing before the page: its last line blank or not (DasmOrg)
+  srv->ob.len = 0;
+  OutStr(&srv->ob, x->blank ? "\n\n" : ".\n");
+
+  // The item after a gap of a hex file: the sweep passed the gap
+  if (srv->im.kind != HEX_NONE && x->start)
+    for (g=0; g<srv->im.nseg && srv->im.seg[g].start <= x->start; g++)
+      if (srv->im.seg[g].start == x->start) DasmOrg(&srv->ob, x->start);
+
+  end = x->start + SRVPAGE < srv->im.size ? x->start + SRVPAGE : srv->im.size;
+  end = DasmRange(&srv->im, &srv->ob, x->start, end, &lines);
+  if (k == srv->npage)                          // Index the next page
+    {
+    if (srv->npage + 2 > srv->alloc)
+      {
+      srv->alloc = 2*srv->alloc;
+      OutOfMemory(srv->index = (SRVINDEX*)realloc(srv->index, srv->alloc * sizeof(SRVINDEX)));
+      x = &srv->index[k];
+      }
+    x[1].start = end;
+    x[1].blank = srv->ob.buf[srv->ob.len-2] == '\n';
+    x[1].slot  = ERR;
+    srv->npage++;
+    }
+
+  n = (DWORD)srv->ob.len - 2;                   // The page without the context
+  if (n + 1 > sl->alloc)
+    {
+    sl->alloc = n + 1;
+    OutOfMemory(sl->text = (char*)realloc(sl->text, sl->alloc));
+    }
+  memcpy(sl->text, srv->ob.buf + 2, n);
+  for (sl->nline=0, i=0; i<n; i++)
+    if (i == 0 || sl->text[i-1] == '\n')
+      {
+      if (sl->nline == sl->aline)
+        {
+        sl->aline = sl->aline ? 2*sl->aline : 64;
+        OutOfMemory(sl->line = (DWORD*)realloc(sl->line, sl->aline * sizeof(DWORD)));
+        }
+      sl->line[sl->nline++] = (DWORD)i;
+      }
+  if (sl->nline == sl->aline)                   // End of the last line
+    {
+    sl->aline = sl->aline ? 2*sl->aline : 64;
+    OutOfMemory(sl->line = (DWORD*)realloc(sl->line, sl->aline * sizeof(DWORD)));
+    }
+  sl->line[sl->nline] = n;
+
+  sl->page = k;
+  x->slot = (int)(sl - srv->slot);
+  srv->misses++;
+  return sl;
+  } // SrvRender
+
+// The text of page k (k <= npage), rendered if not in the cache
+static SRVSLOT* SrvPage(SERVER* srv, DWORD k)
+  {
+  SRVSLOT* sl;
+
+  if (srv->index[k].slot == ERR) sl = SrvRender(srv, k);
+  else
+    {
+    sl = &srv->slot[srv->index[k].slot];
+    srv->hits++;
+    }
+  sl->used = ++srv->clock;
+  return sl;
+  } // SrvPage
+
+// Is there a page k? Sweeps on to it if it is not indexed yet.
+static BOOL SrvHasPage(SERVER* srv, DWORD k)
+  {
+  while (srv->npage < k && srv->index[srv->npage].start < srv->im.size) SrvPage(srv, srv->npage);
+  return k < srv->npage || (k == srv->npage && srv->index[k].start < srv->im.size);
+  } // SrvHasPage
+
+// Address of the listing line s, ERR if it has none (label, blank line)
+static DWORD SrvLineAddr(const char* s)
+  {
+  DWORD a = 0;
+  int n;
+
+  for (n=0; isxdigit((UCHAR)s[n]); n++)
+    a = (a << 4) | (isdigit((UCHAR)s[n]) ? s[n] - '0' : toupper(s[n]) - 'A' + 10);
+  return (n >= 4 && s[n] == SPACE) ? a : (DWORD)ERR;
+  } // SrvLineAddr
+
+//-----------------------------------------------------------------------------
+//
+//                          SrvSeek
+//
+// Find the listing line of the item at address 'addr' (the item that
+// holds it), with its label line: page *k, line *l.
+//
+static void SrvSeek(SERVER* srv, DWORD addr, DWORD* k, DWORD* l)
+  {
+  DWORD lo, hi, mid, a, n;
+  SRVSLOT* sl;
+
+  if (addr >= srv->im.size) addr = srv->im.size - 1;
+  while (srv->index[srv->npage].start <= addr) SrvPage(srv, srv->npage);
+
+  for (lo=0, hi=srv->npage; hi - lo > 1; )      // Last page start <= addr
+    {
+    mid = (lo + hi) / 2;
+    if (srv->index[mid].start <= addr) lo = mid;
+    else hi = mid;
+    }
+
+  for (;;)                                      // Last line at or below addr
+    {
+    sl = SrvPage(srv, lo);
+    for (*l=ERR, n=0; n<sl->nline; n++)
+      {
+      a = SrvLineAddr(&sl->text[sl->line[n]]);
+      if (a == (DWORD)ERR) continue;
+      if (a > addr) break;
+      *l = n;
+      }
+    if (*l != (DWORD)ERR || lo == 0) break;
+    lo--;                                       // A page in a gap, no lines
+    }
+  if (*l == (DWORD)ERR) *l = 0;
+  while (*l > 0 && sl->line[*l] - sl->line[*l-1] > 1 &&
+         SrvLineAddr(&sl->text[sl->line[*l-1]]) == (DWORD)ERR)
+    (*l)--;                                     // Its label
+  *k = lo;
+  } // SrvSeek
+
+//-----------------------------------------------------------------------------
+//
+//                          SrvList
+//
+// Write 'before' lines before and 'after' lines from page k, line l on
+// to srv->out (fewer at the start or end of the listing).
+//
+static void SrvList(SERVER* srv, DWORD k, DWORD l, int before, int after)
+  {
+  SRVSLOT* sl;
+  int n = before + after;
+
+  for (; before > 0; before--)                  // Back to the first line
+    {
+    while (l == 0 && k > 0) l = SrvPage(srv, --k)->nline;
+    if (l == 0) break;
+    l--;
+    }
+  n -= before;
+
+  for (sl=SrvPage(srv, k); n > 0; n--)
+    {
+    while (l >= sl->nline)
+      {
+      if (!SrvHasPage(srv, k+1))
+        return;
+      sl = SrvPage(srv, ++k);
+      l = 0;
+      }
+    fwrite(&sl->text[sl->line[l]], 1, sl->line[l+1] - sl->line[l], srv->out);
+    l++;
+    }
+  } // SrvList
+
+//-----------------------------------------------------------------------------
+//
+//                          SrvXref
+//
+// Answer the query "x kind dd" at p[] ("r C0", "w PORTA"): the listing
+// line of each instruction that accesses the direct page address in
+// the way 'kind'. Returns FALSE if the query is bad.
+//
+static int SrvXref(SERVER* srv, char* p, const SYMTAB* user)
+  {
+  static const char kinds[XREFKINDS+1] = "rwt";
+  const char* k;
+  const DWORD* from;
+  char* q;
+  DWORD addr = XREFPAGE, n, i, l;
+  int kind;
+
+  if (*p == 0 || (k = strchr(kinds, tolower(*p))) == NULL) return FALSE;
+  kind = (int)(k - kinds);
+  for (p++; isspace((UCHAR)*p); p++);
+  for (q=p; *q && !isspace((UCHAR)*q); q++);
+  *q = 0;
+  if (*p == 0) return FALSE;
+
+  if (user)                                     // A name of -s
+    for (i=0; i<user->count; i++)
+      if ((user->sym[i].name & ~SYMDEF) && strcmp(&user->pool[user->sym[i].name & ~SYMDEF], p) == 0)
+        {
+        addr = user->sym[i].addr;
+        break;
+        }
+  if (addr == XREFPAGE)                         // Hex address
+    {
+    if (*p == '$') p++;
+    else if (p[0] == '0' && tolower(p[1]) == 'x') p += 2;
+    addr = strtoul(p, &q, 16);
+    if (*q || q == p) return FALSE;
+    }
+  if (addr >= XREFPAGE) return FALSE;
+
+  if (srv->xref.from == NULL) XrefScan(&srv->im, &srv->xref, srv->ob.run);
+  from = XrefFind(&srv->xref, addr, kind, &n);
+  for (i=0; i<n; i++)
+    {
+    SrvSeek(srv, from[i], &addr, &l);
+    SrvList(srv, addr, l, 0, 1);
+    }
+  return TRUE;
+  } // SrvXref
+
+//-----------------------------------------------------------------------------
+//
+//                          DasmServe
+//
+// Query server (-q) of the image file 'name' with the options 'opt'
+// (-l, -s, -n, -f, -a and --cpu apply, the listing is the linear sweep).
+// The queries are read from 'in' (stdin), the answers written to 'out'
+// (stdout).
+// Returns ERR if the file can't be opened.
+//
+int DasmServe(const char* name, const DASMOPT* opt, FILE* in, FILE* out)
+  {
+  char line[256], *p;
+  SERVER* srv;
+  DWORD addr, k, l;
+  int n, cmd;
+
+  OutOfMemory(srv = (SERVER*)calloc(1, sizeof(SERVER)));
+  if (ImageOpen(&srv->im, name) == ERR)
+    {
+    fprintf(out, "Open failed on %s\n", name);
+    free(srv);
+    return ERR;
+    }
+  srv->im.cpu = opt->cpu;
+  srv->out = out;
+
+  OutInit(&srv->ob, NULL);
+  srv->ob.reg = opt->reg;
+  if (opt->fill)
+    {
+    RunScan(&srv->im, &srv->runs);
+    srv->ob.run = &srv->runs;
+    }
+  if (opt->labels)
+    {
+    SymCopy(&srv->sym, opt->user);
+    SymScan(&srv->im, &srv->sym, srv->ob.run);
+    if (opt->sig) SigScan(&srv->im, &srv->sym, srv->ob.run, opt->sig);
+    srv->ob.sym = &srv->sym;
+    }
+  if (opt->xref)
+    {
+    XrefScan(&srv->im, &srv->xref, srv->ob.run);
+    srv->ob.xref = &srv->xref;
+    }
+
+  srv->alloc = 1024;
+  OutOfMemory(srv->index = (SRVINDEX*)malloc(srv->alloc * sizeof(SRVINDEX)));
+  srv->index[0].start = 0;                      // After "Disassembly of ..\n\n"
+  srv->index[0].blank = TRUE;
+  srv->index[0].slot  = ERR;
+
+  while (fgets(line, sizeof(line), in))
+    {
+    for (p=line; isspace((UCHAR)*p); p++);
+    cmd = tolower(*p);
+    if (cmd == 0) continue;
+    if (cmd == 'q') break;
+
+    if (cmd == 's')
+      fprintf(out, "%u pages indexed up to $%X of $%X, %u cached, %u hits, %u misses\n",
+              (unsigned)srv->npage, (unsigned)srv->index[srv->npage].start, (unsigned)srv->im.size,
+              (unsigned)(srv->misses < SRVCACHE ? srv->misses : SRVCACHE),
+              (unsigned)srv->hits, (unsigned)srv->misses);
+    else if (cmd == 'x')
+      {
+      for (p++; isspace((UCHAR)*p); p++);
+      if (srv->im.size == 0 || !SrvXref(srv, p, opt->user))
+        fprintf(out, "? bad query: x r|w|t addr|name\n");
+      }
+    else
+      {
+      for (p++; isspace((UCHAR)*p); p++);
+      if (*p == '$') p++;
+      else if (p[0] == '0' && tolower(p[1]) == 'x') p += 2;
+      addr = strtoul(p, &p, 16);
+      n = (int)strtol(p, &p, 10);
+      if (n <= 0) n = SRVLINES;
+      while (isspace((UCHAR)*p)) p++;
+
+      if ((cmd != 'l' && cmd != 'b' && cmd != 'a') || *p || srv->im.size == 0)
+        fprintf(out, "? bad query: l|b|a addr [n], x r|w|t addr|name, s, q\n");
+      else
+        {
+        SrvSeek(srv, addr, &k, &l);
+        if (cmd == 'l') SrvList(srv, k, l, 0, n);
+        else if (cmd == 'b') SrvList(srv, k, l, n, 0);
+        else SrvList(srv, k, l, n/2, n - n/2);
+        }
+      }
+    fputs(".\n", out);
+    fflush(out);
+    } // end while
+
+  for (n=0; n<SRVCACHE; n++)
+    {
+    free(srv->slot[n].text);
+    free(srv->slot[n].line);
+    }
+  free(srv->index);
+  OutFree(&srv->ob);
+  XrefFree(&srv->xref);
+  if (opt->labels) SymFree(&srv->sym);
+  if (opt->fill) RunFree(&srv->runs);
+  ImageClose(&srv->im);
+  free(srv);
+  return 0;
+  } // DasmServe
+
+//--------------------------end-of-c++-module-----------------------------------
@@ -0,0 +1,232 @@
+// haDASM - Disassembler for Microchip processors
+// dasmstat.cpp - C++ Developer source file.
+// (c)1990-2023 by helmut altmann
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; see the file COPYING.  If not, write to
+// the Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+// Boston, MA 02111-1307, USA.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <windows.h>
+#include <psapi.h>     // Library psapi.lib for GetProcessMemoryInfo
+
+#include <chrono>
+
+#include "equate.h"
+#include "extern.h"
+#include "dasmisa.h"
+
+// --------------------------------------------
+// Run statistics (--stats)
+// --------------------------------------------
+// The output sink carries the counters (ob->stats): DasmLine counts
+// the instructions by opcode and addressing mode, DasmData and DasmRun
+// the data bytes, OutFlush the bytes written. Without --stats this is
+// one test of a NULL pointer per line, with it a few increments.
+//
+// The run is split into phases (StatPhase): load, decode (the
+// pre-passes of -f, -l and -r), format (the listing lines, which are
+// decoded and formatted in one go) and write. A phase ends when the
+// next one starts, so the clock is read a few times per file only;
+// OutFlush switches to the write phase and back. In batch mode every
+// job has its own counters, added up when the job is done, so the
+// phase times are summed over the worker threads.
+//
+static const char* const statPhase[STAT_PHASES] = {NULL, "load", "decode", "format", "write"};
+
+typedef struct tag_STATOP {
+  DWORD  n;         // Instructions
+  int    op;        // Index of the opcode
+} STATOP;
+
+//-----------------------------------------------------------------------------
+//
+//                          StatClock
+//
+// Monotonic clock in nanoseconds.
+//
+long long StatClock(void)
+  {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+           std::chrono::steady_clock::now().time_since_epoch()).count();
+  } // StatClock
+
+//-----------------------------------------------------------------------------
+//
+//                          StatInit
+//
+// Clear the counters 'st' of a run with the instruction set 'cpu'
+// and start its clock.
+//
+void StatInit(DASMSTATS* st, int cpu)
+  {
+  memset(st, 0, sizeof(DASMSTATS));
+  st->cpu = cpu;
+  st->start = st->mark = StatClock();
+  } // StatInit
+
+//-----------------------------------------------------------------------------
+//
+//                          StatPhase
+//
+// End the current phase of ob->stats and start 'phase' (STAT_xxx).
+//
+void StatPhase(OUTBUF* ob, int phase)
+  {
+  DASMSTATS* st = ob->stats;
+  long long t;
+
+  if (st == NULL) return;
+  t = StatClock();
+  st->time[st->phase] += t - st->mark;
+  st->mark = t;
+  st->phase = phase;
+  } // StatPhase
+
+//-----------------------------------------------------------------------------
+//
+//                          StatAdd
+//
+// Add the counters and phase times of 'st' to 'to'.
+//
+void StatAdd(DASMSTATS* to, const DASMSTATS* st)
+  {
+  int n;
+
+  for (n=0; n<STAT_PHASES; n++) to->time[n] += st->time[n];
+  for (n=0; n<STATOPS; n++) to->op[n] += st->op[n];
+  for (n=0; n<AM_COUNT; n++) to->mode[n] += st->mode[n];
+  to->files += st->files;
+  to->code  += st->code;
+  to->data  += st->data;
+  to->out   += st->out;
+  } // StatAdd
+
+// Descending count, then ascending opcode
+static int StatCompare(const void* a, const void* b)
+  {
+  const STATOP* x = (const STATOP*)a;
+  const STATOP* y = (const STATOP*)b;
+
+  if (x->n != y->n) return x->n < y->n ? 1 : -1;
+  return x->op - y->op;
+  } // StatCompare
+
+// Opcode 'op' (see ISA::Index) as hex digits with the prefix, "9EE6"
+static char* StatOpcode(char* s, int cpu, int op)
+  {
+  static const BYTE prefix[3][4] = {{0}, {0, 0x9E}, {0, 0x18, 0x1A, 0xCD}};
+
+  if (op >> 8) s = PutHex2(s, prefix[cpu][op >> 8]);
+  s = PutHex2(s, op & 0xFF);
+  *s = 0;
+  return s;
+  } // StatOpcode
+
+static const OPDESC* StatDesc(int cpu, int op)
+  {
+  return cpu == DASM6805_HC11 ? &opDescHC11[op >> 8][op & 0xFF] :
+         cpu == DASM6805_HC08 ? &opDescHC08[op >> 8][op & 0xFF] : &opDesc6805[op & 0xFF];
+  } // StatDesc
+
+//-----------------------------------------------------------------------------
+//
+//                          StatReport
+//
+// Report the statistics 'st' of the run on stderr, as text
+// (STATS_TEXT) or as one JSON object (STATS_JSON): wall time and the
+// time of each phase, the throughput, code and data bytes, the
+// illegal opcodes (---), output bytes and peak memory, the addressing
+// modes and the opcode histogram (the text shows the top STATTOP).
+//
+void StatReport(const DASMSTATS* st, int kind)
+  {
+  PROCESS_MEMORY_COUNTERS pm;
+  STATOP* op;
+  const OPDESC* d;
+  char hex[8];
+  unsigned long long insns = 0, bytes = st->code + st->data;
+  double wall = (StatClock() - st->start) / 1e9;
+  size_t peak = 0;
+  int n, k, nop = 0;
+
+  OutOfMemory(op = (STATOP*)malloc(STATOPS * sizeof(STATOP)));
+  for (n=0; n<STATOPS; n++)
+    if (st->op[n])
+      {
+      op[nop].n = st->op[n];
+      op[nop++].op = n;
+      insns += st->op[n];
+      }
+  qsort(op, nop, sizeof(STATOP), StatCompare);
+
+  pm.cb = sizeof(pm);
+  if (GetProcessMemoryInfo(GetCurrentProcess(), &pm, sizeof(pm))) peak = pm.PeakWorkingSetSize;
+  if (wall <= 0) wall = 1e-9;
+
+  if (kind == STATS_JSON)
+    {
+    fprintf(stderr, "{\"files\":%u,\"wall_ms\":%.3f,\"phase_ms\":{", (unsigned)st->files, wall * 1e3);
+    for (n=1; n<STAT_PHASES; n++)
+      fprintf(stderr, "%s\"%s\":%.3f", n > 1 ? "," : "", statPhase[n], st->time[n] / 1e6);
+    fprintf(stderr, "},\"bytes\":%llu,\"code_bytes\":%llu,\"data_bytes\":%llu,\"code_ratio\":%.4f,"
+                    "\"bytes_per_s\":%.0f,\"insns\":%llu,\"insns_per_s\":%.0f,\"illegal\":%u,"
+                    "\"out_bytes\":%llu,\"peak_mem\":%llu,\"modes\":{",
+            bytes, st->code, st->data, bytes ? (double)st->code / bytes : 0.0,
+            bytes / wall, insns, insns / wall, (unsigned)st->mode[AM_ILL],
+            st->out, (unsigned long long)peak);
+    for (n=0, k=0; n<AM_COUNT; n++)
+      if (st->mode[n]) fprintf(stderr, "%s\"%s\":%u", k++ ? "," : "", modeName[n], (unsigned)st->mode[n]);
+    fprintf(stderr, "},\"opcodes\":[");
+    for (n=0; n<nop; n++)
+      {
+      d = StatDesc(st->cpu, op[n].op);
+      StatOpcode(hex, st->cpu, op[n].op);
+      fprintf(stderr, "%s{\"op\":\"%s\",\"mne\":\"%s\",\"mode\":\"%s\",\"n\":%u}", n ? "," : "",
+              hex, mneName[d->mne], modeName[d->mode], (unsigned)op[n].n);
+      }
+    fprintf(stderr, "]}\n");
+    free(op);
+    return;
+    }
+
+  fprintf(stderr, "Statistics of %u file%s, %.3f ms wall time\n", (unsigned)st->files,
+          st->files == 1 ? "" : "s", wall * 1e3);
+  for (n=1; n<STAT_PHASES; n++)
+    fprintf(stderr, "  %-8s %10.3f ms\n", statPhase[n], st->time[n] / 1e6);
+  fprintf(stderr, "  %llu bytes: %llu code, %llu data (%.1f%% code), %.1f MB/s\n",
+          bytes, st->code, st->data, bytes ? 100.0 * st->code / bytes : 0.0, bytes / wall / 1e6);
+  fprintf(stderr, "  %llu instructions, %.2f M/s, %u illegal (---)\n",
+          insns, insns / wall / 1e6, (unsigned)st->mode[AM_ILL]);
+  fprintf(stderr, "  %llu bytes written, peak memory %.1f MB\n", st->out, peak / 1048576.0);
+
+  fprintf(stderr, "Addressing modes:");
+  for (n=0, k=0; n<AM_COUNT; n++)
+    if (st->mode[n]) fprintf(stderr, "%s %s %u", k++ ? "," : "", modeName[n], (unsigned)st->mode[n]);
+  fprintf(stderr, "\n");
+
+  if (nop) fprintf(stderr, "Opcodes (top %d of %d):\n", nop < STATTOP ? nop : STATTOP, nop);
+  for (n=0; n<nop && n<STATTOP; n++)
+    {
+    d = StatDesc(st->cpu, op[n].op);
+    StatOpcode(hex, st->cpu, op[n].op);
+    fprintf(stderr, "  %-4s  %-6s %-7s %10u %5.1f%%\n", hex, mneName[d->mne], modeName[d->mode],
+            (unsigned)op[n].n, 100.0 * op[n].n / insns);
+    }
+  free(op);
+  } // StatReport
+
+//--------------------------end-of-c++-module-----------------------------------
@@ -0,0 +1,370 @@
+// haDASM - Disassembler for Microchip processors
+// dasmsym.cpp - C++ Developer source file.
+// (c)1990-2023 by helmut altmann
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; see the file COPYING.  If not, write to
+// the Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+// Boston, MA 02111-1307, USA.
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <windows.h>
+
+#include "equate.h"
+#include "extern.h"
+#include "dasmisa.h"
+
+// --------------------------------------------
+// Label and symbol table
+// --------------------------------------------
+// Pass 1 appends every branch and jump target to one flat array,
+// which is then radix sorted and indexed by buckets of the address:
+// a lookup is a bucket and a few neighbours. The label lines of the
+// listing need no lookups at all, they walk the sorted array along
+// with the listing (OUTBUF.cur). There are no per symbol allocations:
+// the user names are kept in one string pool, the generated "Lxxxx"
+// names are rendered from the address. Both passes are linear.
+//
+//-----------------------------------------------------------------------------
+//
+//                          SymInit
+//
+void SymInit(SYMTAB* st)
+  {
+  memset(st, 0, sizeof(SYMTAB));
+  st->poolSize = 1024;
+  st->poolLen = 1;                              // Offset 0 = no name
+  OutOfMemory(st->pool = (char*)malloc(st->poolSize));
+  st->pool[0] = 0;
+  } // SymInit
+
+//-----------------------------------------------------------------------------
+//
+//                          SymCopy
+//
+// Initialize 'st' as an unsorted copy of 'src' (NULL = empty table).
+//
+void SymCopy(SYMTAB* st, const SYMTAB* src)
+  {
+  SymInit(st);
+  if (src == NULL) return;
+
+  st->alloc = st->count = src->count;
+  if (st->count)
+    {
+    OutOfMemory(st->sym = (SYMENT*)malloc(st->count * sizeof(SYMENT)));
+    memcpy(st->sym, src->sym, st->count * sizeof(SYMENT));
+    }
+  st->poolLen = st->poolSize = src->poolLen;
+  OutOfMemory(st->pool = (char*)realloc(st->pool, st->poolSize));
+  memcpy(st->pool, src->pool, src->poolLen);
+  } // SymCopy
+
+//-----------------------------------------------------------------------------
+//
+//                          SymFree
+//
+void SymFree(SYMTAB* st)
+  {
+  free(st->sym);
+  free(st->bucket);
+  free(st->pool);
+  memset(st, 0, sizeof(SYMTAB));
+  } // SymFree
+
+//-----------------------------------------------------------------------------
+//
+//                          SymAdd
+//
+// Append a symbol (without a name) at address 'addr'. Duplicates are
+// merged by SymSort, which must be called before the next lookup.
+//
+SYMENT* SymAdd(SYMTAB* st, DWORD addr)
+  {
+  if (st->count == st->alloc)
+    {
+    st->alloc = st->alloc ? 2*st->alloc : 4096;
+    OutOfMemory(st->sym = (SYMENT*)realloc(st->sym, st->alloc * sizeof(SYMENT)));
+    }
+  st->nbucket = 0;                              // Not sorted
+  st->sym[st->count].addr = addr;
+  st->sym[st->count].name = 0;
+  return &st->sym[st->count++];
+  } // SymAdd
+
+//-----------------------------------------------------------------------------
+//
+//                          SymPool
+//
+// Append the name[0..n-1] to the string pool of 'st'.
+// Returns its offset, for SYMENT.name.
+//
+DWORD SymPool(SYMTAB* st, const char* name, int n)
+  {
+  DWORD off = st->poolLen;
+
+  if (st->poolLen + n + 1 > st->poolSize)
+    {
+    while (st->poolLen + n + 1 > st->poolSize) st->poolSize *= 2;
+    OutOfMemory(st->pool = (char*)realloc(st->pool, st->poolSize));
+    }
+  memcpy(&st->pool[off], name, n);
+  st->pool[off + n] = 0;
+  st->poolLen += n + 1;
+  return off;
+  } // SymPool
+
+//-----------------------------------------------------------------------------
+//
+//                          SymSort
+//
+// Sort the symbols by address (LSD radix sort, 2 x 16 bit), merge the
+// duplicates and build the bucket index. Of several user names for
+// one address the last one wins.
+//
+void SymSort(SYMTAB* st)
+  {
+  SYMENT *tmp, *src, *dst;
+  DWORD* cnt;
+  DWORD i, n, sum, max;
+  int shift;
+
+  free(st->bucket);
+  st->bucket = NULL;
+  st->nbucket = 0;
+  if (st->count == 0) return;
+
+  OutOfMemory(tmp = (SYMENT*)malloc(st->count * sizeof(SYMENT)));
+  OutOfMemory(cnt = (DWORD*)malloc(0x10000 * sizeof(DWORD)));
+
+  src = st->sym;
+  dst = tmp;
+  for (shift=0; shift<32; shift+=16)            // Stable counting sort by 16 bits
+    {
+    memset(cnt, 0, 0x10000 * sizeof(DWORD));
+    for (i=0; i<st->count; i++) cnt[(src[i].addr >> shift) & 0xFFFF]++;
+    for (sum=0, i=0; i<0x10000; i++) { n = cnt[i]; cnt[i] = sum; sum += n; }
+    for (i=0; i<st->count; i++) dst[cnt[(src[i].addr >> shift) & 0xFFFF]++] = src[i];
+    dst = src;
+    src = (dst == st->sym) ? tmp : st->sym;
+    }
+  free(cnt);
+  free(tmp);                                    // src == st->sym again
+
+  // Merge the duplicates
+  for (n=0, i=0; i<st->count; i++)
+    {
+    if (n && st->sym[n-1].addr == st->sym[i].addr)
+      {
+      if (st->sym[i].name & ~SYMDEF) st->sym[n-1].name = (st->sym[n-1].name & SYMDEF) | st->sym[i].name;
+      else st->sym[n-1].name |= st->sym[i].name;
+      }
+    else st->sym[n++] = st->sym[i];
+    }
+  st->count = n;
+
+  // Bucket index: about one symbol per bucket
+  max = st->sym[n-1].addr;
+  for (st->shift=0; st->shift<31 && (max >> st->shift) >= n; st->shift++);
+  st->nbucket = (max >> st->shift) + 2;
+  OutOfMemory(st->bucket = (DWORD*)malloc(st->nbucket * sizeof(DWORD)));
+  for (i=0, n=0; i<st->nbucket; i++)
+    {
+    while (n < st->count && (st->sym[n].addr >> st->shift) < i) n++;
+    st->bucket[i] = n;
+    }
+  } // SymSort
+
+//-----------------------------------------------------------------------------
+//
+//                          SymSeek
+//
+// Returns the index of the first symbol at or above address 'addr'
+// (count if there is none).
+//
+DWORD SymSeek(const SYMTAB* st, DWORD addr)
+  {
+  DWORD b = addr >> st->shift, i;
+
+  if (st->nbucket == 0 || b >= st->nbucket - 1) return st->count;
+  for (i=st->bucket[b]; i<st->count && st->sym[i].addr < addr; i++);
+  return i;
+  } // SymSeek
+
+//-----------------------------------------------------------------------------
+//
+//                          SymFind
+//
+// Returns the symbol at address 'addr', NULL if there is none.
+//
+SYMENT* SymFind(const SYMTAB* st, DWORD addr)
+  {
+  DWORD i = SymSeek(st, addr);
+
+  return (i < st->count && st->sym[i].addr == addr) ? &st->sym[i] : NULL;
+  } // SymFind
+
+//-----------------------------------------------------------------------------
+//
+//                          SymName
+//
+// Render the name of the symbol 'e' to s[], the user name or "Lxxxx".
+// Returns the new end pointer (no NUL).
+//
+char* SymName(char* s, const SYMTAB* st, const SYMENT* e)
+  {
+  const char* p;
+  int n;
+
+  if (e->name & ~SYMDEF)
+    for (p=&st->pool[e->name & ~SYMDEF]; *p; ) *s++ = *p++;
+  else
+    {
+    *s++ = 'L';
+    for (n=4; n<8 && (e->addr >> (4*n)); n++);
+    while (n--) *s++ = "0123456789ABCDEF"[(e->addr >> (4*n)) & 0x0F];
+    }
+  return s;
+  } // SymName
+
+//-----------------------------------------------------------------------------
+//
+//                          SymLoad
+//
+// Load the user symbols of the text file 'fname' into 'st'.
+// One symbol per line, ';' starts a comment line:
+//
+//   name [equ] [$]hexaddr
+//
+// Returns the number of bad lines, ERR if the file can't be opened.
+//
+int SymLoad(SYMTAB* st, const char* fname)
+  {
+  char line[256], *p, *name, *q;
+  int nr = 0, errors = 0;
+  DWORD addr, n;
+  FILE* fp;
+
+  if ((fp = fopen(fname, "r")) == NULL) return ERR;
+
+  while (fgets(line, sizeof(line), fp))
+    {
+    nr++;
+    for (p=line; isspace((UCHAR)*p); p++);
+    if (*p == 0 || *p == ';') continue;         // Empty or comment line
+
+    for (name=p; *p && !isspace((UCHAR)*p); p++);
+    n = p - name;
+    while (isspace((UCHAR)*p)) p++;
+    if (tolower(p[0]) == 'e' && tolower(p[1]) == 'q' && tolower(p[2]) == 'u' && isspace((UCHAR)p[3]))
+      for (p+=3; isspace((UCHAR)*p); p++);
+    if (*p == '$') p++;
+    else if (p[0] == '0' && tolower(p[1]) == 'x') p += 2;
+    addr = strtoul(p, &q, 16);
+    while (isspace((UCHAR)*q)) q++;
+
+    if (n == 0 || n > SYMLEN || !(isalpha((UCHAR)name[0]) || name[0] == '_') ||
+        q == p || (*q && *q != ';'))
+      {
+      fprintf(stderr, "%s(%d): bad symbol line\n", fname, nr);
+      errors++;
+      continue;
+      }
+
+    SymAdd(st, addr)->name = SymPool(st, name, n);
+    }
+
+  fclose(fp);
+  return errors;
+  } // SymLoad
+
+//-----------------------------------------------------------------------------
+//
+//                          SymScan
+//
+// Pass 1 of the linear sweep listing of the image 'im': collect the
+// branch and jump targets inside the image, sort them, then mark all
+// symbols that fall on an instruction start as defined (SYMDEF).
+// The fill runs and strings 'rt' (NULL = none) are skipped like in
+// the listing (see DasmRange), a label may only be at their start.
+//
+template<class ISA>
+static void SymSweep(IMAGE* im, SYMTAB* st, const RUNTAB* rt)
+  {
+  const OPDESC* d;
+  const BYTE* p;
+  DWORD pc, end, lim, target, k, cur = 0;
+  int pass;
+
+  for (pass=1; pass<=2; pass++)
+    {
+    k = 0;
+    for (pc=0; pc<im->size; )
+      {
+      end = im->base + im->len;
+      if (end < im->lim)                        // Keep a whole instruction in the window
+        end = (end > ISA::maxlen-1) ? end - (ISA::maxlen-1) : 0;
+
+      if (pc < im->base || pc >= end)
+        {
+        if (!ImageWindow(im, pc)) break;
+        if (pc < im->base) pc = im->base;       // A gap of a hex file
+        continue;
+        }
+
+      while (pc < end)
+        {
+        p = &im->data[pc - im->base];
+        if (pass == 2)                          // Merge with the sorted symbols
+          {
+          while (cur < st->count && st->sym[cur].addr < pc) cur++;
+          if (cur < st->count && st->sym[cur].addr == pc) st->sym[cur].name |= SYMDEF;
+          }
+
+        lim = im->lim;
+        if (rt)
+          {
+          while (k < rt->count && rt->run[k].addr + rt->run[k].len <= pc) k++;
+          if (k < rt->count && rt->run[k].addr <= pc)
+            {
+            pc = rt->run[k].addr + rt->run[k].len;  // Fill run or string
+            continue;
+            }
+          if (k < rt->count) lim = rt->run[k].addr;
+          }
+
+        d = ISA::Desc(p, lim - pc);
+        if (pass == 1 && pc + d->len <= lim)
+          {
+          target = FlowTarget(d, p, pc);
+          if (target < im->size) SymAdd(st, target);
+          }
+        pc += d->len;
+        if (pc > lim) pc = lim;
+        }
+      } // end for pc
+
+    if (pass == 1) SymSort(st);
+    } // end for pass
+  } // SymSweep
+
+void SymScan(IMAGE* im, SYMTAB* st, const RUNTAB* rt)
+  {
+  ISACALL(im->cpu, SymSweep, (im, st, rt));
+  } // SymScan
+
+//--------------------------end-of-c++-module-----------------------------------
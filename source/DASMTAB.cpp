@@ -0,0 +1,935 @@
+// haDASM - Disassembler for Microchip processors
+// dasmtab.cpp - C++ Developer source file.
+// (c)1990-2023 by helmut altmann
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; see the file COPYING.  If not, write to
+// the Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+// Boston, MA 02111-1307, USA.
+
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <windows.h>
+
+#include "equate.h"
+#include "extern.h"
+#include "dasmisa.h"
+
+// --------------------------------------------
+// Motorola M68HC05 Family Instruction mnemonic
+// --------------------------------------------
+// IMM Immediate addressing mode 
+//     ii = Immediate 8bit operand (# Immediate value)
+// INH Inherent addressing mode
+//     no operand
+// DIR Direct addressing mode
+//     dd = Direct 8bit address of operand
+// REL Relative addressing mode
+//     rr = relative 8bit offset of branch instruction 
+// EXT Extended addressing mode
+//     hh ll = High and low bytes of 16bit operand address 
+// IX  Indexed, no offset addressing mode
+//     no operand
+// IX1 Indexed, 8-bit offset addressing mode
+//     ff = byte offset in indexed, 8-bit offset addressing
+// IX2 Indexed, 16-bit offset addressing mode
+//     ee ff High and low bytes of offset in indexed, 16-bit offset addressing 
+// 
+extern constexpr _6805MNEMONIC mnemonic6805[256] = {
+  // DIR-Addr-Mode: 3-Byte-Instr., op1={0..7}, op2={dd}, op3={rr}
+  {"\t\t 5~\tbrset\t0,$"}, // 00  {6,"BRSET",8,0x00},
+  {"\t\t 5~\tbrclr\t0,$"}, // 01  {6,"BRCLR",8,0x01},
+  {"\t\t 5~\tbrset\t1,$"}, // 02  {6,"BRSET",8,0x02},
+  {"\t\t 5~\tbrclr\t1,$"}, // 03  {6,"BRCLR",8,0x03},
+  {"\t\t 5~\tbrset\t2,$"}, // 04  {6,"BRSET",8,0x04},
+  {"\t\t 5~\tbrclr\t2,$"}, // 05  {6,"BRCLR",8,0x05},
+  {"\t\t 5~\tbrset\t3,$"}, // 06  {6,"BRSET",8,0x06},
+  {"\t\t 5~\tbrclr\t3,$"}, // 07  {6,"BRCLR",8,0x07},
+  {"\t\t 5~\tbrset\t4,$"}, // 08  {6,"BRSET",8,0x08},
+  {"\t\t 5~\tbrclr\t4,$"}, // 09  {6,"BRCLR",8,0x09},
+  {"\t\t 5~\tbrset\t5,$"}, // 0A  {6,"BRSET",8,0x0A},
+  {"\t\t 5~\tbrclr\t5,$"}, // 0B  {6,"BRCLR",8,0x0B},
+  {"\t\t 5~\tbrset\t6,$"}, // 0C  {6,"BRSET",8,0x0C},
+  {"\t\t 5~\tbrclr\t6,$"}, // 0D  {6,"BRCLR",8,0x0D},
+  {"\t\t 5~\tbrset\t7,$"}, // 0E  {6,"BRSET",8,0x0E},
+  {"\t\t 5~\tbrclr\t7,$"}, // 0F  {6,"BRCLR",8,0x0F},
+             
+  // DIR-Addr-Mode: 2-Byte-Instr., op1={0..7}, op2={dd}
+  {"\t 5~\tbset\t0,$"},    // 10  {5,"BSET",7,0x10},
+  {"\t 5~\tbclr\t0,$"},    // 11  {5,"BCLR",7,0x11},
+  {"\t 5~\tbset\t1,$"},    // 12  {5,"BSET",7,0x12},
+  {"\t 5~\tbclr\t1,$"},    // 13  {5,"BCLR",7,0x13},
+  {"\t 5~\tbset\t2,$"},    // 14  {5,"BSET",7,0x14},
+  {"\t 5~\tbclr\t2,$"},    // 15  {5,"BCLR",7,0x15},
+  {"\t 5~\tbset\t3,$"},    // 16  {5,"BSET",7,0x16},
+  {"\t 5~\tbclr\t3,$"},    // 17  {5,"BCLR",7,0x17},
+  {"\t 5~\tbset\t4,$"},    // 18  {5,"BSET",7,0x18},
+  {"\t 5~\tbclr\t4,$"},    // 19  {5,"BCLR",7,0x19},
+  {"\t 5~\tbset\t5,$"},    // 1A  {5,"BSET",7,0x1A},
+  {"\t 5~\tbclr\t5,$"},    // 1B  {5,"BCLR",7,0x1B},
+  {"\t 5~\tbset\t6,$"},    // 1C  {5,"BSET",7,0x1C},
+  {"\t 5~\tbclr\t6,$"},    // 1D  {5,"BCLR",7,0x1D},
+  {"\t 5~\tbset\t7,$"},    // 1E  {5,"BSET",7,0x1E},
+  {"\t 5~\tbclr\t7,$"},    // 1F  {5,"BCLR",7,0x1F},
+
+  // REL-Addr-Mode: 2-Byte-Instr., op1={rr}
+  {"\t 3~\tbra\t$"},       // 20  {4,"BRA", 3,0x20},
+  {"\t 3~\tbrn\t$"},       // 21  {4,"BRN", 3,0x21},
+  {"\t 3~\tbhi\t$"},       // 22  {4,"BHI", 3,0x22},
+  {"\t 3~\tbls\t$"},       // 23  {4,"BLS", 3,0x23},
+  {"\t 3~\tbcc\t$"},       // 24  {4,"BCC", 3,0x24},  {4,"BHS"}, 3,0x24}, // same as BCC
+  {"\t 3~\tbcs\t$"},       // 25  {4,"BCS", 3,0x25},  {4,"BLO"}, 3,0x25}, // same as BCS
+  {"\t 3~\tbne\t$"},       // 26  {4,"BNE", 3,0x26},
+  {"\t 3~\tbeq\t$"},       // 27  {4,"BEQ", 3,0x27},
+  {"\t 3~\tbhcc\t$"},      // 28  {5,"BHCC",3,0x28},
+  {"\t 3~\tbhcs\t$"},      // 29  {5,"BHCS",3,0x29},
+  {"\t 3~\tbpl\t$"},       // 2A  {4,"BPL", 3,0x2A},
+  {"\t 3~\tbmi\t$"},       // 2B  {4,"BMI", 3,0x2B},
+  {"\t 3~\tbmc\t$"},       // 2C  {4,"BMC", 3,0x2C},
+  {"\t 3~\tbms\t$"},       // 2D  {4,"BMS", 3,0x2D},
+  {"\t 3~\tbil\t$"},       // 2E  {4,"BIL", 3,0x2E},
+  {"\t 3~\tbih\t$"},       // 2F  {4,"BIH", 3,0x2F},
+
+  // DIR-Addr-Mode: 2-Byte-Instr., op1={dd}
+  {"\t 5~\tneg\t$"},       // 30  {4,"NEG",4,0x30},
+  {" \t---"},              // 31
+  {" \t---"},              // 32
+  {"\t 5~\tcom\t$"},       // 33  {4,"COM",4,0x33},
+  {"\t 5~\tlsr\t$"},       // 34  {4,"LSR",4,0x34},
+  {" \t---"},              // 35
+  {"\t 5~\tror\t$"},       // 36  {4,"ROR",4,0x36},
+  {"\t 5~\tasr\t$"},       // 37  {4,"ASR",4,0x37},
+  {"\t 5~\tlsl\t$"},       // 38  {4,"LSL",4,0x38},   {4,"ASL",4,0x38}, // same as LSL
+  {"\t 5~\trol\t$"},       // 39  {4,"ROL",4,0x39},
+  {"\t 5~\tdec\t$"},       // 3A  {4,"DEC",4,0x3A},
+  {" \t---"},              // 3B
+  {"\t 5~\tinc\t$"},       // 3C  {4,"INC",4,0x3C},
+  {"\t 4~\ttst\t$"},       // 3D  {4,"TST",4,0x3D},
+  {" \t---"},              // 3E
+  {"\t 5~\tclr\t$"},       // 3F  {4,"CLR",4,0x3F},
+
+  // INH-Addr-Mode: 1-Byte-Instr., no operands
+  {" 3~\tnega"},           // 40  {5,"NEGA",2,0x40},
+  {" \t---"},              // 41
+  {"11~\tmul"},            // 42  {4,"MUL"},2,0x42},
+  {" 3~\tcoma"},           // 43  {5,"COMA",2,0x43},
+  {" 3~\tlsra"},           // 44  {5,"LSRA",2,0x44},
+  {" \t---"},              // 45
+  {" 3~\trora"},           // 46  {5,"RORA",2,0x46},  
+  {" 3~\tasra"},           // 47  {5,"ASRA",2,0x47},
+  {" 3~\tlsla"},           // 48  {5,"LSLA",2,0x48},  {5,"ASLA",2,0x48},  // same as LSLA
+  {" 3~\trola"},           // 49  {5,"ROLA",2,0x49},
+  {" 3~\tdeca"},           // 4A  {5,"DECA",2,0x4A},
+  {" \t---"},              // 4B  
+  {" 3~\tinca"},           // 4C  {5,"INCA",2,0x4C},
+  {" 3~\ttsta"},           // 4D  {5,"TSTA",2,0x4D},
+  {" \t---"},              // 4E  
+  {" 3~\tclra"},           // 4F  {5,"CLRA",2,0x4F},
+
+  // INH-Addr-Mode: 1-Byte-Inst., no operands
+  {" 3~\tnegx"},           // 50  {5,"NEGX",2,0x50},
+  {" \t---"},              // 51
+  {" \t---"},              // 52  
+  {" 3~\tcomx"},           // 53  {5,"COMX",2,0x53},
+  {" 3~\tlsrx"},           // 54  {5,"LSRX",2,0x54},
+  {" \t---"},              // 55
+  {" 3~\trorx"},           // 56  {5,"RORX",2,0x56},                          
+  {" 3~\tasrx"},           // 57  {5,"ASRX",2,0x57},
+  {" 3~\tlslx"},           // 58  {5,"LSLX",2,0x58},  {5,"ASLX",2,0x58},  // same as LSLX
+  {" 3~\trolx"},           // 59  {5,"ROLX",2,0x59},
+  {" 3~\tdecx"},           // 5A  {5,"DECX",2,0x5A},
+  {" \t---"},              // 5B  
+  {" 3~\tincx"},           // 5C  {5,"INCX",2,0x5C},
+  {" 3~\ttstx"},           // 5D  {5,"TSTX",2,0x5D},
+  {" \t---"},              // 5E  
+  {" 3~\tclrx"},           // 5F  {5,"CLRX",2,0x5F},
+  
+  // IX1-Addr-Mode: 2-Byte-Instr., op1={ff}, op2={X}
+  {"\t 6~\tneg\t$"},       // 60  {4,"NEG",4,0x60},
+  {" \t---"},              // 61
+  {" \t---"},              // 62
+  {"\t 6~\tcom\t$"},       // 63  {4,"COM",4,0x63},
+  {"\t 6~\tlsr\t$"},       // 64  {4,"LSR",4,0x64},
+  {" \t---"},              // 65
+  {"\t 6~\tror\t$"},       // 66  {4,"ROR",4,0x66},
+  {"\t 6~\tasr\t$"},       // 67  {4,"ASR",4,0x67},
+  {"\t 6~\tlsl\t$"},       // 68  {4,"LSL",4,0x68},   {4,"ASL",4,0x68}, // same as LSL
+  {"\t 6~\trol\t$"},       // 69  {4,"ROL",4,0x69},
+  {"\t 6~\tdec\t$"},       // 6A  {4,"DEC",4,0x6A},
+  {" \t---"},              // 6B
+  {"\t 6~\tinc\t$"},       // 6C  {4,"INC",4,0x6C},
+  {"\t 5~\ttst\t$"},       // 6D  {4,"TST",4,0x6D},
+  {" \t---"},              // 6E
+  {"\t 6~\tclr\t$"},       // 6F  {4,"CLR",4,0x6F},
+
+  // IX-Addr-Mode: 1-Byte-Instr., no operands
+  {" 5~\tneg\t,x"},       // 70 {4,"NEG",4,0x70},
+  {" \t---"},             // 71
+  {" \t---"},             // 72
+  {" 5~\tcom\t,x"},       // 73 {4,"COM",4,0x73},
+  {" 5~\tlsr\t,x"},       // 74 {4,"LSR",4,0x74},
+  {" \t---"},             // 75
+  {" 5~\tror\t,x"},       // 76 {4,"ROR",4,0x76},
+  {" 5~\tasr\t,x"},       // 77 {4,"ASR",4,0x77},
+  {" 5~\tlsl\t,x"},       // 78 {4,"LSL",4,0x78},   {4,"ASL",4,0x78}, // same as LSL
+  {" 5~\trol\t,x"},       // 79 {4,"ROL",4,0x79},
+  {" 5~\tdec\t,x"},       // 7A {4,"DEC",4,0x7A},
+  {" \t---"},             // 7B
+  {" 5~\tinc\t,x"},       // 7C {4,"INC",4,0x7C},
+  {" 4~\ttst\t,x"},       // 7D {4,"TST",4,0x7D},
+  {" \t---"},             // 7E
+  {" 5~\tclr\t,x"},       // 7F {4,"CLR",4,0x7F},
+
+  // INH-Addr-Mode: 1-Byte-Inst., no operands
+  {" 9~\trti"},            // 80  {4,"RTI"}, 2,0x80},
+  {" 6~\trts"},            // 81  {4,"RTS"}, 2,0x81},
+  {" \t---"},              // 82
+  {"10~\tswi"},            // 83  {4,"SWI"}, 2,0x83},
+  {" \t---"},              // 84
+  {" \t---"},              // 85
+  {" \t---"},              // 86
+  {" \t---"},              // 87
+  {" \t---"},              // 88
+  {" \t---"},              // 89
+  {" \t---"},              // 8A
+  {" \t---"},              // 8B
+  {" \t---"},              // 8C
+  {" \t---"},              // 8D
+  {" 2~\tstop"},           // 8E  {5,"STOP",2,0x8E},
+  {" 2~\twait"},           // 8F  {5,"WAIT",2,0x8F},
+  
+  // INH-Addr-Mode: 1-Byte-Inst., no operands
+  {" \t---"},              // 90
+  {" \t---"},              // 91
+  {" \t---"},              // 92
+  {" \t---"},              // 93
+  {" \t---"},              // 94
+  {" \t---"},              // 95
+  {" \t---"},              // 96
+  {" 2~\ttax"},            // 97  {4,"TAX", 2,0x97},
+  {" 2~\tclc"},            // 98  {4,"CLC", 2,0x98},
+  {" 2~\tsec"},            // 99  {4,"SEC", 2,0x99},
+  {" 2~\tcli"},            // 9A  {4,"CLI", 2,0x9A},
+  {" 2~\tsei"},            // 9B  {4,"SEI", 2,0x9B},
+  {" 2~\trsp"},            // 9C  {4,"RSP", 2,0x9C},
+  {" 2~\tnop"},            // 9D  {4,"NOP", 2,0x9D},
+  {" \t---"},              // 9E  
+  {" 2~\ttxa"},            // 9F  {4,"TXA", 2,0x9F},
+             
+  // IMM-Addr-Mode: 2-Byte-Instr. op1={#ii}
+  {"\t 2~\tsub\t#$"},      // A0  {4,"SUB",6,0xA0},
+  {"\t 2~\tcmp\t#$"},      // A1  {4,"CMP",6,0xA1},
+  {"\t 2~\tsbc\t#$"},      // A2  {4,"SBC",6,0xA2},
+  {"\t 2~\tcpx\t#$"},      // A3  {4,"CPX",6,0xA3},
+  {"\t 2~\tand\t#$"},      // A4  {4,"AND",6,0xA4},
+  {"\t 2~\tbit\t#$"},      // A5  {4,"BIT",6,0xA5},
+  {"\t 2~\tlda\t#$"},      // A6  {4,"LDA",6,0xA6},
+  {" \t---"},              // A7  "STA" no #-mode 
+  {"\t 2~\teor\t#$"},      // A8  {4,"EOR",6,0xA8},
+  {"\t 2~\tadc\t#$"},      // A9  {4,"ADC",6,0xA9},
+  {"\t 2~\tora\t#$"},      // AA  {4,"ORA",6,0xAA},
+  {"\t 2~\tadd\t#$"},      // AB  {4,"ADD",6,0xAB},
+  {" \t---"},              // AC  "JSR" no #-mode
+  // REL-Addr-mode: 2-Byte-Instr., op1={rr}
+  {"\t 6~\tbsr\t$"},       // AD  {4,"BSR",3,0xAD},
+  // IMM-Addr-mode: 2-Byte-Instr. op1={#ii}
+  {"\t 2~\tldx\t#$"},      // AE  {4,"LDX",6,0xAE},
+  {" \t---"},              // AF  "STX" no #-mode
+  
+  // DIR-Addr-Mode: 2-Byte-Instr., op1={dd}
+  {"\t 3~\tsub\t$"},       // B0  {4,"SUB",6,0xB0},
+  {"\t 3~\tcmp\t$"},       // B1  {4,"CMP",6,0xB1},
+  {"\t 3~\tsbc\t$"},       // B2  {4,"SBC",6,0xB2},
+  {"\t 3~\tcpx\t$"},       // B3  {4,"CPX",6,0xB3},
+  {"\t 3~\tand\t$"},       // B4  {4,"AND",6,0xB4},
+  {"\t 3~\tbit\t$"},       // B5  {4,"BIT",6,0xB5},
+  {"\t 3~\tlda\t$"},       // B6  {4,"LDA",6,0xB6},
+  {"\t 4~\tsta\t$"},       // B7  {4,"STA",5,0xB7}, 
+  {"\t 3~\teor\t$"},       // B8  {4,"EOR",6,0xB8},
+  {"\t 3~\tadc\t$"},       // B9  {4,"ADC",6,0xB9},
+  {"\t 3~\tora\t$"},       // BA  {4,"ORA",6,0xBA},
+  {"\t 3~\tadd\t$"},       // BB  {4,"ADD",6,0xBB},
+  {"\t 2~\tjmp\t$"},       // BC  {4,"JMP",5,0xBC}, 
+  {"\t 5~\tjsr\t$"},       // BD  {4,"JSR",5,0xBD},
+  {"\t 3~\tldx\t$"},       // BE  {4,"LDX",6,0xBE},
+  {"\t 4~\tstx\t$"},       // BF  {4,"STX",5,0xBF},
+  
+  // EXT-Addr-Mode: 3-Byte-Instr., op1={hh}, op2={ll}
+  {"\t\t 4~\tsub\t$"},     // C0  {4,"SUB",6,0xC0},
+  {"\t\t 4~\tcmp\t$"},     // C1  {4,"CMP",6,0xC1},
+  {"\t\t 4~\tsbc\t$"},     // C2  {4,"SBC",6,0xC2},
+  {"\t\t 4~\tcpx\t$"},     // C3  {4,"CPX",6,0xC3},
+  {"\t\t 4~\tand\t$"},     // C4  {4,"AND",6,0xC4},
+  {"\t\t 4~\tbit\t$"},     // C5  {4,"BIT",6,0xC5},
+  {"\t\t 4~\tlda\t$"},     // C6  {4,"LDA",6,0xC6},
+  {"\t\t 5~\tsta\t$"},     // C7  {4,"STA",5,0xC7}, 
+  {"\t\t 4~\teor\t$"},     // C8  {4,"EOR",6,0xC8},
+  {"\t\t 4~\tadc\t$"},     // C9  {4,"ADC",6,0xC9},
+  {"\t\t 4~\tora\t$"},     // CA  {4,"ORA",6,0xCA},
+  {"\t\t 4~\tadd\t$"},     // CB  {4,"ADD",6,0xCB},
+  {"\t\t 3~\tjmp\t$"},     // CC  {4,"JMP",5,0xCC}, 
+  {"\t\t 6~\tjsr\t$"},     // CD  {4,"JSR",6,0xCD},
+  {"\t\t 4~\tldx\t$"},     // CE  {4,"LDX",6,0xCE},
+  {"\t\t 5~\tstx\t$"},     // CF  {4,"STX",5,0xCF},
+  
+  // IX2-Addr-Mode: 3-Byte-Instr., op1={ee}, op2={ff}
+  {"\t\t 5~\tsub\t$"},     // D0  {4,"SUB",6,0xD0},
+  {"\t\t 5~\tcmp\t$"},     // D1  {4,"CMP",6,0xD1},
+  {"\t\t 5~\tsbc\t$"},     // D2  {4,"SBC",6,0xD2},
+  {"\t\t 5~\tcpx\t$"},     // D3  {4,"CPX",6,0xD3},
+  {"\t\t 5~\tand\t$"},     // D4  {4,"AND",6,0xD4},
+  {"\t\t 5~\tbit\t$"},     // D5  {4,"BIT",6,0xD5},
+  {"\t\t 5~\tlda\t$"},     // D6  {4,"LDA",6,0xD6},
+  {"\t\t 6~\tsta\t$"},     // D7  {4,"STA",5,0xD7}, 
+  {"\t\t 5~\teor\t$"},     // D8  {4,"EOR",6,0xD8},
+  {"\t\t 5~\tadc\t$"},     // D9  {4,"ADC",6,0xD9},
+  {"\t\t 5~\tora\t$"},     // DA  {4,"ORA",6,0xDA},
+  {"\t\t 5~\tadd\t$"},     // DB  {4,"ADD",6,0xDB},
+  {"\t\t 4~\tjmp\t$"},     // DC  {4,"JMP",5,0xDC}, 
+  {"\t\t 7~\tjsr\t$"},     // DD  {4,"JSR",7,0xDD},
+  {"\t\t 5~\tldx\t$"},     // DE  {4,"LDX",6,0xDE},
+  {"\t\t 6~\tstx\t$"},     // DF  {4,"STX",5,0xDF},
+  
+  // IX1-Addr-Mode: 2-Byte-Instr., op1={ff}, op2={X}
+  {"\t 4~\tsub\t$"},       // E0  {4,"SUB",6,0xE0},
+  {"\t 4~\tcmp\t$"},       // E1  {4,"CMP",6,0xE1},
+  {"\t 4~\tsbc\t$"},       // E2  {4,"SBC",6,0xE2},
+  {"\t 4~\tcpx\t$"},       // E3  {4,"CPX",6,0xE3},
+  {"\t 4~\tand\t$"},       // E4  {4,"AND",6,0xE4},
+  {"\t 4~\tbit\t$"},       // E5  {4,"BIT",6,0xE5},
+  {"\t 4~\tlda\t$"},       // E6  {4,"LDA",6,0xE6},
+  {"\t 5~\tsta\t$"},       // E7  {4,"STA",5,0xE7}, 
+  {"\t 4~\teor\t$"},       // E8  {4,"EOR",6,0xE8},
+  {"\t 4~\tadc\t$"},       // E9  {4,"ADC",6,0xE9},
+  {"\t 4~\tora\t$"},       // EA  {4,"ORA",6,0xEA},
+  {"\t 4~\tadd\t$"},       // EB  {4,"ADD",6,0xEB},
+  {"\t 3~\tjmp\t$"},       // EC  {4,"JMP",5,0xEC}, 
+  {"\t 6~\tjsr\t$"},       // ED  {4,"JSR",6,0xED},
+  {"\t 4~\tldx\t$"},       // EE  {4,"LDX",6,0xEE},
+  {"\t 5~\tstx\t$"},       // EF  {4,"STX",5,0xEF},
+  
+  // IX-Addr-Mode: 1-Byte-Instr., no operands
+  {" 3~\tsub\t,x"},        // F0  {4,"SUB",6,0xF0},
+  {" 3~\tcmp\t,x"},        // F1  {4,"CMP",6,0xF1},
+  {" 3~\tsbc\t,x"},        // F2  {4,"SBC",6,0xF2},
+  {" 3~\tcpx\t,x"},        // F3  {4,"CPX",6,0xF3},
+  {" 3~\tand\t,x"},        // F4  {4,"AND",6,0xF4},
+  {" 3~\tbit\t,x"},        // F5  {4,"BIT",6,0xF5},
+  {" 3~\tlda\t,x"},        // F6  {4,"LDA",6,0xF6},
+  {" 4~\tsta\t,x"},        // F7  {4,"STA",5,0xF7}, 
+  {" 3~\teor\t,x"},        // F8  {4,"EOR",6,0xF8},
+  {" 3~\tadc\t,x"},        // F9  {4,"ADC",6,0xF9},
+  {" 3~\tora\t,x"},        // FA  {4,"ORA",6,0xFA},
+  {" 3~\tadd\t,x"},        // FB  {4,"ADD",6,0xFB},
+  {" 2~\tjmp\t,x"},        // FC  {4,"JMP",5,0xFC}, 
+  {" 5~\tjsr\t,x"},        // FD  {4,"JSR",6,0xFD},
+  {" 3~\tldx\t,x"},        // FE  {4,"LDX",6,0xFE},
+  {" 4~\tstx\t,x"},        // FF  {4,"STX",5,0xFF},
+  }; // //  end-of-table _mnemonic68O5[]
+
+// --------------------------------------------
+// Motorola M68HC05 Family mnemonic names
+// --------------------------------------------
+// Indexed by MNE_xxx (dasm6805.h)
+//
+extern constexpr const char* const mneName[MNE_COUNT] = {
+  "---",
+  "brset", "brclr", "bset",  "bclr",
+  "bra",   "brn",   "bhi",   "bls",   "bcc",   "bcs",
+  "bne",   "beq",   "bhcc",  "bhcs",  "bpl",   "bmi",
+  "bmc",   "bms",   "bil",   "bih",
+  "neg",   "com",   "lsr",   "ror",   "asr",   "lsl",
+  "rol",   "dec",   "inc",   "tst",   "clr",
+  "nega",  "coma",  "lsra",  "rora",  "asra",  "lsla",
+  "rola",  "deca",  "inca",  "tsta",  "clra",
+  "negx",  "comx",  "lsrx",  "rorx",  "asrx",  "lslx",
+  "rolx",  "decx",  "incx",  "tstx",  "clrx",
+  "mul",   "rti",   "rts",   "swi",   "stop",  "wait",
+  "tax",   "clc",   "sec",   "cli",   "sei",   "rsp",
+  "nop",   "txa",   "bsr",
+  "sub",   "cmp",   "sbc",   "cpx",   "and",   "bit",
+  "lda",   "sta",   "eor",   "adc",   "ora",   "add",
+  "jmp",   "jsr",   "ldx",   "stx",
+
+  // M68HC08
+  "ais",   "aix",   "bge",   "blt",   "bgt",   "ble",
+  "cbeq",  "cbeqa", "cbeqx", "clrh",  "cphx",  "daa",
+  "dbnz",  "dbnza", "dbnzx", "div",   "ldhx",  "mov",
+  "nsa",   "psha",  "pshh",  "pshx",  "pula",  "pulh",
+  "pulx",  "sthx",  "tap",   "tpa",   "tsx",   "txs",
+
+  // M68HC11
+  "negb",  "comb",  "lsrb",  "rorb",  "asrb",  "lslb",
+  "rolb",  "decb",  "incb",  "tstb",  "clrb",
+  "suba",  "cmpa",  "sbca",  "anda",  "bita",  "ldaa",
+  "staa",  "eora",  "adca",  "oraa",  "adda",
+  "subb",  "cmpb",  "sbcb",  "andb",  "bitb",  "ldab",
+  "stab",  "eorb",  "adcb",  "orab",  "addb",
+  "aba",   "abx",   "aby",   "addd",  "bvc",   "bvs",
+  "cba",   "clv",   "cpd",   "cpy",   "des",   "dex",
+  "dey",   "fdiv",  "idiv",  "ins",   "inx",   "iny",
+  "ldd",   "lds",   "ldy",   "lsld",  "lsrd",  "pshb",
+  "pshy",  "pulb",  "puly",  "sba",   "sev",   "std",
+  "sts",   "sty",   "subd",  "tab",   "tba",   "tsy",
+  "tys",   "wai",   "xgdx",  "xgdy",
+  }; // end-of-table mneName[]
+
+// --------------------------------------------
+// Addressing mode names (JSON lines, statistics)
+// --------------------------------------------
+// Indexed by AM_xxx (dasm6805.h)
+//
+extern constexpr const char* const modeName[AM_COUNT] = {
+  "ill",  "inh",   "imm",    "dir",    "ext",     "rel",    "ix",    "ix1",
+  "ix2",  "bsc",   "btb",    "imm16",  "sp1",     "sp2",    "dd",    "imd",
+  "dixp", "ixpd",  "drel",   "irel",   "ixrel",   "ixprel", "ix1rel", "ix1prel",
+  "sp1rel", "iy1", "bscm",   "bscx",   "bscy",    "btbm",   "btbx",  "btby"
+  }; // end-of-table modeName[]
+
+static_assert(MNE_COUNT <= 256 && AM_COUNT <= 256, "DASMINSN.mne, .mode are bytes");
+static_assert(mneName[MNE_CLRB][3] == 'b' && mneName[MNE_XGDY][3] == 'y', "mneName[] order");
+static_assert(modeName[AM_IMM16][3] == '1' && modeName[AM_BTBY][3] == 'y', "modeName[] order");
+
+// --------------------------------------------
+// Opcode map columns (low nibble of opcode)
+// --------------------------------------------
+// Rows 0x20: relative branches
+constexpr unsigned char mneRel[16] = {
+  MNE_BRA,  MNE_BRN,  MNE_BHI,  MNE_BLS,  MNE_BCC,  MNE_BCS,  MNE_BNE,  MNE_BEQ,
+  MNE_BHCC, MNE_BHCS, MNE_BPL,  MNE_BMI,  MNE_BMC,  MNE_BMS,  MNE_BIL,  MNE_BIH
+  };
+
+// Rows 0x30..0x70: read-modify-write (memory variant, +ROW_A/ROW_X for a/x)
+constexpr unsigned char mneRmw[16] = {
+  MNE_NEG,  MNE_ILL,  MNE_ILL,  MNE_COM,  MNE_LSR,  MNE_ILL,  MNE_ROR,  MNE_ASR,
+  MNE_LSL,  MNE_ROL,  MNE_DEC,  MNE_ILL,  MNE_INC,  MNE_TST,  MNE_ILL,  MNE_CLR
+  };
+#define ROW_A  (MNE_NEGA - MNE_NEG)
+#define ROW_X  (MNE_NEGX - MNE_NEG)
+
+// Rows 0x80..0x90: control
+constexpr unsigned char mneCtl[32] = {
+  MNE_RTI,  MNE_RTS,  MNE_ILL,  MNE_SWI,  MNE_ILL,  MNE_ILL,  MNE_ILL,  MNE_ILL,
+  MNE_ILL,  MNE_ILL,  MNE_ILL,  MNE_ILL,  MNE_ILL,  MNE_ILL,  MNE_STOP, MNE_WAIT,
+  MNE_ILL,  MNE_ILL,  MNE_ILL,  MNE_ILL,  MNE_ILL,  MNE_ILL,  MNE_ILL,  MNE_TAX,
+  MNE_CLC,  MNE_SEC,  MNE_CLI,  MNE_SEI,  MNE_RSP,  MNE_NOP,  MNE_ILL,  MNE_TXA
+  };
+constexpr unsigned char cycCtl[32] = {
+   9,  6,  0, 10,  0,  0,  0,  0,  0,  0,  0,  0,  0,  0,  2,  2,
+   0,  0,  0,  0,  0,  0,  0,  2,  2,  2,  2,  2,  2,  2,  0,  2
+  };
+
+// Rows 0xA0..0xF0: register/memory
+constexpr unsigned char mneReg[16] = {
+  MNE_SUB,  MNE_CMP,  MNE_SBC,  MNE_CPX,  MNE_AND,  MNE_BIT,  MNE_LDA,  MNE_STA,
+  MNE_EOR,  MNE_ADC,  MNE_ORA,  MNE_ADD,  MNE_JMP,  MNE_JSR,  MNE_LDX,  MNE_STX
+  };
+
+//-----------------------------------------------------------------------------
+//
+//                          MakeOpDesc
+//
+// Compile time generator of the opcode descriptor for opcode 'op',
+// derived from the regular row/column layout of the M68HC05 opcode map.
+//
+constexpr OPDESC MakeOpDesc(int op)
+  {
+  int row = op >> 4, col = op & 0x0F, mne = MNE_ILL, cyc = 0;
+
+  switch (row)
+    {
+    case 0x0:   // DIR: brset/brclr n,dd,rr
+      return {3, AM_BTB, 5, (unsigned char)(col & 1 ? MNE_BRCLR : MNE_BRSET), FC_BRANCH};
+    case 0x1:   // DIR: bset/bclr n,dd
+      return {2, AM_BSC, 5, (unsigned char)(col & 1 ? MNE_BCLR : MNE_BSET), FC_NEXT};
+    case 0x2:   // REL: bra, bcc, ..
+      return {2, AM_REL, 3, mneRel[col], (unsigned char)(col == 0 ? FC_JUMP : FC_BRANCH)};
+
+    case 0x3: case 0x4: case 0x5: case 0x6: case 0x7:
+      mne = mneRmw[col];
+      if (op == 0x42) return {1, AM_INH, 11, MNE_MUL, FC_NEXT};
+      if (mne == MNE_ILL) break;
+      cyc = (mne == MNE_TST) ? -1 : 0;
+      if (row == 0x3) return {2, AM_DIR, (unsigned char)(5+cyc), (unsigned char)mne, FC_NEXT};
+      if (row == 0x4) return {1, AM_INH, 3, (unsigned char)(mne+ROW_A), FC_NEXT};
+      if (row == 0x5) return {1, AM_INH, 3, (unsigned char)(mne+ROW_X), FC_NEXT};
+      if (row == 0x6) return {2, AM_IX1, (unsigned char)(6+cyc), (unsigned char)mne, FC_NEXT};
+      return {1, AM_IX, (unsigned char)(5+cyc), (unsigned char)mne, FC_NEXT};
+
+    case 0x8: case 0x9:
+      mne = mneCtl[op - 0x80];
+      if (mne == MNE_ILL) break;
+      return {1, AM_INH, cycCtl[op - 0x80], (unsigned char)mne,
+              (unsigned char)(mne == MNE_RTI || mne == MNE_RTS ? FC_RET : FC_NEXT)};
+
+    default:    // 0xA..0xF
+      mne = mneReg[col];
+      if (op == 0xAD) return {2, AM_REL, 6, MNE_BSR, FC_CALL};
+      if (row == 0xA && (mne == MNE_STA || mne == MNE_JMP || mne == MNE_JSR || mne == MNE_STX))
+        break;                                  // no #-mode
+      if (row == 0xA) return {2, AM_IMM, 2, (unsigned char)mne, FC_NEXT};
+
+      cyc = (row == 0xB || row == 0xF) ? 3 : (row == 0xD) ? 5 : 4;
+      if (mne == MNE_STA || mne == MNE_STX) cyc += 1;
+      else if (mne == MNE_JMP) cyc -= 1;
+      else if (mne == MNE_JSR) cyc += 2;
+      return {(unsigned char)(row == 0xF ? 1 : (row == 0xC || row == 0xD) ? 3 : 2),
+              (unsigned char)(row == 0xB ? AM_DIR : row == 0xC ? AM_EXT : row == 0xD ? AM_IX2 :
+                              row == 0xE ? AM_IX1 : AM_IX),
+              (unsigned char)cyc, (unsigned char)mne,
+              (unsigned char)(mne == MNE_JMP ? FC_JUMP : mne == MNE_JSR ? FC_CALL : FC_NEXT)};
+    } // end switch
+
+  return {1, AM_ILL, 0, MNE_ILL, FC_ILL};
+  } // MakeOpDesc
+
+#define OPROW(r) MakeOpDesc(r+0x0), MakeOpDesc(r+0x1), MakeOpDesc(r+0x2), MakeOpDesc(r+0x3), \
+                 MakeOpDesc(r+0x4), MakeOpDesc(r+0x5), MakeOpDesc(r+0x6), MakeOpDesc(r+0x7), \
+                 MakeOpDesc(r+0x8), MakeOpDesc(r+0x9), MakeOpDesc(r+0xA), MakeOpDesc(r+0xB), \
+                 MakeOpDesc(r+0xC), MakeOpDesc(r+0xD), MakeOpDesc(r+0xE), MakeOpDesc(r+0xF)
+
+// --------------------------------------------
+// Motorola M68HC05 Family opcode descriptors
+// --------------------------------------------
+extern constexpr OPDESC opDesc6805[256] = {
+  OPROW(0x00), OPROW(0x10), OPROW(0x20), OPROW(0x30),
+  OPROW(0x40), OPROW(0x50), OPROW(0x60), OPROW(0x70),
+  OPROW(0x80), OPROW(0x90), OPROW(0xA0), OPROW(0xB0),
+  OPROW(0xC0), OPROW(0xD0), OPROW(0xE0), OPROW(0xF0),
+  }; // end-of-table opDesc6805[]
+
+//-----------------------------------------------------------------------------
+//
+//                          CheckMnemonic
+//
+// Compile time check of the listing text mnemonic6805[op] against the
+// generated descriptor opDesc6805[op]: leading TABs (= length-1), cycle
+// count " n~", mnemonic name and the operand prefix of the addressing mode.
+//
+constexpr bool StrMatch(const char* s, const char* t)
+  {
+  while (*t) if (*s++ != *t++) return false;
+  return true;
+  } // StrMatch
+
+constexpr bool CheckMnemonic(int op)
+  {
+  const char* s = mnemonic6805[op].mneStr;
+  OPDESC d = opDesc6805[op];
+  int n = 0;
+
+  if (d.mode == AM_ILL) return StrMatch(s, " \t---") && s[5] == 0;
+
+  for (n=0; n<d.len-1; n++) if (*s++ != '\t') return false;
+  if (*s++ != (d.cycles >= 10 ? '0' + d.cycles/10 : SPACE)) return false;
+  if (*s++ != '0' + d.cycles%10 || *s++ != '~' || *s++ != '\t') return false;
+  if (!StrMatch(s, mneName[d.mne])) return false;
+  for (n=0; mneName[d.mne][n]; n++) s++;
+
+  switch (d.mode)
+    {
+    case AM_INH: return *s == 0;
+    case AM_IMM: return StrMatch(s, "\t#$") && s[3] == 0;
+    case AM_IX:  return StrMatch(s, "\t,x") && s[3] == 0;
+    case AM_BSC:
+    case AM_BTB: return s[0] == '\t' && s[1] == '0' + ((op >> 1) & 7) && StrMatch(&s[2], ",$") && s[4] == 0;
+    default:     return StrMatch(s, "\t$") && s[2] == 0;
+    }
+  } // CheckMnemonic
+
+constexpr bool CheckOpTable()
+  {
+  for (int op=0; op<256; op++) if (!CheckMnemonic(op)) return false;
+  return true;
+  } // CheckOpTable
+
+static_assert(sizeof(mnemonic6805)/sizeof(mnemonic6805[0]) == 256, "mnemonic6805[] must have 256 rows");
+static_assert(CheckOpTable(), "mnemonic6805[] does not match opDesc6805[]");
+static_assert(opDesc6805[0xA2].mne == MNE_SBC && opDesc6805[0xA3].mne == MNE_CPX, "A2/A3 sbc/cpx");
+static_assert(opDesc6805[0xBD].mne == MNE_JSR && opDesc6805[0xBE].mne == MNE_LDX, "BD/BE jsr/ldx");
+static_assert(opDesc6805[0xAD].mode == AM_REL && opDesc6805[0xAD].flow == FC_CALL, "AD bsr rr");
+static_assert(opDesc6805[0xDD].cycles == 7 && opDesc6805[0x42].cycles == 11, "cycle counts");
+
+//-----------------------------------------------------------------------------
+//
+//                          MakeOpText
+//
+// Compile time generator of the listing text of the descriptor 'd'
+// (opcode 'op') in the format of mnemonic6805[]: the TABs after the
+// opcode bytes, cycles, mnemonic and the constant start of the operand
+// (DasmRender appends the rest). A 4 or 5 byte instruction leaves room
+// for one TAB only.
+//
+constexpr OPTEXT MakeOpText(OPDESC d, int op)
+  {
+  OPTEXT t = {};
+  const char* m = mneName[d.mne];
+  const char* o = "\t$";
+  int n = 0, k = 0;
+
+  if (d.mode == AM_ILL) o = " \t---";
+  else
+    {
+    for (k=0; k<(d.len <= 3 ? d.len-1 : 1); k++) t.s[n++] = '\t';
+    t.s[n++] = (char)(d.cycles >= 10 ? '0' + d.cycles/10 : SPACE);
+    t.s[n++] = (char)('0' + d.cycles%10);
+    t.s[n++] = '~';
+    t.s[n++] = '\t';
+    while (*m) t.s[n++] = *m++;
+
+    switch (d.mode)
+      {
+      case AM_INH:    o = ""; break;
+      case AM_IMM:
+      case AM_IMM16:
+      case AM_IMD:
+      case AM_IREL:   o = "\t#$"; break;
+      case AM_IX:     o = "\t,x"; break;
+      case AM_IXREL:  o = "\t,x,"; break;
+      case AM_IXPREL: o = "\t,x+,"; break;
+      case AM_IXPD:   o = "\tx+,$"; break;
+      case AM_BSC:
+      case AM_BTB:    t.s[n++] = '\t';
+                      t.s[n++] = (char)('0' + ((op >> 1) & 7));
+                      o = ",$";
+                      break;
+      }
+    }
+  while (*o) t.s[n++] = *o++;
+  return t;
+  } // MakeOpText
+
+constexpr bool CheckOpText()
+  {
+  for (int op=0; op<256; op++)
+    {
+    OPTEXT t = MakeOpText(opDesc6805[op], op);
+    if (!StrMatch(mnemonic6805[op].mneStr, t.s) || !StrMatch(t.s, mnemonic6805[op].mneStr)) return false;
+    }
+  return true;
+  } // CheckOpText
+
+static_assert(CheckOpText(), "MakeOpText() does not match mnemonic6805[]");
+
+#define OPROWP(f,p,r) f(p,r+0x0), f(p,r+0x1), f(p,r+0x2), f(p,r+0x3), f(p,r+0x4), f(p,r+0x5), \
+                      f(p,r+0x6), f(p,r+0x7), f(p,r+0x8), f(p,r+0x9), f(p,r+0xA), f(p,r+0xB), \
+                      f(p,r+0xC), f(p,r+0xD), f(p,r+0xE), f(p,r+0xF)
+#define OPPAGE(f,p)   {OPROWP(f,p,0x00), OPROWP(f,p,0x10), OPROWP(f,p,0x20), OPROWP(f,p,0x30), \
+                       OPROWP(f,p,0x40), OPROWP(f,p,0x50), OPROWP(f,p,0x60), OPROWP(f,p,0x70), \
+                       OPROWP(f,p,0x80), OPROWP(f,p,0x90), OPROWP(f,p,0xA0), OPROWP(f,p,0xB0), \
+                       OPROWP(f,p,0xC0), OPROWP(f,p,0xD0), OPROWP(f,p,0xE0), OPROWP(f,p,0xF0)}
+
+#define OPILL   {1, AM_ILL, 0, MNE_ILL, FC_ILL}
+#define OPPRE   {2, AM_ILL, 0, MNE_ILL, FC_ILL}   // Prefix byte, cut off
+
+// --------------------------------------------
+// Motorola M68HC08 Family
+// --------------------------------------------
+// The M68HC05 opcode map with the holes filled (cbeq, dbnz, mov, ldhx,
+// stack operations, ..), other cycle counts, and the prefix $9E: page 1
+// has the stack pointer variants of the indexed rows 6, D and E.
+//
+typedef struct tag_OPSPEC {
+  unsigned char op;
+  OPDESC d;
+} OPSPEC;
+
+constexpr OPSPEC opSpecHC08[] = {
+  {0x31, {3, AM_DREL,    5, MNE_CBEQ,  FC_BRANCH}},
+  {0x35, {2, AM_DIR,     4, MNE_STHX,  FC_NEXT}},
+  {0x3B, {3, AM_DREL,    5, MNE_DBNZ,  FC_BRANCH}},
+  {0x41, {3, AM_IREL,    4, MNE_CBEQA, FC_BRANCH}},
+  {0x42, {1, AM_INH,     5, MNE_MUL,   FC_NEXT}},
+  {0x45, {3, AM_IMM16,   3, MNE_LDHX,  FC_NEXT}},
+  {0x4B, {2, AM_REL,     3, MNE_DBNZA, FC_BRANCH}},
+  {0x4E, {3, AM_DD,      5, MNE_MOV,   FC_NEXT}},
+  {0x51, {3, AM_IREL,    4, MNE_CBEQX, FC_BRANCH}},
+  {0x52, {1, AM_INH,     7, MNE_DIV,   FC_NEXT}},
+  {0x55, {2, AM_DIR,     4, MNE_LDHX,  FC_NEXT}},
+  {0x5B, {2, AM_REL,     3, MNE_DBNZX, FC_BRANCH}},
+  {0x5E, {2, AM_DIXP,    4, MNE_MOV,   FC_NEXT}},
+  {0x61, {3, AM_IX1PREL, 5, MNE_CBEQ,  FC_BRANCH}},
+  {0x62, {1, AM_INH,     3, MNE_NSA,   FC_NEXT}},
+  {0x65, {3, AM_IMM16,   3, MNE_CPHX,  FC_NEXT}},
+  {0x6B, {3, AM_IX1REL,  5, MNE_DBNZ,  FC_BRANCH}},
+  {0x6E, {3, AM_IMD,     4, MNE_MOV,   FC_NEXT}},
+  {0x71, {2, AM_IXPREL,  4, MNE_CBEQ,  FC_BRANCH}},
+  {0x72, {1, AM_INH,     2, MNE_DAA,   FC_NEXT}},
+  {0x75, {2, AM_DIR,     4, MNE_CPHX,  FC_NEXT}},
+  {0x7B, {2, AM_IXREL,   4, MNE_DBNZ,  FC_BRANCH}},
+  {0x7E, {2, AM_IXPD,    4, MNE_MOV,   FC_NEXT}},
+  {0x9E, OPPRE},
+  {0xA7, {2, AM_IMM,     2, MNE_AIS,   FC_NEXT}},
+  {0xAC, OPILL},
+  {0xAD, {2, AM_REL,     4, MNE_BSR,   FC_CALL}},
+  {0xAF, {2, AM_IMM,     2, MNE_AIX,   FC_NEXT}},
+  };
+
+// Rows 0x80..0x90: control, the signed branches
+constexpr unsigned char mneCtl08[32] = {
+  MNE_RTI,  MNE_RTS,  MNE_ILL,  MNE_SWI,  MNE_TAP,  MNE_TPA,  MNE_PULA, MNE_PSHA,
+  MNE_PULX, MNE_PSHX, MNE_PULH, MNE_PSHH, MNE_CLRH, MNE_ILL,  MNE_STOP, MNE_WAIT,
+  MNE_BGE,  MNE_BLT,  MNE_BGT,  MNE_BLE,  MNE_TXS,  MNE_TSX,  MNE_ILL,  MNE_TAX,
+  MNE_CLC,  MNE_SEC,  MNE_CLI,  MNE_SEI,  MNE_RSP,  MNE_NOP,  MNE_ILL,  MNE_TXA
+  };
+constexpr unsigned char cycCtl08[32] = {
+   7,  4,  0,  9,  2,  1,  2,  2,  2,  2,  2,  2,  1,  0,  1,  1,
+   3,  3,  3,  3,  2,  2,  0,  1,  1,  1,  2,  2,  1,  1,  0,  1
+  };
+
+//-----------------------------------------------------------------------------
+//
+//                          MakeOpDesc08
+//
+// Compile time generator of the M68HC08 descriptor of opcode 'op' on
+// page 'page' (0: no prefix, 1: prefix $9E).
+//
+constexpr OPDESC MakeOpDesc08(int page, int op)
+  {
+  int row = op >> 4, col = op & 0x0F, mne = MNE_ILL, cyc = 0;
+  unsigned k = 0;
+
+  if (page == 1)                                // $9E: stack pointer
+    {
+    if (row == 0x6)
+      {
+      if (col == 0x1) return {4, AM_SP1REL, 6, MNE_CBEQ, FC_BRANCH};
+      if (col == 0xB) return {4, AM_SP1REL, 6, MNE_DBNZ, FC_BRANCH};
+      if ((mne = mneRmw[col]) == MNE_ILL) return OPILL;
+      return {3, AM_SP1, (unsigned char)(mne == MNE_TST || mne == MNE_CLR ? 4 : 5), (unsigned char)mne, FC_NEXT};
+      }
+    mne = mneReg[col];
+    if ((row != 0xD && row != 0xE) || mne == MNE_JMP || mne == MNE_JSR) return OPILL;
+    return row == 0xD ? OPDESC{4, AM_SP2, 5, (unsigned char)mne, FC_NEXT}
+                      : OPDESC{3, AM_SP1, 4, (unsigned char)mne, FC_NEXT};
+    }
+
+  for (k=0; k<sizeof(opSpecHC08)/sizeof(opSpecHC08[0]); k++)
+    if (opSpecHC08[k].op == op) return opSpecHC08[k].d;
+
+  switch (row)
+    {
+    case 0x0:   // DIR: brset/brclr n,dd,rr
+      return {3, AM_BTB, 5, (unsigned char)(col & 1 ? MNE_BRCLR : MNE_BRSET), FC_BRANCH};
+    case 0x1:   // DIR: bset/bclr n,dd
+      return {2, AM_BSC, 4, (unsigned char)(col & 1 ? MNE_BCLR : MNE_BSET), FC_NEXT};
+    case 0x2:   // REL: bra, bcc, ..
+      return {2, AM_REL, 3, mneRel[col], (unsigned char)(col == 0 ? FC_JUMP : FC_BRANCH)};
+
+    case 0x3: case 0x4: case 0x5: case 0x6: case 0x7:
+      if ((mne = mneRmw[col]) == MNE_ILL) break;
+      cyc = (mne == MNE_TST || mne == MNE_CLR) ? -1 : 0;
+      if (row == 0x3) return {2, AM_DIR, (unsigned char)(4+cyc), (unsigned char)mne, FC_NEXT};
+      if (row == 0x4) return {1, AM_INH, 1, (unsigned char)(mne+ROW_A), FC_NEXT};
+      if (row == 0x5) return {1, AM_INH, 1, (unsigned char)(mne+ROW_X), FC_NEXT};
+      if (row == 0x6) return {2, AM_IX1, (unsigned char)(4+cyc), (unsigned char)mne, FC_NEXT};
+      return {1, AM_IX, (unsigned char)(3+cyc), (unsigned char)mne, FC_NEXT};
+
+    case 0x8: case 0x9:
+      if ((mne = mneCtl08[op - 0x80]) == MNE_ILL) break;
+      if (row == 0x9 && col < 4) return {2, AM_REL, 3, (unsigned char)mne, FC_BRANCH};
+      return {1, AM_INH, cycCtl08[op - 0x80], (unsigned char)mne,
+              (unsigned char)(mne == MNE_RTI || mne == MNE_RTS ? FC_RET : FC_NEXT)};
+
+    default:    // 0xA..0xF
+      mne = mneReg[col];
+      if (row == 0xA) return {2, AM_IMM, 2, (unsigned char)mne, FC_NEXT};
+
+      cyc = (row == 0xB || row == 0xE) ? 3 : (row == 0xF) ? 2 : 4;
+      if (mne == MNE_JMP) cyc = (row == 0xB || row == 0xF) ? 2 : (row == 0xD) ? 4 : 3;
+      else if (mne == MNE_JSR) cyc = (row == 0xB || row == 0xF) ? 4 : (row == 0xD) ? 6 : 5;
+      return {(unsigned char)(row == 0xF ? 1 : (row == 0xC || row == 0xD) ? 3 : 2),
+              (unsigned char)(row == 0xB ? AM_DIR : row == 0xC ? AM_EXT : row == 0xD ? AM_IX2 :
+                              row == 0xE ? AM_IX1 : AM_IX),
+              (unsigned char)cyc, (unsigned char)mne,
+              (unsigned char)(mne == MNE_JMP ? FC_JUMP : mne == MNE_JSR ? FC_CALL : FC_NEXT)};
+    } // end switch
+
+  return OPILL;
+  } // MakeOpDesc08
+
+extern constexpr OPDESC opDescHC08[2][256] = {OPPAGE(MakeOpDesc08, 0), OPPAGE(MakeOpDesc08, 1)};
+
+constexpr OPTEXT MakeOpText08(int page, int op) { return MakeOpText(opDescHC08[page][op], op); }
+extern constexpr OPTEXT opTextHC08[2][256] = {OPPAGE(MakeOpText08, 0), OPPAGE(MakeOpText08, 1)};
+
+static_assert(opDescHC08[0][0x45].len == 3 && opDescHC08[0][0x45].mode == AM_IMM16, "45 ldhx #");
+static_assert(opDescHC08[0][0x9E].len == 2 && opDescHC08[0][0x91].mne == MNE_BLT, "9E prefix, 91 blt");
+static_assert(opDescHC08[1][0xD6].len == 4 && opDescHC08[1][0xE7].mode == AM_SP1, "9ED6 lda ee ff,sp");
+static_assert(opDescHC08[0][0xBD].cycles == 4 && opDescHC08[0][0x81].cycles == 4, "cycle counts");
+
+// --------------------------------------------
+// Motorola M68HC11 Family
+// --------------------------------------------
+// Accumulators A, B (D = A:B) and the index registers X, Y. The
+// prebyte $18 selects the Y variant of an X instruction (page 1),
+// $1A the cpd and the X indexed cpy, ldy, sty (page 2), $CD the Y
+// indexed cpd, cpx, ldx, stx (page 3). Each prebyte adds one cycle.
+//
+// Rows 0x00, 0x10, 0x30: inherent (00 test is for the test modes only)
+constexpr unsigned char mneInh11[48] = {
+  MNE_ILL,  MNE_NOP,  MNE_IDIV, MNE_FDIV, MNE_LSRD, MNE_LSLD, MNE_TAP,  MNE_TPA,
+  MNE_INX,  MNE_DEX,  MNE_CLV,  MNE_SEV,  MNE_CLC,  MNE_SEC,  MNE_CLI,  MNE_SEI,
+  MNE_SBA,  MNE_CBA,  MNE_ILL,  MNE_ILL,  MNE_ILL,  MNE_ILL,  MNE_TAB,  MNE_TBA,
+  MNE_ILL,  MNE_DAA,  MNE_ILL,  MNE_ABA,  MNE_ILL,  MNE_ILL,  MNE_ILL,  MNE_ILL,
+  MNE_TSX,  MNE_INS,  MNE_PULA, MNE_PULB, MNE_DES,  MNE_TXS,  MNE_PSHA, MNE_PSHB,
+  MNE_PULX, MNE_RTS,  MNE_ABX,  MNE_RTI,  MNE_PSHX, MNE_MUL,  MNE_WAI,  MNE_SWI
+  };
+constexpr unsigned char cycInh11[48] = {
+   0,  2, 41, 41,  3,  3,  2,  2,  3,  3,  2,  2,  2,  2,  2,  2,
+   2,  2,  0,  0,  0,  0,  2,  2,  0,  2,  0,  2,  0,  0,  0,  0,
+   3,  3,  4,  4,  3,  3,  3,  3,  5,  5,  3, 12,  4, 10, 14, 14
+  };
+
+// Row 0x20: relative branches
+constexpr unsigned char mneRel11[16] = {
+  MNE_BRA,  MNE_BRN,  MNE_BHI,  MNE_BLS,  MNE_BCC,  MNE_BCS,  MNE_BNE,  MNE_BEQ,
+  MNE_BVC,  MNE_BVS,  MNE_BPL,  MNE_BMI,  MNE_BGE,  MNE_BLT,  MNE_BGT,  MNE_BLE
+  };
+
+// Rows 0x80..0xB0 accumulator A, 0xC0..0xF0 accumulator B
+constexpr unsigned char mneAcc11[32] = {
+  MNE_SUBA, MNE_CMPA, MNE_SBCA, MNE_SUBD, MNE_ANDA, MNE_BITA, MNE_LDAA, MNE_STAA,
+  MNE_EORA, MNE_ADCA, MNE_ORAA, MNE_ADDA, MNE_CPX,  MNE_JSR,  MNE_LDS,  MNE_STS,
+  MNE_SUBB, MNE_CMPB, MNE_SBCB, MNE_ADDD, MNE_ANDB, MNE_BITB, MNE_LDAB, MNE_STAB,
+  MNE_EORB, MNE_ADCB, MNE_ORAB, MNE_ADDB, MNE_LDD,  MNE_STD,  MNE_LDX,  MNE_STX
+  };
+#define ROW_B  (MNE_NEGB - MNE_NEG)
+
+// X instruction and its Y variant
+constexpr unsigned char mneXY11[][2] = {
+  {MNE_INX,  MNE_INY},  {MNE_DEX,  MNE_DEY},  {MNE_TSX,  MNE_TSY},  {MNE_TXS,  MNE_TYS},
+  {MNE_PULX, MNE_PULY}, {MNE_PSHX, MNE_PSHY}, {MNE_ABX,  MNE_ABY},  {MNE_XGDX, MNE_XGDY},
+  {MNE_CPX,  MNE_CPY},  {MNE_LDX,  MNE_LDY},  {MNE_STX,  MNE_STY},
+  };
+
+//-----------------------------------------------------------------------------
+//
+//                          MakeOpDesc11
+//
+// Compile time generator of the M68HC11 descriptor of opcode 'op' on
+// page 'page' (0: no prebyte, 1: $18, 2: $1A, 3: $CD). The prebyte
+// pages are derived from page 0.
+//
+constexpr OPDESC MakeOpDesc11(int page, int op)
+  {
+  int row = op >> 4, col = op & 0x0F, mne = MNE_ILL, cyc = 0;
+  unsigned k = 0;
+  OPDESC d = OPILL;
+
+  if (page)
+    {
+    d = MakeOpDesc11(0, op);
+    if (d.mode == AM_ILL) return OPILL;
+    if (page == 1)                              // $18: Y for X
+      {
+      k = d.mne;
+      for (cyc=0; cyc<(int)(sizeof(mneXY11)/sizeof(mneXY11[0])); cyc++)
+        if (mneXY11[cyc][0] == d.mne) d.mne = mneXY11[cyc][1];
+      if (d.mode == AM_IX1) d.mode = AM_IY1;
+      else if (d.mode == AM_BSCX) d.mode = AM_BSCY;
+      else if (d.mode == AM_BTBX) d.mode = AM_BTBY;
+      else if (d.mne == k) return OPILL;        // Neither X register nor ,x
+      }
+    else if (page == 2)                         // $1A: cpd, cpy ff,x, ldy ff,x, sty ff,x
+      {
+      if (d.mne == MNE_SUBD) d.mne = MNE_CPD;
+      else if (d.mode == AM_IX1 && d.mne == MNE_CPX) d.mne = MNE_CPY;
+      else if (d.mode == AM_IX1 && d.mne == MNE_LDX) d.mne = MNE_LDY;
+      else if (d.mode == AM_IX1 && d.mne == MNE_STX) d.mne = MNE_STY;
+      else return OPILL;
+      }
+    else                                        // $CD: cpd, cpx, ldx, stx ff,y
+      {
+      if (d.mode != AM_IX1 || (op != 0xA3 && op != 0xAC && op != 0xEE && op != 0xEF)) return OPILL;
+      if (d.mne == MNE_SUBD) d.mne = MNE_CPD;
+      d.mode = AM_IY1;
+      }
+    d.len++;
+    d.cycles++;
+    return d;
+    }
+
+  switch (row)
+    {
+    case 0x0: case 0x1: case 0x3:
+      switch (op)
+        {
+        case 0x12: case 0x13:                   // brset/brclr dd,#mm,rr
+          return {4, AM_BTBM, 6, (unsigned char)(col & 1 ? MNE_BRCLR : MNE_BRSET), FC_BRANCH};
+        case 0x14: case 0x15:                   // bset/bclr dd,#mm
+          return {3, AM_BSCM, 6, (unsigned char)(col & 1 ? MNE_BCLR : MNE_BSET), FC_NEXT};
+        case 0x1C: case 0x1D:                   // bset/bclr ff,x,#mm
+          return {3, AM_BSCX, 7, (unsigned char)(col & 1 ? MNE_BCLR : MNE_BSET), FC_NEXT};
+        case 0x1E: case 0x1F:                   // brset/brclr ff,x,#mm,rr
+          return {4, AM_BTBX, 7, (unsigned char)(col & 1 ? MNE_BRCLR : MNE_BRSET), FC_BRANCH};
+        case 0x18: case 0x1A:
+          return OPPRE;
+        }
+      k = (row == 0x3 ? 32 : 16*row) + col;
+      if ((mne = mneInh11[k]) == MNE_ILL) break;
+      return {1, AM_INH, cycInh11[k], (unsigned char)mne,
+              (unsigned char)(mne == MNE_RTI || mne == MNE_RTS ? FC_RET : FC_NEXT)};
+
+    case 0x2:   // REL: bra, bcc, ..
+      return {2, AM_REL, 3, mneRel11[col], (unsigned char)(col == 0 ? FC_JUMP : FC_BRANCH)};
+
+    case 0x4: case 0x5: case 0x6: case 0x7:
+      if (op == 0x6E || op == 0x7E)             // jmp ff,x / hhll
+        return {(unsigned char)(row == 0x6 ? 2 : 3), (unsigned char)(row == 0x6 ? AM_IX1 : AM_EXT), 3, MNE_JMP, FC_JUMP};
+      if ((mne = mneRmw[col]) == MNE_ILL) break;
+      if (row == 0x4) return {1, AM_INH, 2, (unsigned char)(mne+ROW_A), FC_NEXT};
+      if (row == 0x5) return {1, AM_INH, 2, (unsigned char)(mne+ROW_B), FC_NEXT};
+      return {(unsigned char)(row == 0x6 ? 2 : 3), (unsigned char)(row == 0x6 ? AM_IX1 : AM_EXT), 6,
+              (unsigned char)mne, FC_NEXT};
+
+    default:    // 0x8..0xF
+      if (op == 0x8D) return {2, AM_REL, 6, MNE_BSR, FC_CALL};
+      if (op == 0x8F) return {1, AM_INH, 3, MNE_XGDX, FC_NEXT};
+      if (op == 0xCD) return OPPRE;
+      if (op == 0xCF) return {1, AM_INH, 2, MNE_STOP, FC_NEXT};
+      mne = mneAcc11[(row >= 0xC ? 16 : 0) + col];
+      if ((row & 3) == 0 && (mne == MNE_STAA || mne == MNE_STAB || mne == MNE_STS ||
+                             mne == MNE_STD || mne == MNE_STX)) break;
+
+      cyc = (row & 3) == 0 ? 2 : (row & 3) == 1 ? 3 : 4;
+      if (mne == MNE_SUBD || mne == MNE_ADDD || mne == MNE_CPX) cyc += 2;
+      else if (mne == MNE_LDS || mne == MNE_STS || mne == MNE_LDD ||
+               mne == MNE_STD || mne == MNE_LDX || mne == MNE_STX) cyc += 1;
+      else if (mne == MNE_JSR) cyc += 2;
+      return {(unsigned char)((row & 3) == 3 || ((row & 3) == 0 && (col == 0x3 || col >= 0xC)) ? 3 : 2),
+              (unsigned char)((row & 3) == 0 ? (col == 0x3 || col >= 0xC ? AM_IMM16 : AM_IMM) :
+                              (row & 3) == 1 ? AM_DIR : (row & 3) == 2 ? AM_IX1 : AM_EXT),
+              (unsigned char)cyc, (unsigned char)mne, (unsigned char)(mne == MNE_JSR ? FC_CALL : FC_NEXT)};
+    } // end switch
+
+  return d;
+  } // MakeOpDesc11
+
+extern constexpr OPDESC opDescHC11[4][256] = {OPPAGE(MakeOpDesc11, 0), OPPAGE(MakeOpDesc11, 1),
+                                              OPPAGE(MakeOpDesc11, 2), OPPAGE(MakeOpDesc11, 3)};
+
+constexpr OPTEXT MakeOpText11(int page, int op) { return MakeOpText(opDescHC11[page][op], op); }
+extern constexpr OPTEXT opTextHC11[4][256] = {OPPAGE(MakeOpText11, 0), OPPAGE(MakeOpText11, 1),
+                                              OPPAGE(MakeOpText11, 2), OPPAGE(MakeOpText11, 3)};
+
+static_assert(opDescHC11[0][0xCC].mode == AM_IMM16 && opDescHC11[0][0xBD].cycles == 6, "CC ldd #, BD jsr");
+static_assert(opDescHC11[1][0xCE].mne == MNE_LDY && opDescHC11[1][0xCE].len == 4, "18CE ldy #");
+static_assert(opDescHC11[1][0x1F].mode == AM_BTBY && opDescHC11[1][0x1F].len == 5, "181F brclr ff,y");
+static_assert(opDescHC11[2][0x83].mne == MNE_CPD && opDescHC11[2][0x83].cycles == 5, "1A83 cpd #");
+static_assert(opDescHC11[2][0xEE].mne == MNE_LDY && opDescHC11[2][0xEF].mne == MNE_STY, "1AEE ldy ff,x");
+static_assert(opDescHC11[3][0xAC].mne == MNE_CPX && opDescHC11[3][0xAC].mode == AM_IY1, "CDAC cpx ff,y");
+static_assert(opDescHC11[0][0x02].cycles == 41 && opDescHC11[0][0x3B].flow == FC_RET, "02 idiv, 3B rti");
+
+//--------------------------end-of-c++-module-----------------------------------
@@ -0,0 +1,402 @@
+// haDASM - Disassembler for Microchip processors
+// dasmxref.cpp - C++ Developer source file.
+// (c)1990-2023 by helmut altmann
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; see the file COPYING.  If not, write to
+// the Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+// Boston, MA 02111-1307, USA.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <windows.h>
+
+#include "equate.h"
+#include "extern.h"
+#include "dasmisa.h"
+
+// --------------------------------------------
+// Direct page cross-reference (-a)
+// --------------------------------------------
+// The direct addressing modes reach the first 256 bytes: the I/O
+// registers and the RAM of the M68HC05. Every instruction of the
+// listing that accesses them is entered as a read, a write (both for
+// read-modify-write) or a bit test (brset, brclr) of its address.
+//
+// The table is in compressed sparse row form: one bucket per address
+// and kind, start[] holds the first entry of each bucket in from[],
+// the accessing instructions in ascending order. "Who writes $C0" is
+// from[start[b]..start[b+1]-1] with b = $C0*XREFKINDS + XREF_WRITE.
+// It is built in two passes over the code, the first one counts the
+// entries of each bucket, the second one fills them in, so there is
+// one allocation for any number of references.
+//
+// The listing lines note the access counts of their address, the
+// report after the listing lists the accesses by address.
+//
+#define XREFLINE    8         // Instruction addresses per report line
+
+static const char xrefKind[XREFKINDS] = {'r', 'w', 't'};
+
+//-----------------------------------------------------------------------------
+//
+//                          XrefAccess
+//
+// The direct page accesses of the (whole) instruction at p[0], 'avail'
+// bytes left: their addresses to dd[], their kinds as bit masks
+// (1 << XREF_xxx) to kind[]. Jumps and calls to the direct page are
+// code, not accesses.
+//
+// Returns their number (0..2, mov dd,dd has two).
+//
+#define XR  (1 << XREF_READ)
+#define XW  (1 << XREF_WRITE)
+#define XT  (1 << XREF_BIT)
+
+template<class ISA>
+static int XrefAccess(const BYTE* p, DWORD avail, BYTE* dd, int* kind)
+  {
+  const OPDESC* d = ISA::Desc(p, avail);
+  const BYTE* o = p + d->len;                   // The operands end the instruction
+  int k;
+
+  if (d->len > avail) return 0;
+  switch (d->mne)
+    {
+    case MNE_JMP:  case MNE_JSR:
+      return 0;
+    case MNE_STA:  case MNE_STX:  case MNE_CLR:  case MNE_STAA: case MNE_STAB:
+    case MNE_STD:  case MNE_STS:  case MNE_STY:  case MNE_STHX:
+      k = XW;
+      break;
+    case MNE_NEG:  case MNE_COM:  case MNE_LSR:  case MNE_ROR:  case MNE_ASR:
+    case MNE_LSL:  case MNE_ROL:  case MNE_DEC:  case MNE_INC:  case MNE_BSET:
+    case MNE_BCLR: case MNE_DBNZ:
+      k = XR | XW;
+      break;
+    case MNE_BRSET: case MNE_BRCLR:
+      k = XT;
+      break;
+    default:
+      k = XR;
+    }
+
+  switch (d->mode)
+    {
+    case AM_DIR:                                // dd
+    case AM_BSC:                                // n,dd
+      dd[0] = o[-1];
+      kind[0] = k;
+      return 1;
+    case AM_BTB:                                // n,dd,rr
+    case AM_DREL:                               // dd,rr
+    case AM_BSCM:                               // dd,#mm
+      dd[0] = o[-2];
+      kind[0] = k;
+      return 1;
+    case AM_BTBM:                               // dd,#mm,rr
+      dd[0] = o[-3];
+      kind[0] = k;
+      return 1;
+    case AM_DD:                                 // mov dd,dd
+      dd[0] = o[-2];
+      kind[0] = XR;
+      dd[1] = o[-1];
+      kind[1] = XW;
+      return 2;
+    case AM_IMD:                                // mov #ii,dd
+    case AM_IXPD:                               // mov x+,dd
+      dd[0] = o[-1];
+      kind[0] = XW;
+      return 1;
+    case AM_DIXP:                               // mov dd,x+
+      dd[0] = o[-1];
+      kind[0] = XR;
+      return 1;
+    }
+  return 0;
+  } // XrefAccess
+
+#undef XR
+#undef XW
+#undef XT
+
+//-----------------------------------------------------------------------------
+//
+//                          XrefPass
+//
+// Start pass 1 (count the entries of the buckets) or pass 2 (fill
+// them in) of building 'x', or end it (pass 0).
+//
+static void XrefPass(XREF* x, int pass)
+  {
+  unsigned long long h = FNVBASIS;
+  DWORD b, n, c;
+
+  if (pass == 1)
+    {
+    memset(x, 0, sizeof(XREF));
+    x->pass = 1;
+    return;
+    }
+
+  if (pass == 2)                                // Counts to offsets
+    {
+    for (b=0, n=0; b<XREFBUCKETS; b++)
+      {
+      c = x->start[b];
+      x->start[b] = x->fill[b] = n;
+      n += c;
+      }
+    x->start[XREFBUCKETS] = x->count = n;
+    OutOfMemory(x->from = (DWORD*)malloc((n ? n : 1) * sizeof(DWORD)));
+    x->pass = 2;
+    return;
+    }
+
+  for (b=0; b<=XREFBUCKETS; b++) h = (h ^ x->start[b]) * FNVPRIME;
+  x->key = h;
+  x->pass = 0;
+  } // XrefPass
+
+// Enter the accesses of the instruction at p[0] (address pc)
+template<class ISA>
+static inline void XrefInsn(XREF* x, const BYTE* p, DWORD avail, DWORD pc)
+  {
+  BYTE dd[2];
+  int kind[2], n, k, b;
+
+  n = XrefAccess<ISA>(p, avail, dd, kind);
+  while (n--)
+    for (k=0; k<XREFKINDS; k++)
+      if (kind[n] & (1 << k))
+        {
+        b = dd[n]*XREFKINDS + k;
+        if (x->pass == 1) x->start[b]++;
+        else x->from[x->fill[b]++] = pc;
+        }
+  } // XrefInsn
+
+//-----------------------------------------------------------------------------
+//
+//                          XrefScan
+//
+// Build the cross-reference 'x' of the linear sweep listing of the
+// image 'im'. The fill runs and strings 'rt' (NULL = none) are
+// skipped like in the listing (see SymScan).
+//
+template<class ISA>
+static void XrefSweep(IMAGE* im, XREF* x, const RUNTAB* rt)
+  {
+  const BYTE* p;
+  DWORD pc, end, lim, k;
+  int pass;
+
+  for (pass=1; pass<=2; pass++)
+    {
+    XrefPass(x, pass);
+    k = 0;
+    for (pc=0; pc<im->size; )
+      {
+      end = im->base + im->len;
+      if (end < im->lim)                        // Keep a whole instruction in the window
+        end = (end > ISA::maxlen-1) ? end - (ISA::maxlen-1) : 0;
+
+      if (pc < im->base || pc >= end)
+        {
+        if (!ImageWindow(im, pc)) break;
+        if (pc < im->base) pc = im->base;       // A gap of a hex file
+        continue;
+        }
+
+      while (pc < end)
+        {
+        p = &im->data[pc - im->base];
+        lim = im->base + im->len;
+        if (rt)
+          {
+          while (k < rt->count && rt->run[k].addr + rt->run[k].len <= pc) k++;
+          if (k < rt->count && rt->run[k].addr <= pc)
+            {
+            pc = rt->run[k].addr + rt->run[k].len;  // Fill run or string
+            continue;
+            }
+          if (k < rt->count && rt->run[k].addr < lim) lim = rt->run[k].addr;
+          }
+
+        XrefInsn<ISA>(x, p, lim - pc, pc);
+        pc += ISA::Desc(p, lim - pc)->len;
+        if (pc > lim) pc = lim;
+        }
+      } // end for pc
+    } // end for pass
+  XrefPass(x, 0);
+  } // XrefSweep
+
+void XrefScan(IMAGE* im, XREF* x, const RUNTAB* rt)
+  {
+  ISACALL(im->cpu, XrefSweep, (im, x, rt));
+  } // XrefScan
+
+//-----------------------------------------------------------------------------
+//
+//                          XrefFlow
+//
+// Build the cross-reference 'x' of the instructions reached by the
+// flow trace (-r): the bitmap 'start' of the image data[0..size-1].
+//
+template<class ISA>
+static void XrefCode(XREF* x, const BYTE* data, DWORD size, const BYTE* start)
+  {
+  DWORD pc;
+  int pass;
+
+  for (pass=1; pass<=2; pass++)
+    {
+    XrefPass(x, pass);
+    for (pc=0; pc<size; pc++)
+      if (BITTST(start, pc)) XrefInsn<ISA>(x, &data[pc], size - pc, pc);
+    }
+  XrefPass(x, 0);
+  } // XrefCode
+
+void XrefFlow(XREF* x, const BYTE* data, DWORD size, const BYTE* start, int cpu)
+  {
+  ISACALL(cpu, XrefCode, (x, data, size, start));
+  } // XrefFlow
+
+//-----------------------------------------------------------------------------
+//
+//                          XrefFind
+//
+// The instructions that access the direct page address 'addr' in the
+// way 'kind' (XREF_xxx), in ascending order: returns the first one,
+// their number to *n. No search, one bucket of the table.
+//
+const DWORD* XrefFind(const XREF* x, DWORD addr, int kind, DWORD* n)
+  {
+  DWORD b = addr*XREFKINDS + kind;
+
+  *n = 0;
+  if (addr >= XREFPAGE || x->from == NULL) return NULL;
+  *n = x->start[b+1] - x->start[b];
+  return &x->from[x->start[b]];
+  } // XrefFind
+
+//-----------------------------------------------------------------------------
+//
+//                          XrefNote
+//
+// Note the access counts of the direct page address(es) of the
+// instruction at p[0] at the end of its listing line s[]:
+//
+//   "\t\t; r3 w2 t1"
+//
+// Returns the new end pointer.
+//
+template<class ISA>
+char* XrefNote(char* s, const XREF* x, const BYTE* p, DWORD avail)
+  {
+  const DWORD* st;
+  BYTE dd[2];
+  int kind[2], n, i;
+
+  n = XrefAccess<ISA>(p, avail, dd, kind);
+  for (i=0; i<n; i++)
+    {
+    st = &x->start[dd[i]*XREFKINDS];
+    s = PutStr(s, i ? ", r" : "\t\t; r");
+    s = PutDec(s, st[1] - st[0]);
+    s = PutStr(s, " w");
+    s = PutDec(s, st[2] - st[1]);
+    s = PutStr(s, " t");
+    s = PutDec(s, st[3] - st[2]);
+    }
+  return s;
+  } // XrefNote
+
+template char* XrefNote<Isa6805>(char*, const XREF*, const BYTE*, DWORD);
+template char* XrefNote<IsaHC08>(char*, const XREF*, const BYTE*, DWORD);
+template char* XrefNote<IsaHC11>(char*, const XREF*, const BYTE*, DWORD);
+
+//-----------------------------------------------------------------------------
+//
+//                          XrefReport
+//
+// The cross-reference 'x' as comment lines after the listing in 'ob':
+// each accessed address (with its user name of 'sym', NULL = none),
+// then the reading, writing and bit testing instructions.
+//
+// Returns the number of source lines produced.
+//
+int XrefReport(OUTBUF* ob, const XREF* x, const SYMTAB* sym)
+  {
+  char line[LINEMAX], *s;
+  const SYMENT* e;
+  const DWORD* from;
+  DWORD addr, n, i;
+  int k, lines = 2;
+
+  OutStr(ob, "\n; Direct page cross-reference: r read, w write, t bit test\n");
+  for (addr=0; addr<XREFPAGE; addr++)
+    {
+    if (x->start[addr*XREFKINDS] == x->start[(addr+1)*XREFKINDS]) continue;
+    s = PutHex2(PutStr(line, "; $0"), addr);
+    if (sym && (e = SymFind(sym, addr)) != NULL && (e->name & ~SYMDEF))
+      {
+      *s++ = ' ';
+      s = SymName(s, sym, e);
+      }
+    *s++ = '\n';
+    OutMem(ob, line, s - line);
+    lines++;
+
+    for (k=0; k<XREFKINDS; k++)
+      {
+      from = XrefFind(x, addr, k, &n);
+      for (i=0; i<n; i++)
+        {
+        if (i % XREFLINE == 0)
+          {
+          s = line;
+          *s++ = ';'; *s++ = ' '; *s++ = ' ';
+          *s++ = i ? ' ' : xrefKind[k];
+          }
+        *s++ = ' ';
+        s = PutAddr(s, from[i]);
+        if (i % XREFLINE == XREFLINE-1 || i == n-1)
+          {
+          *s++ = '\n';
+          OutMem(ob, line, s - line);
+          lines++;
+          }
+        }
+      }
+    }
+  return lines;
+  } // XrefReport
+
+//-----------------------------------------------------------------------------
+//
+//                          XrefFree
+//
+// Also for a table that was never built (zeroed, no references).
+//
+void XrefFree(XREF* x)
+  {
+  free(x->from);
+  x->from = NULL;
+  } // XrefFree
+
+//--------------------------end-of-c++-module-----------------------------------
@@ -0,0 +1,227 @@
+// haDASM - Disassembler for Microchip processors
+// dasm6805.h - C/C++ Developer header file.
+// (c)1990-2023 by helmut altmann
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; see the file COPYING.  If not, write to
+// the Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+// Boston, MA 02111-1307, USA.
+
+//
+// M68HC05 decoder library (DASM6805.lib), C ABI:
+//
+//   Dasm6805Decode   decode a buffer into POD instruction records
+//   Dasm6805DecodeCpu  the same for the M68HC08 or M68HC11
+//   Dasm6805Format   format one record as a listing line
+//   Dasm6805Mnemonic name of a mnemonic identifier
+//   Dasm6805Seek     look up an address in a mapped record file
+//
+// The library has no global state besides its constant tables, it
+// never allocates, all functions are re-entrant and thread-safe.
+
+#ifndef DASM6805_H
+#define DASM6805_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// --------------------------------------------
+// Motorola M68HC05 Family addressing modes
+// --------------------------------------------
+#define AM_ILL      0     // Illegal opcode (printed as FCB)
+#define AM_INH      1     // Inherent, no operand
+#define AM_IMM      2     // Immediate #ii
+#define AM_DIR      3     // Direct dd
+#define AM_EXT      4     // Extended hh ll
+#define AM_REL      5     // Relative rr
+#define AM_IX       6     // Indexed, no offset ,x
+#define AM_IX1      7     // Indexed, 8bit offset ff,x
+#define AM_IX2      8     // Indexed, 16bit offset ee ff,x
+#define AM_BSC      9     // Bit set/clear n,dd
+#define AM_BTB     10     // Bit test and branch n,dd,rr
+
+// M68HC08 (see Dasm6805DecodeCpu)
+#define AM_IMM16   11     // Immediate 16bit #hhll (also M68HC11)
+#define AM_SP1     12     // Stack pointer, 8bit offset ff,sp
+#define AM_SP2     13     // Stack pointer, 16bit offset ee ff,sp
+#define AM_DD      14     // Move direct to direct dd,dd
+#define AM_IMD     15     // Move immediate to direct #ii,dd
+#define AM_DIXP    16     // Move direct to indexed, post increment dd,x+
+#define AM_IXPD    17     // Move indexed, post increment to direct x+,dd
+#define AM_DREL    18     // Direct and relative dd,rr
+#define AM_IREL    19     // Immediate and relative #ii,rr
+#define AM_IXREL   20     // Indexed and relative ,x,rr
+#define AM_IXPREL  21     // Indexed, post increment and relative ,x+,rr
+#define AM_IX1REL  22     // Indexed, 8bit offset and relative ff,x,rr
+#define AM_IX1PREL 23     // Indexed, 8bit offset, post increment and relative ff,x+,rr
+#define AM_SP1REL  24     // Stack pointer, 8bit offset and relative ff,sp,rr
+
+// M68HC11
+#define AM_IY1     25     // Indexed Y, 8bit offset ff,y
+#define AM_BSCM    26     // Bit set/clear with mask dd,#mm
+#define AM_BSCX    27     // Bit set/clear with mask ff,x,#mm
+#define AM_BSCY    28     // Bit set/clear with mask ff,y,#mm
+#define AM_BTBM    29     // Bit test with mask and branch dd,#mm,rr
+#define AM_BTBX    30     // Bit test with mask and branch ff,x,#mm,rr
+#define AM_BTBY    31     // Bit test with mask and branch ff,y,#mm,rr
+#define AM_COUNT   32
+
+// --------------------------------------------
+// Flow control class of an instruction
+// --------------------------------------------
+#define FC_NEXT     0     // Falls through to the next instruction
+#define FC_BRANCH   1     // Conditional branch (target + fall through)
+#define FC_JUMP     2     // Unconditional transfer (bra, jmp)
+#define FC_CALL     3     // Subroutine call (bsr, jsr)
+#define FC_RET      4     // Return (rts, rti)
+#define FC_ILL      5     // Illegal opcode
+
+// --------------------------------------------
+// Motorola M68HC05 Family mnemonic identifiers
+// --------------------------------------------
+enum {
+  MNE_ILL,
+  MNE_BRSET, MNE_BRCLR, MNE_BSET,  MNE_BCLR,
+  MNE_BRA,   MNE_BRN,   MNE_BHI,   MNE_BLS,   MNE_BCC,   MNE_BCS,
+  MNE_BNE,   MNE_BEQ,   MNE_BHCC,  MNE_BHCS,  MNE_BPL,   MNE_BMI,
+  MNE_BMC,   MNE_BMS,   MNE_BIL,   MNE_BIH,
+  MNE_NEG,   MNE_COM,   MNE_LSR,   MNE_ROR,   MNE_ASR,   MNE_LSL,
+  MNE_ROL,   MNE_DEC,   MNE_INC,   MNE_TST,   MNE_CLR,
+  MNE_NEGA,  MNE_COMA,  MNE_LSRA,  MNE_RORA,  MNE_ASRA,  MNE_LSLA,
+  MNE_ROLA,  MNE_DECA,  MNE_INCA,  MNE_TSTA,  MNE_CLRA,
+  MNE_NEGX,  MNE_COMX,  MNE_LSRX,  MNE_RORX,  MNE_ASRX,  MNE_LSLX,
+  MNE_ROLX,  MNE_DECX,  MNE_INCX,  MNE_TSTX,  MNE_CLRX,
+  MNE_MUL,   MNE_RTI,   MNE_RTS,   MNE_SWI,   MNE_STOP,  MNE_WAIT,
+  MNE_TAX,   MNE_CLC,   MNE_SEC,   MNE_CLI,   MNE_SEI,   MNE_RSP,
+  MNE_NOP,   MNE_TXA,   MNE_BSR,
+  MNE_SUB,   MNE_CMP,   MNE_SBC,   MNE_CPX,   MNE_AND,   MNE_BIT,
+  MNE_LDA,   MNE_STA,   MNE_EOR,   MNE_ADC,   MNE_ORA,   MNE_ADD,
+  MNE_JMP,   MNE_JSR,   MNE_LDX,   MNE_STX,
+
+  // M68HC08
+  MNE_AIS,   MNE_AIX,   MNE_BGE,   MNE_BLT,   MNE_BGT,   MNE_BLE,
+  MNE_CBEQ,  MNE_CBEQA, MNE_CBEQX, MNE_CLRH,  MNE_CPHX,  MNE_DAA,
+  MNE_DBNZ,  MNE_DBNZA, MNE_DBNZX, MNE_DIV,   MNE_LDHX,  MNE_MOV,
+  MNE_NSA,   MNE_PSHA,  MNE_PSHH,  MNE_PSHX,  MNE_PULA,  MNE_PULH,
+  MNE_PULX,  MNE_STHX,  MNE_TAP,   MNE_TPA,   MNE_TSX,   MNE_TXS,
+
+  // M68HC11 (the accumulator B row in the order of MNE_NEG..MNE_CLR)
+  MNE_NEGB,  MNE_COMB,  MNE_LSRB,  MNE_RORB,  MNE_ASRB,  MNE_LSLB,
+  MNE_ROLB,  MNE_DECB,  MNE_INCB,  MNE_TSTB,  MNE_CLRB,
+  MNE_SUBA,  MNE_CMPA,  MNE_SBCA,  MNE_ANDA,  MNE_BITA,  MNE_LDAA,
+  MNE_STAA,  MNE_EORA,  MNE_ADCA,  MNE_ORAA,  MNE_ADDA,
+  MNE_SUBB,  MNE_CMPB,  MNE_SBCB,  MNE_ANDB,  MNE_BITB,  MNE_LDAB,
+  MNE_STAB,  MNE_EORB,  MNE_ADCB,  MNE_ORAB,  MNE_ADDB,
+  MNE_ABA,   MNE_ABX,   MNE_ABY,   MNE_ADDD,  MNE_BVC,   MNE_BVS,
+  MNE_CBA,   MNE_CLV,   MNE_CPD,   MNE_CPY,   MNE_DES,   MNE_DEX,
+  MNE_DEY,   MNE_FDIV,  MNE_IDIV,  MNE_INS,   MNE_INX,   MNE_INY,
+  MNE_LDD,   MNE_LDS,   MNE_LDY,   MNE_LSLD,  MNE_LSRD,  MNE_PSHB,
+  MNE_PSHY,  MNE_PULB,  MNE_PULY,  MNE_SBA,   MNE_SEV,   MNE_STD,
+  MNE_STS,   MNE_STY,   MNE_SUBD,  MNE_TAB,   MNE_TBA,   MNE_TSY,
+  MNE_TYS,   MNE_WAI,   MNE_XGDX,  MNE_XGDY,
+  MNE_COUNT
+  };
+
+// --------------------------------------------
+// Decoded instruction record
+// --------------------------------------------
+#define DASM6805_NOTARGET 0xFFFFFFFF  // No (static) branch or jump target
+#define DASM6805_TRUNC    0x01        // flags: cut off by the end of the buffer
+#define DASM6805_LINEMAX  128         // Longest formatted line incl. NUL
+#define DASM6805_NAMEMAX  32          // Longest name from a DASMNAMEPROC
+#define DASM6805_INSNMAX  5           // Longest instruction (M68HC11)
+
+#define DASM6805_HC05     0           // cpu: M68HC05 (Dasm6805Decode)
+#define DASM6805_HC08     1           // M68HC08: prefix $9E, stack pointer modes
+#define DASM6805_HC11     2           // M68HC11: prebytes $18, $1A, $CD
+
+typedef struct tag_DASMINSN {
+  uint32_t addr;      // Address of the opcode (prefix byte)
+  uint32_t target;    // Branch or jump target, DASM6805_NOTARGET if none
+  uint8_t  bytes[DASM6805_INSNMAX];  // Prefix, opcode and operand bytes (unused ones are 0)
+  uint8_t  len;       // Instruction length 1..5 (less if DASM6805_TRUNC)
+  uint8_t  mode;      // Addressing mode AM_xxx
+  uint8_t  flow;      // Flow control class FC_xxx
+  uint8_t  mne;       // Mnemonic identifier MNE_xxx
+  uint8_t  cycles;    // Number of CPU cycles
+  uint8_t  flags;     // DASM6805_TRUNC
+  uint8_t  cpu;       // DASM6805_HC05, _HC08, _HC11
+} DASMINSN;
+
+// --------------------------------------------
+// Record file of the disassembler (-m b)
+// --------------------------------------------
+// DASMREC[count] in ascending address order, then the address index
+// uint32_t[nindex] and the DASMRECTAIL at the end of the file:
+// index[i] is the first record at an address >= org + (i << shift),
+// the last entry is count. Map the file and look up addresses with Dasm6805Seek.
+//
+#define DASMREC_MAGIC     0x52534D44  // "DMSR"
+#define DASMREC_VERSION   1
+#define DASMREC_SHIFT     8           // Index granularity: 256 byte pages
+
+#define DASMREC_INSN      0           // kind: instruction
+#define DASMREC_DATA      1           // FCB data bytes
+#define DASMREC_FILL      2           // Run of the byte value bytes[0]
+#define DASMREC_TEXT      3           // ASCII string
+#define DASMREC_VECTOR    4           // FDB vector
+#define DASMREC_LABEL     0x02        // flags: the address is a defined label
+
+typedef struct tag_DASMREC {
+  uint32_t addr;      // Address of the item
+  uint32_t len;       // Number of bytes of the item
+  uint32_t target;    // Branch, jump or vector target, DASM6805_NOTARGET if none
+  uint8_t  bytes[4];  // First bytes of the item (unused ones are 0)
+  uint8_t  kind;      // DASMREC_xxx
+  uint8_t  mode;      // Addressing mode AM_xxx (AM_ILL if no instruction)
+  uint8_t  flow;      // Flow control class FC_xxx
+  uint8_t  mne;       // Mnemonic identifier MNE_xxx
+  uint8_t  cycles;    // Number of CPU cycles
+  uint8_t  flags;     // DASM6805_TRUNC, DASMREC_LABEL
+  uint8_t  reserved[2];
+} DASMREC;
+
+typedef struct tag_DASMRECTAIL {
+  uint32_t magic;     // DASMREC_MAGIC
+  uint16_t version;   // DASMREC_VERSION
+  uint16_t recsize;   // sizeof(DASMREC)
+  uint32_t count;     // Number of records (at file offset 0)
+  uint32_t nindex;    // Entries of the index (after the records)
+  uint32_t shift;     // Index granularity
+  uint32_t size;      // Size of the image (highest address + 1)
+  uint32_t org;       // Address of index[0]
+  uint32_t cpu;       // DASM6805_HC05, _HC08, _HC11
+} DASMRECTAIL;
+
+// Name of the target 'addr' for the formatter: write it to s[] (no NUL,
+// at most DASM6805_NAMEMAX chars) and return the new end pointer, or
+// return NULL (without writing) to print the address.
+typedef char* (*DASMNAMEPROC)(char* s, void* ctx, uint32_t addr);
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+size_t Dasm6805Decode(const uint8_t* p, size_t n, uint32_t base, DASMINSN* out, size_t cap);
+size_t Dasm6805DecodeCpu(unsigned cpu, const uint8_t* p, size_t n, uint32_t base, DASMINSN* out, size_t cap);
+size_t Dasm6805Format(const DASMINSN* in, char* buf, size_t size, DASMNAMEPROC name, void* ctx);
+const char* Dasm6805Mnemonic(unsigned mne);
+const DASMREC* Dasm6805Seek(const void* file, size_t n, uint32_t addr);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // DASM6805_H
+
+//-----------------------------end-of-dasm6805.h---------------------------------
@@ -0,0 +1,118 @@
+// haDASM - Disassembler for Microchip processors
+// dasmisa.h - C/C++ Developer header file.
+// (c)1990-2023 by helmut altmann
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; see the file COPYING.  If not, write to
+// the Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+// Boston, MA 02111-1307, USA.
+
+// --------------------------------------------
+// Instruction sets (--cpu)
+// --------------------------------------------
+// The decoder, the sweeps and the flow tracer are templates over one
+// of the traits below: the opcode tables of the CPU, its longest
+// instruction and the lookup of a prefix byte (Index numbers the
+// opcodes of all pages, for the statistics). Each CPU gets its own
+// copy of the hot loops, the CPU is only tested once at their entry
+// (ISACALL). The M68HC05 has no prefix at all, its lookup is the
+// plain table access of old.
+//
+// Include after equate.h and extern.h.
+//
+#ifndef DASMISA_H
+#define DASMISA_H
+
+// Opcode tables (dasmtab.cpp), [page][opcode]
+extern const OPDESC opDescHC08[2][256];     // Page 1: prefix $9E
+extern const OPTEXT opTextHC08[2][256];
+extern const OPDESC opDescHC11[4][256];     // Pages 1..3: prebytes $18, $1A, $CD
+extern const OPTEXT opTextHC11[4][256];
+
+typedef struct tag_Isa6805 {
+  enum {cpu = DASM6805_HC05, maxlen = 3};
+  static inline const OPDESC* Desc(const BYTE* p, DWORD)
+    {
+    return &opDesc6805[p[0]];
+    }
+  static inline const char* Text(const OPDESC* d)
+    {
+    return mnemonic6805[d - opDesc6805].mneStr;
+    }
+  static inline int Index(const OPDESC* d)    // [page][opcode] as one number
+    {
+    return (int)(d - opDesc6805);
+    }
+} Isa6805;
+
+typedef struct tag_IsaHC08 {
+  enum {cpu = DASM6805_HC08, maxlen = 4};
+  static inline const OPDESC* Desc(const BYTE* p, DWORD avail)
+    {
+    return (p[0] == 0x9E && avail > 1) ? &opDescHC08[1][p[1]] : &opDescHC08[0][p[0]];
+    }
+  static inline const char* Text(const OPDESC* d)
+    {
+    int n = Index(d);
+    return opTextHC08[n >> 8][n & 0xFF].s;
+    }
+  static inline int Index(const OPDESC* d)    // [page][opcode] as one number
+    {
+    return (int)(d - opDescHC08[0]);
+    }
+} IsaHC08;
+
+typedef struct tag_IsaHC11 {
+  enum {cpu = DASM6805_HC11, maxlen = 5};
+  static inline const OPDESC* Desc(const BYTE* p, DWORD avail)
+    {
+    if (avail > 1)
+      switch (p[0])
+        {
+        case 0x18: return &opDescHC11[1][p[1]];
+        case 0x1A: return &opDescHC11[2][p[1]];
+        case 0xCD: return &opDescHC11[3][p[1]];
+        }
+    return &opDescHC11[0][p[0]];
+    }
+  static inline const char* Text(const OPDESC* d)
+    {
+    int n = Index(d);
+    return opTextHC11[n >> 8][n & 0xFF].s;
+    }
+  static inline int Index(const OPDESC* d)    // [page][opcode] as one number
+    {
+    return (int)(d - opDescHC11[0]);
+    }
+} IsaHC11;
+
+// Call the instance f<ISA> of the instruction set 'cpu' (DASM6805_xxx)
+#define ISACALL(cpu,f,args) ((cpu) == DASM6805_HC11 ? f<IsaHC11> args : \
+                             (cpu) == DASM6805_HC08 ? f<IsaHC08> args : f<Isa6805> args)
+
+// Decoder library (dasmlib.cpp)
+template<class ISA> char* DasmRender(char*, const BYTE*, DWORD, DWORD, DASMNAMEPROC, void*, const REGMAP*, char**);
+template<class ISA> size_t DasmDecode(const BYTE*, size_t, DWORD, DASMINSN*, size_t);
+
+// Listing output sink (dasmout.cpp)
+template<class ISA> int DasmLine(OUTBUF*, const BYTE*, DWORD, DWORD);
+
+// Direct page cross-reference (dasmxref.cpp)
+template<class ISA> char* XrefNote(char*, const XREF*, const BYTE*, DWORD);
+
+// Machine-readable output (dasmfmt.cpp)
+template<class ISA> int FmtLine(OUTBUF*, const BYTE*, DWORD, DWORD);
+
+#endif // DASMISA_H
+
+//-----------------------------end-of-dasmisa.h-----------------------------------
@@ -0,0 +1,445 @@
+// haDASM - Disassembler for Microchip processors
+// equate.h - C++ Developer source file.
+// (c)1990-2023 by helmut altmann
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; see the file COPYING.  If not, write to
+// the Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+// Boston, MA 02111-1307, USA.
+
+#include "dasm6805.h"   // Decoder library: addressing modes, mnemonics
+
+#define ERR        -1
+#define TRUE        1
+#define FALSE       0
+#define LENGTH     50
+
+#define ESC     0x1B
+#define SPACE   ' '
+
+#define ROMSIZE  32*1024
+#define IMAGEWINDOW  16*1024*1024   // Mapped (or read) window of the input image
+
+#define FNVBASIS  0xCBF29CE484222325ULL    // 64bit FNV-1a: cache keys, fingerprints, ..
+#define FNVPRIME  0x100000001B3ULL
+
+// Target of the relative branch at 'pc' ('len' bytes, offset 'rr').
+// Like the 16bit PC of the CPU it wraps around within the 64K bank.
+#define BRANCHTARGET(pc,len,rr) (((pc) & 0xFFFF0000) | (((pc)+(len)+(signed char)(rr)) & 0xFFFF))
+
+// --------------------------------------------
+// Listing text of an opcode (see mnemonic6805[] dasmtab.cpp)
+// --------------------------------------------
+typedef struct tag_68HC05INS {
+  const char* mneStr;
+} _6805MNEMONIC, *LP_6805MNEMONIC;
+
+// Listing text of an M68HC08 or M68HC11 opcode, generated in the
+// format of mnemonic6805[] (see MakeOpText dasmtab.cpp)
+typedef struct tag_OPTEXT {
+  char s[20];
+} OPTEXT;
+
+// ---------------------------------------------------
+// Opcode descriptor: one entry per opcode 00..FF,
+// generated at compile time (see opDesc6805[] dasmtab.cpp)
+// ---------------------------------------------------
+typedef struct tag_OPDESC {
+  unsigned char len;      // Instruction length in bytes incl. prefix (1..5)
+  unsigned char mode;     // Addressing mode AM_xxx
+  unsigned char cycles;   // Number of CPU cycles
+  unsigned char mne;      // Mnemonic identifier MNE_xxx
+  unsigned char flow;     // Flow control class FC_xxx
+} OPDESC, *LP_OPDESC;
+
+// ---------------------------------------------------
+// Symbol table (dasmsym.cpp)
+// ---------------------------------------------------
+#define SYMLEN      32          // Longest user symbol name
+#define SYMDEF      0x80000000  // Flag of SYMENT.name: label is defined
+
+typedef struct tag_SYMENT {
+  DWORD  addr;      // Branch or jump target
+  DWORD  name;      // Offset of the user name in pool, 0 = "Lxxxx" | SYMDEF
+} SYMENT;
+
+typedef struct tag_SYMTAB {
+  SYMENT* sym;      // Symbols, sorted by address (SymSort)
+  DWORD  count;
+  DWORD  alloc;
+  DWORD* bucket;    // bucket[addr >> shift] = first symbol of the bucket
+  DWORD  nbucket;   // Number of buckets + 1, 0 = not sorted
+  int    shift;
+  char*  pool;      // User names, NUL terminated
+  DWORD  poolLen;
+  DWORD  poolSize;
+} SYMTAB;
+
+// ---------------------------------------------------
+// Fill runs and ASCII strings (dasmrun.cpp)
+// ---------------------------------------------------
+#define RUNMIN      16        // Shortest run of one byte value
+#define TEXTMIN     8         // Shortest ASCII string
+#define TEXTMAX     4096      // Longest string region (longer ones are split)
+#define TEXTLINE    32        // Chars per FCC line
+
+#define RUN_FILL    0         // Run of RUNENT.fill
+#define RUN_TEXT    1         // Printable ASCII
+
+typedef struct tag_RUNENT {
+  DWORD  addr;      // First byte of the region
+  DWORD  len;       // Number of bytes
+  BYTE   kind;      // RUN_FILL, RUN_TEXT
+  BYTE   fill;      // Byte value of a RUN_FILL
+} RUNENT;
+
+typedef struct tag_RUNTAB {
+  RUNENT* run;      // Regions, ascending and disjoint
+  DWORD  count;
+  DWORD  alloc;
+} RUNTAB;
+
+// ---------------------------------------------------
+// Direct page cross-reference (dasmxref.cpp)
+// ---------------------------------------------------
+#define XREF_READ   0         // Kinds of access (rmw: read and write)
+#define XREF_WRITE  1
+#define XREF_BIT    2         // Bit test: brset, brclr
+#define XREFKINDS   3
+#define XREFPAGE    256       // The direct page $00..$FF
+#define XREFBUCKETS (XREFPAGE*XREFKINDS)
+
+typedef struct tag_XREF {
+  DWORD  start[XREFBUCKETS+1]; // Bucket b = addr*XREFKINDS + kind: from[start[b]..start[b+1]-1]
+  DWORD  fill[XREFBUCKETS];    // Pass 2: next entry of bucket b
+  DWORD* from;      // Addresses of the accessing instructions, ascending per bucket
+  DWORD  count;     // Entries of from[]
+  int    pass;      // 1: counting, 2: filling, 0: done
+  unsigned long long key; // FNV-1a of start[] (the counts of the annotations)
+} XREF;
+
+// ---------------------------------------------------
+// Function fingerprints (dasmsig.cpp)
+// ---------------------------------------------------
+#define SIGMAGIC    0x464D5344 // "DSMF"
+#define SIGVERSION  1
+#define SIGMININSN  4         // Shortest function fingerprinted, in instructions
+#define SIGMAXLEN   2048      // Longest function, in bytes
+#define SIGMAXBITS  24        // Largest bucket index of a signature file
+
+#define DIFFMAXD    4096      // Largest edit distance of a box of the diff (--diff)
+
+typedef struct tag_SIGHDR {
+  DWORD  magic;     // SIGMAGIC
+  DWORD  version;   // SIGVERSION
+  DWORD  count;     // Signatures
+  DWORD  bits;      // Bucket index: the top 'bits' bits of the hash
+  DWORD  poolLen;   // Chars of the names
+  DWORD  reserved;
+} SIGHDR;
+
+typedef struct tag_SIGENT {
+  unsigned long long hash; // FNV-1a of the normalised function
+  DWORD  name;      // Offset of its name in the pool
+  DWORD  len;       // Bytes of the function
+} SIGENT;
+
+typedef struct tag_SIGINDEX {
+  const SIGENT* ent; // ent[0..count-1], sorted by hash
+  const DWORD* bucket; // bucket[b] = first entry with the top bits b, [1 << bits] = count
+  const char* pool; // Names, NUL terminated
+  DWORD  count;
+  DWORD  poolLen;
+  int    bits;
+  int    fh;        // File handle
+  HANDLE hMap;      // File mapping object
+  BYTE*  view;      // Mapped view of the whole file
+} SIGINDEX;
+
+// ---------------------------------------------------
+// Register maps of the derivatives (dasmreg.cpp)
+// ---------------------------------------------------
+#define REGNONE     0xFFFFFFFF // Address of an empty slot
+#define REGBITS     8         // Named bits of a register
+#define REGNAMELEN  12        // Longest register or bit name
+#define REGPARTBITS 6         // Slots of a built-in map: 1 << REGPARTBITS
+#define REGMAXBITS  16        // Largest map file: 1 << REGMAXBITS slots
+
+// Home slot of the register address 'a' in a table of 1 << bits slots
+#define REGHASH(a,mul,bits) ((DWORD)((DWORD)(a) * (DWORD)(mul)) >> (32 - (bits)))
+
+typedef struct tag_REGSLOT {
+  DWORD  addr;      // Register address, REGNONE = empty slot
+  const char* name; // Register name
+  const char* bit[REGBITS]; // Names of bit 0..7, NULL = unnamed
+} REGSLOT;
+
+typedef struct tag_REGMAP {
+  const REGSLOT* slot; // Open-addressed table of 1 << bits slots
+  DWORD  mul;       // Hash multiplier (REGHASH)
+  int    bits;
+  int    probe;     // Longest probe sequence, 0 = perfect hash
+  DWORD  count;     // Registers
+  unsigned long long key; // FNV-1a of the registers (for -k)
+  const char* part; // Name of the derivative or of the map file
+  REGSLOT* alloc;   // Slots of a map file, NULL = built-in
+  char*  pool;      // Names of a map file
+} REGMAP;
+
+// ---------------------------------------------------
+// Run statistics (dasmstat.cpp)
+// ---------------------------------------------------
+#define STATS_TEXT  1         // --stats: report on stderr
+#define STATS_JSON  2         // --stats=json: one JSON object on stderr
+
+#define STAT_NONE   0         // Phases of a run: not timed
+#define STAT_LOAD   1         // Opening and reading the image
+#define STAT_DECODE 2         // Pre-passes: fill runs, labels, flow trace
+#define STAT_FORMAT 3         // Listing lines (decoded and formatted at once)
+#define STAT_WRITE  4         // Writing the listing text
+#define STAT_PHASES 5
+
+#define STATOPS     1024      // Opcode histogram: [page][opcode], 4 pages (M68HC11)
+#define STATTOP     16        // Opcodes in the text report
+
+typedef struct tag_DASMSTATS {
+  int    cpu;       // Instruction set of op[]
+  int    phase;     // Current phase STAT_xxx
+  long long mark;   // Start of the current phase (StatClock)
+  long long start;  // Start of the run
+  long long time[STAT_PHASES]; // Nanoseconds per phase
+  DWORD  files;     // Images listed
+  unsigned long long image;  // Image bytes
+  unsigned long long code;   // Bytes listed as instructions
+  unsigned long long data;   // Bytes listed as data (fcb, fcc, fdb)
+  unsigned long long out;    // Bytes written
+  DWORD  op[STATOPS];        // Instructions per opcode (see ISA::Index)
+  DWORD  mode[AM_COUNT];     // Instructions per addressing mode, AM_ILL = illegal
+} DASMSTATS;
+
+// ---------------------------------------------------
+// Listing output sink (dasmout.cpp)
+// ---------------------------------------------------
+#define OUTBUFSIZE  256*1024  // Listing text is written in blocks of this size
+#define LINEMAX     128       // Longest listing line (incl. blank line)
+
+#define FMT_TEXT    0         // Listing text
+#define FMT_JSON    1         // JSON lines (-m j)
+#define FMT_REC     2         // DASMREC records and address index (-m b)
+#define FMTLINE     256       // Longest JSON line
+
+typedef struct tag_FMTOUT {
+  int    kind;      // FMT_JSON or FMT_REC
+  int    cpu;       // DASM6805_HC05, _HC08, _HC11 (of the tail)
+  DWORD  org;       // Address of index[0]
+  DWORD  count;     // Number of records written
+  DWORD* index;     // index[i] = first record at address >= org + (i << DASMREC_SHIFT)
+  DWORD  nindex;    // Entries of index[]
+  DWORD  alloc;     // Allocated entries of index[]
+  const SYMENT* label; // Defined label of the next item, NULL = none
+} FMTOUT;
+
+typedef struct tag_OUTBUF {
+  char*  buf;       // Listing text buffer
+  size_t len;       // Number of chars in buf
+  size_t size;      // Size of buf
+  FILE*  fp;        // Output stream, NULL = collect in memory
+  SYMTAB* sym;      // Labels of the listing, NULL = none
+  DWORD  cur;       // Next label of the listing: sym->sym[cur]
+  const RUNTAB* run; // Fill runs and strings, NULL = none
+  FMTOUT* fmt;      // Machine-readable output, NULL = listing text
+  DASMSTATS* stats; // Run statistics (--stats), NULL = none
+  XREF*  xref;      // Direct page accesses noted on the lines (-a), NULL = none
+  const REGMAP* reg; // Register names of the operands (-i), NULL = none
+} OUTBUF;
+
+// Bitmaps with one bit per image byte
+#define BITSET(map,n) ((map)[(n) >> 3] |= (BYTE)(1 << ((n) & 7)))
+#define BITCLR(map,n) ((map)[(n) >> 3] &= (BYTE)~(1 << ((n) & 7)))
+#define BITTST(map,n) ((map)[(n) >> 3] & (1 << ((n) & 7)))
+
+// ---------------------------------------------------
+// Input image (dasmfile.cpp, dasmhex.cpp)
+// ---------------------------------------------------
+#define PAGESIZE    4096      // Page of a sparse image (hex files)
+#define HEXLINE     600       // Longest line of a hex file
+
+#define HEX_NONE    0         // Binary image file
+#define HEX_SREC    1         // Motorola S-records (S19, S28, S37)
+#define HEX_INTEL   2         // Intel HEX
+
+typedef struct tag_IMGPAGE {
+  DWORD  addr;                // Address of data[0], a multiple of PAGESIZE
+  BYTE   data[PAGESIZE];
+  BYTE   used[PAGESIZE/8];    // Bitmap of the loaded bytes
+} IMGPAGE;
+
+typedef struct tag_IMGSEG {
+  DWORD  start;               // First address of a populated range
+  DWORD  end;                 // Last address + 1
+} IMGSEG;
+
+typedef struct tag_IMAGE {
+  const BYTE* data;   // Window of the image: data[0] is at address base
+  DWORD  base;        // Address (file offset) of data[0]
+  DWORD  len;         // Number of bytes in the window
+  DWORD  size;        // Size of the image file (hex file: highest address + 1)
+  DWORD  lim;         // End of the populated range of the window (binary: size)
+  int    kind;        // HEX_xxx: binary image or hex file
+  int    cpu;         // DASM6805_HC05, _HC08, _HC11 (set after ImageOpen)
+  IMGPAGE** page;     // Hex file: its pages by ascending address
+  DWORD  npage;       // Number of pages
+  DWORD  apage;       // Allocated entries of page[]
+  IMGSEG* seg;        // Hex file: the populated ranges by ascending address
+  DWORD  nseg;        // Number of ranges
+  DWORD  gran;        // Allocation granularity of mapped views
+  int    fh;          // File handle
+  HANDLE hFile;       // OS handle of fh
+  HANDLE hMap;        // File mapping object, NULL if not mappable
+  BYTE*  view;        // Mapped view
+  BYTE*  rdbuf;       // read() fallback buffer
+  int    shared;      // TRUE: copy of another IMAGE with its own views (ImageShare)
+} IMAGE;
+
+// ---------------------------------------------------
+// Disassembler options (command line)
+// ---------------------------------------------------
+#define PARCHUNK    256*1024  // Chunk size of the parallel sweep
+#define PARMARGIN   16        // Parallel sweep starts this far before its chunk
+#define PARSYNC     64        // Instruction starts kept for the resynchronisation
+#define FLOWVECTORS 4         // Vectors at the top of memory (-r)
+#define FLOWVECTORS11 21      // M68HC11: vectors $FFD6..$FFFF
+#define MAXENTRY    32        // Entry points (-e)
+
+#define CACHECHUNK  4096      // Image bytes per cached listing fragment (-k)
+#define CACHEMAGIC  0x4B4D5344 // "DSMK"
+#define CACHEVERSION 1
+
+#define SRVPAGE     256       // Image bytes per listing page of the query server (-q)
+#define SRVCACHE    1024      // Listing pages held by the query server
+#define SRVLINES    40        // Lines per query by default
+
+#define PIPECHUNK   64*1024   // Largest read of a stream from stdin (-)
+#define PIPEREC     4096      // Decoded instructions per block of a stream
+#define PIPESLOTS   8         // Chunks and blocks in flight between the stages
+#define PIPESPIN    64        // Waits of a stage that only yield, then it sleeps
+
+// ---------------------------------------------------
+// Instruction pattern search (dasmgrep.cpp)
+// ---------------------------------------------------
+#define GREPMAX     32        // Patterns (-g), one bit each in GREP.first[]
+#define GREPTEXT    128       // Longest pattern
+#define GREPLEN     8         // Instructions per pattern
+#define GREPFIELDS  4         // Operand fields per instruction
+#define GREPBYTES   8         // Most first bytes searched with vector compares
+
+#define GREP_ANY    0         // Field "*", "$*", "#*"
+#define GREP_NUM    1         // Number with wildcard digits
+#define GREP_TEXT   2         // Register or bit number
+
+typedef struct tag_GREPFIELD {
+  BYTE   kind;      // GREP_xxx
+  BYTE   imm;       // '#' prefix
+  BYTE   num;       // '$' prefix
+  char   text[7];   // GREP_TEXT: lower case text
+  DWORD  val;       // GREP_NUM: (value & mask) == val
+  DWORD  mask;
+} GREPFIELD;
+
+typedef struct tag_GREPINSN {
+  BYTE   mne[MNE_COUNT]; // The mnemonics MNE_xxx that match
+  int    nfield;    // Number of operand fields, ERR = any operand
+  GREPFIELD field[GREPFIELDS];
+} GREPINSN;
+
+typedef struct tag_GREPPAT {
+  char   text[GREPTEXT]; // The pattern as given
+  GREPINSN insn[GREPLEN];
+  int    count;     // Number of instructions
+} GREPPAT;
+
+typedef struct tag_GREP {
+  GREPPAT pat[GREPMAX];
+  int    count;     // Number of patterns
+  int    cpu;       // Instruction set of first[] (GrepCompile)
+  DWORD  first[256]; // first[b] = patterns that may start with byte b
+  BYTE   byte[GREPBYTES]; // The bytes b with first[b] != 0
+  int    nbyte;     // Their number, 0 = too many for the vector compare
+} GREP;
+
+// ---------------------------------------------------
+// M68HC05 simulator (dasmsim.cpp)
+// ---------------------------------------------------
+#define SIMAREAS    16        // Areas of the memory map (-y)
+
+#define SIM_ROM     0         // The image, writes are ignored
+#define SIM_RAM     1
+#define SIM_IO      2         // Reads are pseudo-random, writes are ignored
+
+typedef struct tag_SIMAREA {
+  DWORD  lo, hi;    // First and last address
+  int    kind;      // SIM_xxx
+} SIMAREA;
+
+typedef struct tag_SIMMAP {
+  SIMAREA area[SIMAREAS];
+  int    count;
+} SIMMAP;
+
+typedef struct tag_SIMSTATS {
+  DWORD  cycles;    // Simulated cycles
+  DWORD  insns;     // Executed instructions
+  DWORD  addrs;     // Different opcode addresses
+  const char* stop; // Why the run ended
+} SIMSTATS;
+
+typedef struct tag_DASMOPT {
+  int    threads;     // Number of worker threads, 0 = one per processor
+  int    parallel;    // TRUE: split one large image into chunks (-p)
+  DWORD  chunk;       // Chunk size of the parallel sweep (and largest read of -)
+  int    flow;        // TRUE: control flow guided disassembly (-r)
+  int    vectors;     // Number of vectors at the top of memory
+  int    nentry;      // Number of entry points
+  DWORD  entry[MAXENTRY]; // Entry points besides the vectors (-e)
+  int    labels;      // TRUE: labels for the branch and jump targets (-l)
+  const SYMTAB* user; // User symbols (-s), NULL = none
+  int    fill;        // TRUE: fill runs and strings as data (-f)
+  const char* cache;  // Listing cache file (-k), NULL = none
+  int    format;      // Output format FMT_xxx (-m)
+  int    cpu;         // Instruction set DASM6805_HC05, _HC08, _HC11 (--cpu)
+  const GREP* grep;   // Search patterns (-g), NULL = disassemble
+  DWORD  sim;         // Cycles to simulate from reset for -r (-x), 0 = none
+  const SIMMAP* map;  // Memory map of the simulation (-y), NULL = default
+  int    stats;       // Run statistics STATS_xxx (--stats), 0 = none
+  int    xref;        // TRUE: direct page cross-reference (-a)
+  const SIGINDEX* sig; // Signatures of known functions (-n), NULL = none
+  const REGMAP* reg;  // Register names of the derivative (-i), NULL = none
+  int    cycles;      // Routines and loops of the cycle budget (-u), 0 = none
+} DASMOPT;
+
+// ---------------------------------------------------
+// Batch mode (dasmbat.cpp)
+// ---------------------------------------------------
+typedef struct tag_BATCH {
+  char** name;        // Input file names
+  int    count;       // Number of input files
+  int    alloc;       // Allocated entries of name[]
+  int    expanded;    // TRUE if a folder, wildcard or @list was given
+  int    combined;    // TRUE: ordered combined listing to stdout
+  const char* outdir; // Folder of the listings, NULL = folder of the file
+  const DASMOPT* opt; // Disassembler options
+} BATCH;
+
+typedef void (*POOLPROC)(void* ctx, int job);
+
+//-----------------------------end-of-equate.h-----------------------------------
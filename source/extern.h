@@ -0,0 +1,159 @@
+// haDASM - Disassembler for Microchip processors
+// extern.h - C++ Developer source file.
+// (c)1990-2023 by helmut altmann
+//
+// This program is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 2 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; see the file COPYING.  If not, write to
+// the Free Software Foundation, Inc., 59 Temple Place - Suite 330,
+// Boston, MA 02111-1307, USA.
+
+// Global tables (dasmtab.cpp)
+extern const _6805MNEMONIC mnemonic6805[256];
+extern const OPDESC opDesc6805[256];
+extern const char* const mneName[MNE_COUNT];
+extern const char* const modeName[AM_COUNT];
+
+// Decoder library (dasmlib.cpp)
+extern char* PutHex2(char*, unsigned);
+extern char* PutAddr(char*, DWORD);
+extern char* PutStr(char*, const char*);
+extern char* PutDec(char*, DWORD);
+extern DWORD FlowTarget(const OPDESC*, const BYTE*, DWORD);
+
+// Disassembler (DASM.cpp)
+extern DWORD DasmRange(IMAGE*, OUTBUF*, DWORD, DWORD, int*);
+extern int  DasmFile(const char*, OUTBUF*, const DASMOPT*);
+
+// Listing output sink (dasmout.cpp)
+extern void OutOfMemory(void*);
+extern char* OutName(char*, void*, uint32_t);
+extern void OutInit(OUTBUF*, FILE*);
+extern void OutFlush(OUTBUF*);
+extern void OutFree(OUTBUF*);
+extern void OutStr(OUTBUF*, const char*);
+extern void OutMem(OUTBUF*, const char*, size_t);
+extern void OutNote(OUTBUF*, const char*);
+extern int  DasmData(OUTBUF*, const BYTE*, DWORD, DWORD);
+extern int  DasmRun(OUTBUF*, const RUNENT*, const BYTE*, DWORD, DWORD);
+extern int  DasmDataRuns(OUTBUF*, const BYTE*, DWORD, DWORD);
+extern int  DasmLabel(OUTBUF*, DWORD);
+extern int  DasmOrg(OUTBUF*, DWORD);
+
+// Machine-readable output (dasmfmt.cpp)
+extern void FmtInit(OUTBUF*, FMTOUT*, int, DWORD, int);
+extern void FmtEnd(OUTBUF*, DWORD);
+extern void FmtData(OUTBUF*, int, const BYTE*, DWORD, DWORD);
+extern void FmtVector(OUTBUF*, const BYTE*, DWORD, DWORD, const char*);
+extern void FmtLabel(OUTBUF*, const SYMENT*);
+
+// Input image (dasmfile.cpp)
+extern int  ImageOpen(IMAGE*, const char*);
+extern BOOL ImageWindow(IMAGE*, DWORD);
+extern BOOL ImageShare(IMAGE*, const IMAGE*);
+extern void ImageClose(IMAGE*);
+
+// Hex file loaders, sparse image (dasmhex.cpp)
+extern int  HexKind(const char*);
+extern int  HexLoad(IMAGE*, const char*, int);
+extern BOOL HexWindow(IMAGE*, DWORD);
+extern BYTE* HexFlat(IMAGE*);
+extern void HexFree(IMAGE*);
+
+// Batch mode (dasmbat.cpp)
+extern void PoolRun(int, int, POOLPROC, void*);
+extern void BatchAdd(BATCH*, const char*);
+extern int  BatchRun(BATCH*);
+
+// Parallel sweep (dasmpar.cpp)
+extern int  DasmImagePar(IMAGE*, OUTBUF*, const DASMOPT*);
+extern int  DasmVerify(const char*, const DASMOPT*);
+
+// Control flow guided disassembly (dasmflow.cpp)
+extern const char* FlowVector(int, int);
+extern BOOL FlowTrace(const BYTE*, DWORD, const DASMOPT*, BYTE*, BYTE*);
+extern int  DasmImageFlow(IMAGE*, OUTBUF*, const DASMOPT*);
+
+// Symbol table (dasmsym.cpp)
+extern void SymInit(SYMTAB*);
+extern void SymCopy(SYMTAB*, const SYMTAB*);
+extern void SymFree(SYMTAB*);
+extern SYMENT* SymAdd(SYMTAB*, DWORD);
+extern DWORD SymPool(SYMTAB*, const char*, int);
+extern void SymSort(SYMTAB*);
+extern SYMENT* SymFind(const SYMTAB*, DWORD);
+extern DWORD SymSeek(const SYMTAB*, DWORD);
+extern char* SymName(char*, const SYMTAB*, const SYMENT*);
+extern int  SymLoad(SYMTAB*, const char*);
+extern void SymScan(IMAGE*, SYMTAB*, const RUNTAB*);
+
+// Fill runs and ASCII strings (dasmrun.cpp)
+extern DWORD RunFill(const BYTE*, DWORD);
+extern DWORD RunText(const BYTE*, DWORD);
+extern void RunScan(IMAGE*, RUNTAB*);
+extern void RunFree(RUNTAB*);
+extern DWORD RunSeek(const RUNTAB*, DWORD);
+
+// Incremental listing cache (dasmcache.cpp)
+extern int  DasmImageCache(IMAGE*, OUTBUF*, const DASMOPT*);
+
+// Query server (dasmsrv.cpp)
+extern int  DasmServe(const char*, const DASMOPT*, FILE*, FILE*);
+
+// Streaming from stdin (dasmpipe.cpp)
+extern int  DasmStream(int, OUTBUF*, const DASMOPT*);
+
+// Instruction pattern search (dasmgrep.cpp)
+extern BOOL GrepAdd(GREP*, const char*);
+extern void GrepCompile(GREP*, int);
+extern int  GrepFile(const char*, OUTBUF*, const DASMOPT*);
+
+// M68HC05 simulator (dasmsim.cpp)
+extern BOOL SimMap(SIMMAP*, const char*);
+extern BOOL SimRun(const BYTE*, DWORD, const DASMOPT*, BYTE*, SIMSTATS*);
+
+// Direct page cross-reference (dasmxref.cpp)
+extern void XrefScan(IMAGE*, XREF*, const RUNTAB*);
+extern void XrefFlow(XREF*, const BYTE*, DWORD, const BYTE*, int);
+extern const DWORD* XrefFind(const XREF*, DWORD, int, DWORD*);
+extern int  XrefReport(OUTBUF*, const XREF*, const SYMTAB*);
+extern void XrefFree(XREF*);
+
+// Function fingerprints (dasmsig.cpp)
+extern int  SigOpen(SIGINDEX*, const char*);
+extern void SigClose(SIGINDEX*);
+extern const SIGENT* SigFind(const SIGINDEX*, unsigned long long, DWORD);
+extern void SigScan(IMAGE*, SYMTAB*, const RUNTAB*, const SIGINDEX*);
+extern void SigFlow(SYMTAB*, const BYTE*, DWORD, const BYTE*, int, const SIGINDEX*);
+extern int  SigBuild(const char*, const BATCH*, SIGINDEX*);
+
+// Instruction-aligned diff (dasmdiff.cpp)
+extern int  DasmDiff(const char*, const char*, OUTBUF*, const DASMOPT*);
+
+// Register maps of the derivatives (dasmreg.cpp)
+extern int  RegOpen(REGMAP*, const char*);
+extern void RegClose(REGMAP*);
+
+// Cycle budget (dasmcyc.cpp)
+extern int  CycReport(OUTBUF*, IMAGE*, const DASMOPT*);
+
+// Run statistics (dasmstat.cpp)
+extern long long StatClock(void);
+extern void StatInit(DASMSTATS*, int);
+extern void StatPhase(OUTBUF*, int);
+extern void StatAdd(DASMSTATS*, const DASMSTATS*);
+extern void StatReport(const DASMSTATS*, int);
+
+// Benchmark (dasmbench.cpp)
+extern int  DasmBench(const DASMOPT*);
+
+//-----------------------------end-of-extern.h-----------------------------------